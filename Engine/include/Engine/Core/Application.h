@@ -36,7 +36,7 @@ namespace Engine {
         ServiceLocator* GetServiceLocator();
         RHI::SwapChainHandle GetSwapChain();
 
-        void Init(const WindowProperties& properties);
+        void Init(const WindowProperties& properties, const RHI::GraphicsDeviceDesc& graphicsDeviceDesc = {});
         //void EventCallback(Event& event);
         void Run();
 
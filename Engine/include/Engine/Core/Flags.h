@@ -21,6 +21,8 @@ namespace Engine
         Flags operator&(const Flags& other) const { return Flags(value_ & other.value_); }
         Flags operator~() const { return Flags(~value_); }
 
+        bool operator==(const Flags& other) const = default;
+
         bool Has(T e) const { return (value_ & static_cast<underlying_type>(e)) != 0; }
         explicit operator bool() const { return value_ != 0; }
 
@@ -25,6 +25,10 @@
 #include "Engine/RHI/RHI.h"
 #include "Engine/RHI/IGraphicsDevice.h"
 #include "Engine/RHI/ICommandBuffer.h"
+#include "Engine/RHI/ICommandBundle.h"
+#include "Engine/RHI/RHIHash.h"
+#include "Engine/RHI/RenderGraph.h"
+#include "Engine/RHI/KTX2.h"
 
 /*
 #include "Engine/Renderer/RHI/IBuffer.h"
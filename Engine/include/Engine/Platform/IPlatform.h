@@ -29,7 +29,8 @@ namespace Engine
         
         const std::string& GetBasePath() const;
 
-        static Scope<IPlatform> Create();
+        // Headless platforms have no window system: windows are just a size and there are no events
+        static Scope<IPlatform> Create(bool headless = false);
     };
 } // namespace Engine
 
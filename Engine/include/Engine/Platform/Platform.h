@@ -4,7 +4,7 @@
 namespace Engine
 {
      // What platform is this created for?
-     enum class Platform { SDL };
+     enum class Platform { SDL, Headless };
 } // namespace Engine
 
 
@@ -9,6 +9,9 @@
 
 namespace Engine::RHI
 {
+    // Forward declaration
+    class ICommandBundle;
+
     class ENGINE_EXPORT ICommandBuffer
     {
     public:
@@ -20,13 +23,45 @@ namespace Engine::RHI
         virtual void BindIndexBuffer(BufferHandle buffer) = 0;
         virtual void BindUniformBuffer(BufferHandle buffer, uint32_t binding) = 0;
         virtual void BindTexture(TextureHandle texture, uint32_t binding) = 0;
+        virtual void PushConstants(ShaderStage stage, uint32_t offset, uint32_t size, const void* data) = 0; // Range must be declared in PipelineDesc::pushConstantRanges
+        virtual void BindStorageBuffer(BufferHandle buffer, uint32_t binding) = 0;
+        virtual void BindStorageTexture(TextureHandle texture, uint32_t binding) = 0;
         virtual void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) = 0;
         virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t indexOffset = 0, uint32_t firstInstance = 0) = 0;
+
+        // Indirect drawing. buffer is an Indirect or Storage buffer holding drawCount commands, stride bytes apart.
+        // The Count variants read the draw count as a uint32 from countBuffer, clamped to maxDrawCount. They
+        // require DeviceCapabilities::drawIndirectCount.
+        virtual void DrawIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride = sizeof(DrawIndirectCommand)) = 0;
+        virtual void DrawIndexedIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride = sizeof(DrawIndexedIndirectCommand)) = 0;
+        virtual void DrawIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride = sizeof(DrawIndirectCommand)) = 0;
+        virtual void DrawIndexedIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride = sizeof(DrawIndexedIndirectCommand)) = 0;
+
+        // Replays a recorded bundle. Only valid in a graphics pass. Bound pipeline and bindings are reset afterwards
+        virtual void ExecuteBundle(ICommandBundle* bundle) = 0;
+
+        // Debug markers. Nest inside a pass and are timed in GPU timings. Graphics debuggers show them as labels,
+        // as do validation builds. Markers in bundles are labels only.
+        virtual void BeginMarker(const char* name) = 0;
+        virtual void EndMarker() = 0;
+
+        // Compute. Only valid in a compute pass
+        virtual void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) = 0;
+        virtual void DispatchIndirect(BufferHandle buffer, size_t offset = 0) = 0; // Indirect or Storage buffer holding 3 x uint32 group counts
+        virtual void ComputeBarrier() = 0; // Makes storage writes of earlier dispatches in this pass visible to later ones
    
         // Data
         // offset is only used by static buffers and is ignored by dynamic buffers.
         virtual void UploadBuffer(BufferHandle buffer, void* data, size_t size, size_t offset) = 0;
+
+        // Write pointer to size bytes of a dynamic buffer's memory for this frame, used like UploadBuffer() without the
+        // copy. The memory is write-combined: write it sequentially, never read it, and finish before the pass ends.
+        virtual void* MapDynamic(BufferHandle buffer, size_t size) = 0;
+
+        // Uploads level 0 and generates the rest of the mip chain from it
         virtual void UploadTexture(TextureHandle texture, void* data) = 0;
+        // Uploads precomputed mips, one tightly packed level per entry starting at level 0
+        virtual void UploadTextureMips(TextureHandle texture, const std::vector<void*>& levels) = 0;
     };
 }
 
@@ -0,0 +1,33 @@
+#ifndef ENGINE_RHI_ICOMMANDBUNDLE
+#define ENGINE_RHI_ICOMMANDBUNDLE
+
+#include "engine_export.h"
+
+#include "Engine/RHI/RHI.h"
+
+namespace Engine::RHI
+{
+    // Forward declaration
+    class ICommandBuffer;
+
+    // A command bundle is recorded once and replayed with ICommandBuffer::ExecuteBundle() in any graphics pass that
+    // renders to the swapchain (and depth buffer) it was created for. Use it for content that doesn't change between
+    // frames. Bundles may only reference static buffers, can't upload, and set their own pipeline and bindings.
+    //
+    // Destroying a referenced resource or resizing the swapchain invalidates the bundle. Check IsValid() before
+    // executing and re-record when it returns false.
+    class ENGINE_EXPORT ICommandBundle
+    {
+    public:
+        virtual ~ICommandBundle() = default;
+
+        // Starts recording, discarding previous contents. Safe while earlier recordings are still in flight
+        virtual ICommandBuffer* Begin() = 0;
+        virtual void End() = 0;
+
+        // Recorded and nothing it references has changed since
+        virtual bool IsValid() const = 0;
+    };
+}
+
+#endif // ENGINE_RHI_ICOMMANDBUNDLE
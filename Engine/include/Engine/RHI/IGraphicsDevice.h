@@ -9,10 +9,13 @@
 
 #include "Engine/Math/Vector.h"
 
+#include <functional>
+
 namespace Engine::RHI
 {
     // Forward declaration
     class ICommandBuffer;
+    class ICommandBundle;
 
     // IGraphicsDevice represents the GPU itself. It handles resource creation and lifetime, memory management,
     // and frame pacing.
@@ -28,6 +31,24 @@ namespace Engine::RHI
         virtual PipelineHandle  CreatePipeline(const PipelineDesc& desc) = 0;
         virtual SwapChainHandle CreateSwapChain(const SwapChainDesc& desc) = 0;
 
+        // Background pipeline compilation. The handle is usable immediately; binding it before
+        // IsPipelineReady() returns true blocks until compilation finishes.
+        virtual PipelineHandle  CreatePipelineAsync(const PipelineDesc& desc) = 0;
+        virtual bool            IsPipelineReady(PipelineHandle pipeline) = 0;
+
+        // Compute pipelines are destroyed with DestroyPipeline()
+        virtual PipelineHandle  CreateComputePipeline(const ComputePipelineDesc& desc) = 0;
+
+        // Placed textures alias the memory of a heap at offset. Destroy them before the heap
+        virtual MemoryRequirements GetTextureMemoryRequirements(const TextureDesc& desc) = 0;
+        virtual HeapHandle         CreateHeap(const HeapDesc& desc) = 0;
+        virtual TextureHandle      CreatePlacedTexture(const TextureDesc& desc, HeapHandle heap, size_t offset) = 0;
+        virtual void               DestroyHeap(HeapHandle& heap) = 0;
+
+        // Command bundles are owned by the device and freed once the GPU is done with them
+        virtual ICommandBundle* CreateCommandBundle(const CommandBundleDesc& desc) = 0;
+        virtual void            DestroyCommandBundle(ICommandBundle*& bundle) = 0;
+
         // Resource destruction
         virtual void DestroyBuffer(BufferHandle& buffer) = 0;
         virtual void DestroyTexture(TextureHandle& texture) = 0;
@@ -35,6 +56,13 @@ namespace Engine::RHI
         virtual void DestroyPipeline(PipelineHandle& pipeline) = 0;
         virtual void DestroySwapChain(SwapChainHandle& swapchain) = 0;
 
+        // Static index buffer shared by batchers that draw quads of 4 vertices, indexed 0, 1, 2, 2, 3, 0 plus 4 per quad.
+        // Holds at least quadCount quads with 32-bit indices, quadCount is at most 2^23. Growing it replaces the buffer and
+        // invalidates bundles that reference it, so fetch it before each pass instead of keeping the handle. Owned by the
+        // device, never destroy it.
+        // Must not be called between BeginImmediate() and EndImmediate()
+        virtual BufferHandle GetQuadIndexBuffer(uint32_t quadCount) = 0;
+
         // TODO: IGraphicsDevice: EnqueueUploadBuffer, EnqueueUploadTexture, and FlushUploads
         // Enqueues uploads into an immediate command buffer.
 
@@ -42,11 +70,50 @@ namespace Engine::RHI
         virtual void BeginFrame() = 0;
         virtual void EndFrame() = 0;
 
-        // Render passes
+        // Low latency mode: blocks until the previously submitted frame has finished on the GPU.
+        // Call right before sampling input. Does nothing if GraphicsDeviceDesc::lowLatency is false.
+        virtual void WaitForFrameLatency() = 0;
+        virtual uint32_t GetFramesInFlight() const = 0;
+
+        // Device info
+        virtual const DeviceCapabilities& GetCapabilities() const = 0;
+        virtual bool IsFormatSupported(PixelFormat format, TextureUsageFlags usage) = 0;
+
+        // Timings of the latest frame the GPU has finished, read back without stalling. Frames in flight delay them by
+        // a few frames. Empty unless GraphicsDeviceDesc::gpuProfiling is set and DeviceCapabilities::timestampQueries
+        virtual const GpuFrameTimings& GetGpuTimings() const = 0;
+
+        // Commands recorded between the last BeginFrame() and EndFrame(), including immediate command buffers
+        virtual const CommandCounters& GetCommandCounters() const = 0;
+
+        // Memory. The callback is called from BeginFrame() when usage of a device-local heap crosses
+        // GraphicsDeviceDesc::memoryBudgetThreshold of its budget, and again only after it dropped back below
+        virtual MemoryStats GetMemoryStats() = 0;
+        virtual void        SetMemoryBudgetCallback(std::function<void(const MemoryStats&)> callback) = 0;
+
+        // Render passes. Passes execute in the order they are begun. Begin*Pass() and EndPass() are thread safe and a
+        // pass may be recorded and ended on any thread, so begin passes on one thread for a deterministic order, then hand
+        // them to workers. A pass's command buffer must only be used by one thread at a time. Resource creation and
+        // destruction must not overlap parallel recording, and all passes must be ended before EndFrame().
         // virtual ICommandBuffer* BeginPass(TextureHandle renderTarget, Vec4 clearColor) = 0;
         virtual ICommandBuffer* BeginPass(SwapChainHandle renderTarget, Vec4 clearColor, TextureHandle depthBuffer = {}) = 0;
+        virtual ICommandBuffer* BeginPass(const RenderPassDesc& desc) = 0; // Returns nullptr if a swapchain can't be rendered to
         virtual void EndPass(ICommandBuffer* cmd) = 0;
 
+        // Compute passes record Dispatch() outside of rendering and are ended with EndPass(). Storage writes made in a
+        // compute pass are visible to every pass that begins after it. barriers are recorded before the first dispatch.
+        virtual ICommandBuffer* BeginComputePass(const std::vector<TextureBarrier>& barriers = {}, const std::string& name = "") = 0;
+
+        // Readback. Records a copy into a host-visible buffer after every pass begun so far; passes writing the resource
+        // must have been ended. The ticket completes once the GPU has finished the frame, PollReadback() never waits.
+        // Texture rows are tightly packed. Swapchains must be offscreen and are read from this frame's image.
+        // Requests must be made between BeginFrame() and EndFrame() on the thread that begins passes.
+        virtual ReadbackTicket RequestReadback(TextureHandle texture, const TextureRegion& region = {}) = 0;
+        virtual ReadbackTicket RequestReadback(SwapChainHandle swapChain, const TextureRegion& region = {}) = 0;
+        virtual ReadbackTicket RequestReadback(BufferHandle buffer, const BufferRegion& region = {}) = 0;
+        virtual bool           PollReadback(ReadbackTicket& ticket, std::vector<char>& data) = 0; // true once data is filled, invalidates the ticket
+        virtual void           CancelReadback(ReadbackTicket& ticket) = 0;
+
         // Immediate command buffer
         virtual ICommandBuffer* BeginImmediate() = 0;
         virtual void EndImmediate(ICommandBuffer* cmd) = 0; // Blocks until GPU is finished with work
@@ -59,7 +126,7 @@ namespace Engine::RHI
         virtual void OnDestroy() = 0; // Called when application attempts to exit gracefully
 
         // Static factory creation
-        static Scope<IGraphicsDevice> Create(GraphicsAPI api);
+        static Scope<IGraphicsDevice> Create(GraphicsAPI api, const GraphicsDeviceDesc& desc = {});
     };
 } // namespace Engine::RHI
 
@@ -0,0 +1,31 @@
+#ifndef ENGINE_RHI_KTX2
+#define ENGINE_RHI_KTX2
+
+#include "engine_export.h"
+
+#include "Engine/RHI/RHI.h"
+
+#include <vector>
+
+namespace Engine::RHI
+{
+    // Forward declaration
+    class IGraphicsDevice;
+
+    // A 2D texture read from a KTX2 container
+    struct KTX2Texture {
+        TextureDesc                    desc;   // Sampled, default sampler. mipLevels = 0 if the file asks for generated mips
+        std::vector<std::vector<char>> levels; // Level 0 first, tightly packed like ICommandBuffer::UploadTextureMips() expects
+    };
+
+    // Reads a KTX2 file holding a 2D texture without supercompression. If the device can't sample the file's format,
+    // BC1-BC5 are decoded to RGBA8 (RGBA8Unorm for linear formats) on the CPU; other formats have no fallback.
+    // Logs and returns false on failure.
+    ENGINE_EXPORT bool LoadKTX2(IGraphicsDevice& device, const std::vector<char>& file, KTX2Texture& texture);
+
+    // Creates the texture and uploads every level in an immediate command buffer
+    ENGINE_EXPORT TextureHandle CreateTextureKTX2(IGraphicsDevice& device, const KTX2Texture& texture);
+} // namespace Engine::RHI
+
+
+#endif // ENGINE_RHI_KTX2
@@ -3,6 +3,8 @@
 
 #include "Engine/RHI/VertexLayout.h"
 
+#include "Engine/Math/Vector.h"
+
 #include "Engine/Core/Flags.h"
 #include "Engine/Core/Handle.h"
 #include <cstddef>
@@ -26,17 +28,29 @@ namespace Engine::RHI
     // Enums
     // ========================================================================
 
-    enum class GraphicsAPI       { Vulkan };
-    enum class BufferType        { Vertex, Index, Uniform };
+    enum class GraphicsAPI       { Vulkan, Null }; // Null records and validates but issues no GPU work
+    enum class BufferType        { Vertex, Index, Uniform, Storage, Indirect };
     enum class BufferUsage       { Static, Dynamic };
-    enum class PixelFormat       { RGBA8, Depth32, Depth24Stencil8 };
+    enum class IndexFormat       { Uint16, Uint32 };
+    // Block-compressed formats come after R32F and can only be sampled. Color formats are sRGB like RGBA8, the Unorm
+    // variants hold linear data. BC4 and BC5 are one and two channel linear formats.
+    enum class PixelFormat       {
+        RGBA8, Depth32, Depth24Stencil8, RGBA8Unorm, RGBA16F, RGBA32F, R32F,
+        BC1, BC1Unorm, BC3, BC3Unorm, BC4, BC5, BC7, BC7Unorm, ETC2RGB8, ETC2RGBA8, ASTC4x4
+    };
     enum class PresentMode       { Immediate, VSync, Mailbox };
-    enum class ShaderStage       { Vertex, Fragment };
-    enum class PrimitiveTopology { PointList, LineList, TriangleList };
+    enum class ShaderStage       { Vertex, Fragment, Compute };
+    enum class PrimitiveTopology { PointList, LineList, TriangleList, LineStrip, TriangleStrip };
     enum class PolygonMode       { Fill, Line, Point };
     enum class CullMode          { None, Back, Front };
     enum class FrontFace         { Clockwise, CounterClockwise };
-    enum class UniformType       { UniformBuffer, Texture };
+    enum class UniformType       { UniformBuffer, Texture, StorageBuffer, StorageTexture };
+    enum class LoadOp            { Load, Clear, DontCare };
+    enum class Filter            { Nearest, Linear };
+    enum class AddressMode       { Repeat, MirroredRepeat, ClampToEdge, ClampToBorder };
+
+    // How a pass uses a texture. TextureBarriers move textures between states
+    enum class ResourceState     { Undefined, RenderTarget, DepthWrite, DepthRead, ShaderRead, Storage };
 
     // ========================================================================
     // Flags
@@ -46,7 +60,8 @@ namespace Engine::RHI
         None         = 0,
         Sampled      = 1 << 0,
         RenderTarget = 1 << 1,
-        DepthStencil = 1 << 2
+        DepthStencil = 1 << 2,
+        Storage      = 1 << 3  // Read/write from compute shaders. RGBA8 (sRGB) is rarely supported, prefer RGBA8Unorm
     };
     using TextureUsageFlags = Flags<TextureUsage>;
 
@@ -58,6 +73,142 @@ namespace Engine::RHI
         uint32_t    binding;
         ShaderStage stage;
         UniformType type;
+
+        bool operator==(const UniformBinding& other) const = default;
+    };
+
+    // Bytes [offset, offset + size) of the push constant block visible to stage. Offset and size must be multiples of 4,
+    // and the whole block should fit in 128 bytes, the minimum every device supports.
+    struct PushConstantRange {
+        ShaderStage stage;
+        uint32_t    offset = 0;
+        uint32_t    size   = 0;
+
+        bool operator==(const PushConstantRange& other) const = default;
+    };
+
+    // Argument layouts read by DrawIndirect() and DrawIndexedIndirect()
+    struct DrawIndirectCommand {
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t firstVertex;
+        uint32_t firstInstance;
+    };
+
+    struct DrawIndexedIndirectCommand {
+        uint32_t indexCount;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t  vertexOffset;
+        uint32_t firstInstance;
+    };
+
+    // Optional features of the device
+    struct DeviceCapabilities {
+        bool multiDrawIndirect         = false; // drawCount > 1 in a single indirect call. Emulated with one call per draw otherwise
+        bool drawIndirectCount         = false; // Draw*IndirectCount()
+        bool timestampQueries          = false; // GPU timings (see GraphicsDeviceDesc::gpuProfiling)
+        bool pipelineStatisticsQueries = false; // Pipeline statistics in GPU timings
+        bool memoryBudget              = false; // Heap budgets come from the driver. Estimated from heap sizes otherwise
+        bool samplerAnisotropy         = false; // SamplerDesc::maxAnisotropy above 1
+        bool textureCompressionBC      = false; // BC* formats. Check individual formats with IGraphicsDevice::IsFormatSupported()
+        bool textureCompressionETC2    = false; // ETC2* formats
+        bool textureCompressionASTC    = false; // ASTC* formats
+    };
+
+    // ========================================================================
+    // Memory
+    // ========================================================================
+
+    // Budget is how much this process can use before the driver starts paging. Other processes count against it
+    struct MemoryHeapStats {
+        size_t budget      = 0;
+        size_t usage       = 0; // By this process
+        bool   deviceLocal = false;
+    };
+
+    // Category totals are the bytes allocated for the engine's resources and include alignment padding
+    struct MemoryStats {
+        std::vector<MemoryHeapStats> heaps;
+        size_t buffers        = 0; // Static buffers
+        size_t textures       = 0; // Textures and heaps for placed textures
+        size_t dynamicBuffers = 0; // Pages of every frame's dynamic buffer allocators
+        size_t staging        = 0; // Upload staging buffers waiting for their frame to finish
+    };
+
+    // ========================================================================
+    // Profiling
+    // ========================================================================
+
+    // Commands recorded in a frame, counted by every backend the same way (see IGraphicsDevice::GetCommandCounters)
+    struct CommandCounters {
+        uint32_t passes            = 0; // Graphics and compute
+        uint32_t draws             = 0; // Draw() and DrawIndexed()
+        uint32_t indirectDraws     = 0; // Indirect draw calls, not the draws they expand to
+        uint32_t dispatches        = 0;
+        uint32_t pipelineBinds     = 0;
+        uint32_t vertexBufferBinds = 0;
+        uint32_t indexBufferBinds  = 0;
+        uint32_t resourceBinds     = 0; // Uniform buffers, textures, storage buffers and storage textures
+        uint32_t descriptorBinds   = 0; // Bindings applied by draws and dispatches after they changed
+        uint32_t pushConstants     = 0;
+        uint32_t bundles           = 0; // ExecuteBundle() calls
+        uint32_t uploads           = 0; // UploadBuffer(), MapDynamic(), UploadTexture() and UploadTextureMips()
+        size_t   uploadBytes       = 0; // Level 0 only for generated mips
+        uint32_t readbacks         = 0;
+
+        // Binds that matched the state already bound and were dropped. Not part of the counts above
+        uint32_t filteredPipelineBinds     = 0;
+        uint32_t filteredVertexBufferBinds = 0;
+        uint32_t filteredIndexBufferBinds  = 0;
+        uint32_t filteredDescriptorBinds   = 0;
+
+        CommandCounters& operator+=(const CommandCounters& other) {
+            passes            += other.passes;
+            draws             += other.draws;
+            indirectDraws     += other.indirectDraws;
+            dispatches        += other.dispatches;
+            pipelineBinds     += other.pipelineBinds;
+            vertexBufferBinds += other.vertexBufferBinds;
+            indexBufferBinds  += other.indexBufferBinds;
+            resourceBinds     += other.resourceBinds;
+            descriptorBinds   += other.descriptorBinds;
+            pushConstants     += other.pushConstants;
+            bundles           += other.bundles;
+            uploads           += other.uploads;
+            uploadBytes       += other.uploadBytes;
+            readbacks         += other.readbacks;
+
+            filteredPipelineBinds     += other.filteredPipelineBinds;
+            filteredVertexBufferBinds += other.filteredVertexBufferBinds;
+            filteredIndexBufferBinds  += other.filteredIndexBufferBinds;
+            filteredDescriptorBinds   += other.filteredDescriptorBinds;
+            return *this;
+        }
+    };
+
+    // Counted for a whole pass
+    struct PipelineStatistics {
+        uint64_t inputAssemblyVertices     = 0;
+        uint64_t inputAssemblyPrimitives   = 0;
+        uint64_t vertexShaderInvocations   = 0;
+        uint64_t clippingPrimitives        = 0;
+        uint64_t fragmentShaderInvocations = 0;
+        uint64_t computeShaderInvocations  = 0;
+    };
+
+    // A pass, or a marker recorded with ICommandBuffer::BeginMarker(), and the markers recorded inside it
+    struct GpuTimingNode {
+        std::string                name;
+        double                     milliseconds = 0.0;
+        PipelineStatistics         statistics; // Passes only
+        std::vector<GpuTimingNode> children;
+    };
+
+    struct GpuFrameTimings {
+        uint64_t                   frame        = 0;   // Number of the frame the timings were recorded in
+        double                     milliseconds = 0.0; // Start of the first pass to the end of the last
+        std::vector<GpuTimingNode> passes;             // In submission order
     };
 
     // =========================================================================
@@ -69,28 +220,112 @@ namespace Engine::RHI
     struct ShaderTag {};
     struct PipelineTag {};
     struct SwapChainTag {};
+    struct HeapTag {};
+    struct ReadbackTag {};
 
     using BufferHandle    = Handle<BufferTag>;
     using TextureHandle   = Handle<TextureTag>;
     using ShaderHandle    = Handle<ShaderTag>;
     using PipelineHandle  = Handle<PipelineTag>;
     using SwapChainHandle = Handle<SwapChainTag>;
+    using HeapHandle      = Handle<HeapTag>;
+    using ReadbackTicket  = Handle<ReadbackTag>;
+
+    // ========================================================================
+    // Synchronization
+    // ========================================================================
+
+    // Contents written in the before state are visible in the after state. Undefined discards the contents.
+    struct TextureBarrier {
+        TextureHandle texture;
+        ResourceState before = ResourceState::Undefined;
+        ResourceState after  = ResourceState::ShaderRead;
+
+        bool operator==(const TextureBarrier& other) const = default;
+    };
+
+    // ========================================================================
+    // Readback
+    // ========================================================================
+
+    // Part of a texture level to read back. A width or height of 0 reaches to the edge of the level
+    struct TextureRegion {
+        uint32_t x        = 0;
+        uint32_t y        = 0;
+        uint32_t width    = 0;
+        uint32_t height   = 0;
+        uint32_t mipLevel = 0;
+    };
+
+    // A size of 0 reaches to the end of the buffer
+    struct BufferRegion {
+        size_t offset = 0;
+        size_t size   = 0;
+    };
+
+    // Memory a texture needs when placed in a heap. memoryTypeBits is opaque, heaps and textures must share a bit
+    struct MemoryRequirements {
+        size_t   size           = 0;
+        size_t   alignment      = 0;
+        uint32_t memoryTypeBits = 0;
+
+        bool operator==(const MemoryRequirements& other) const = default;
+    };
 
     // ========================================================================
     // Descs
     // ========================================================================
 
+    struct GraphicsDeviceDesc {
+        uint32_t framesInFlight = 3;     // 1-4. Lower values reduce latency, higher values improve throughput
+        bool     lowLatency     = false; // Wait for the previous frame before sampling input (see IGraphicsDevice::WaitForFrameLatency)
+
+        std::string pipelineCachePath = ""; // Pipeline cache file, loaded on creation and saved on OnDestroy(). Empty disables
+
+        std::string pipelineManifestPath   = ""; // Pipelines created this run, replayed in the background on next launch. Empty disables
+        uint32_t    pipelineCompileThreads = 0;  // Background pipeline compile threads. 0 picks from hardware concurrency
+
+        bool gpuProfiling       = false; // Time passes and markers on the GPU (see IGraphicsDevice::GetGpuTimings)
+        bool pipelineStatistics = false; // Also count pipeline statistics per pass. Needs gpuProfiling
+
+        float memoryBudgetThreshold = 0.9f; // Fraction of a heap's budget that fires the memory budget callback
+        bool  backgroundFrees       = false; // Free destroyed resources on a worker thread instead of in BeginFrame()
+
+        bool headless = false; // No window system. Only offscreen swapchains, works on GPU-less machines with a software driver
+    };
+
+    // Storage buffers must be static. Besides shader storage, they can be bound as vertex, index and indirect buffers,
+    // so compute output can be drawn directly. Indirect buffers hold Draw*IndirectCommands (and draw counts) written by the CPU.
     struct BufferDesc {
-        size_t      size  = 0;
-        BufferType  type  = BufferType::Vertex;
-        BufferUsage usage = BufferUsage::Static;
+        size_t      size        = 0;
+        BufferType  type        = BufferType::Vertex;
+        BufferUsage usage       = BufferUsage::Static;
+        IndexFormat indexFormat = IndexFormat::Uint16; // Used when bound with ICommandBuffer::BindIndexBuffer()
     };
 
+    // Samplers are shared between all textures with equal descs
+    struct SamplerDesc {
+        Filter      minFilter     = Filter::Linear;
+        Filter      magFilter     = Filter::Linear;
+        Filter      mipFilter     = Filter::Linear;
+        AddressMode addressU      = AddressMode::Repeat;
+        AddressMode addressV      = AddressMode::Repeat;
+        float       maxAnisotropy = 1.0f; // Clamped to the device limit. 1 disables
+
+        bool operator==(const SamplerDesc& other) const = default;
+    };
+
+    // Mipmapped textures can only be sampled. UploadTexture() generates the mip chain from level 0,
+    // UploadTextureMips() uploads precomputed levels. Block-compressed textures need precomputed levels.
     struct TextureDesc {
-        uint32_t          width  = 0;
-        uint32_t          height = 0;
-        PixelFormat       format = PixelFormat::RGBA8;
-        TextureUsageFlags usage  = TextureUsage::Sampled;
+        uint32_t          width     = 0;
+        uint32_t          height    = 0;
+        PixelFormat       format    = PixelFormat::RGBA8;
+        TextureUsageFlags usage     = TextureUsage::Sampled;
+        uint32_t          mipLevels = 1; // 0 makes a full chain down to 1x1
+        SamplerDesc       sampler;
+
+        bool operator==(const TextureDesc& other) const = default;
     };
 
     struct ShaderModule {
@@ -103,24 +338,78 @@ namespace Engine::RHI
     };
 
     struct PipelineDesc {
-        ShaderHandle                shader;
-        VertexLayout                vertexLayout;
-        std::vector<UniformBinding> uniformBindings;
-        std::vector<PixelFormat>    colorAttachmentFormats;
-        PrimitiveTopology           topology    = PrimitiveTopology::TriangleList;
-        PolygonMode                 polygonMode = PolygonMode::Fill;
-        CullMode                    cullMode    = CullMode::Back;
-        FrontFace                   frontFace   = FrontFace::Clockwise;
-        bool                        blending    = false;
-        bool                        depthTest   = false;
-        bool                        depthWrite  = true;
-        PixelFormat                 depthFormat = PixelFormat::Depth32;
+        ShaderHandle                   shader;
+        VertexLayout                   vertexLayout;
+        std::vector<UniformBinding>    uniformBindings;
+        std::vector<PushConstantRange> pushConstantRanges;
+        std::vector<PixelFormat>       colorAttachmentFormats;
+        PrimitiveTopology              topology    = PrimitiveTopology::TriangleList;
+        PolygonMode                    polygonMode = PolygonMode::Fill;
+        CullMode                       cullMode    = CullMode::Back;
+        FrontFace                      frontFace   = FrontFace::Clockwise;
+        bool                           blending    = false;
+        bool                           depthTest   = false;
+        bool                           depthWrite  = true;
+        PixelFormat                    depthFormat = PixelFormat::Depth32;
+        bool                           primitiveRestart = false; // Strip topologies only. An all ones index starts a new strip
+
+        bool operator==(const PipelineDesc& other) const = default;
+    };
+
+    struct ComputePipelineDesc {
+        ShaderHandle                   shader;
+        std::vector<UniformBinding>    uniformBindings;
+        std::vector<PushConstantRange> pushConstantRanges;
+
+        bool operator==(const ComputePipelineDesc& other) const = default;
+    };
+
+    // Target a command bundle is replayed into. Depth buffer is optional but must match the passes it is executed in
+    struct CommandBundleDesc {
+        SwapChainHandle swapChain;
+        TextureHandle   depthBuffer;
+    };
+
+    // Device-local memory that textures can be placed in. Textures whose lifetimes don't overlap may share it
+    struct HeapDesc {
+        size_t   size           = 0;
+        size_t   alignment      = 0;
+        uint32_t memoryTypeBits = ~0u;
+
+        bool operator==(const HeapDesc& other) const = default;
+    };
+
+    // Either texture or swapChain. A swapchain attachment renders to the acquired image, which is presented in EndFrame()
+    struct ColorAttachment {
+        TextureHandle   texture;
+        SwapChainHandle swapChain;
+        LoadOp          loadOp     = LoadOp::Clear;
+        Vec4            clearColor = Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    };
+
+    struct DepthAttachment {
+        TextureHandle texture; // Invalid for no depth
+        LoadOp        loadOp     = LoadOp::Clear;
+        float         clearDepth = 1.0f;
+    };
+
+    // Barriers are recorded as one batch before rendering begins. Attachments not moved by a barrier are transitioned
+    // from the layout they were last recorded in.
+    struct RenderPassDesc {
+        std::string                  name; // Shown in GPU timings and graphics debuggers
+        std::vector<ColorAttachment> colorAttachments;
+        DepthAttachment              depthAttachment;
+        std::vector<TextureBarrier>  barriers;
     };
 
+    // Without a window the swapchain is offscreen: it renders to one owned image per frame in flight that EndFrame()
+    // doesn't present. Headless devices only support these.
     struct SwapChainDesc {
-        Engine::IWindow* window;
+        Engine::IWindow* window       = nullptr;
         PresentMode      presentation = PresentMode::VSync;
         PixelFormat      format       = PixelFormat::RGBA8;
+        uint32_t         width        = 0; // Offscreen only, windows provide their own size
+        uint32_t         height       = 0;
     };
 } // namespace Engine::RHI
 
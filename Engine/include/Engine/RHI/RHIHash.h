@@ -0,0 +1,56 @@
+#ifndef ENGINE_RHI_RHIHASH
+#define ENGINE_RHI_RHIHASH
+
+#include "engine_export.h"
+
+#include "Engine/RHI/RHI.h"
+#include "Engine/RHI/VertexLayout.h"
+
+#include <cstddef>
+#include <vector>
+
+// Structural hashing of RHI descriptions. Two descs that compare equal always hash equal,
+// so these can be used to deduplicate GPU objects built from identical descs.
+
+namespace Engine::RHI
+{
+    ENGINE_EXPORT size_t HashVertexLayout(const VertexLayout& layout);
+    ENGINE_EXPORT size_t HashUniformBindings(const std::vector<UniformBinding>& bindings);
+    ENGINE_EXPORT size_t HashPushConstantRanges(const std::vector<PushConstantRange>& ranges);
+    ENGINE_EXPORT size_t HashPipelineDesc(const PipelineDesc& desc);
+    ENGINE_EXPORT size_t HashComputePipelineDesc(const ComputePipelineDesc& desc);
+    ENGINE_EXPORT size_t HashSamplerDesc(const SamplerDesc& desc);
+} // namespace Engine::RHI
+
+// For use in unordered_map
+namespace std {
+    template<>
+    struct hash<Engine::RHI::VertexLayout> {
+        std::size_t operator()(const Engine::RHI::VertexLayout& layout) const noexcept {
+            return Engine::RHI::HashVertexLayout(layout);
+        }
+    };
+
+    template<>
+    struct hash<Engine::RHI::PipelineDesc> {
+        std::size_t operator()(const Engine::RHI::PipelineDesc& desc) const noexcept {
+            return Engine::RHI::HashPipelineDesc(desc);
+        }
+    };
+
+    template<>
+    struct hash<Engine::RHI::ComputePipelineDesc> {
+        std::size_t operator()(const Engine::RHI::ComputePipelineDesc& desc) const noexcept {
+            return Engine::RHI::HashComputePipelineDesc(desc);
+        }
+    };
+
+    template<>
+    struct hash<Engine::RHI::SamplerDesc> {
+        std::size_t operator()(const Engine::RHI::SamplerDesc& desc) const noexcept {
+            return Engine::RHI::HashSamplerDesc(desc);
+        }
+    };
+}
+
+#endif // ENGINE_RHI_RHIHASH
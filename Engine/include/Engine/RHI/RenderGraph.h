@@ -0,0 +1,203 @@
+#ifndef ENGINE_RHI_RENDERGRAPH
+#define ENGINE_RHI_RENDERGRAPH
+
+#include "engine_export.h"
+
+#include "Engine/RHI/RHI.h"
+
+#include "Engine/Math/Vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Engine::RHI
+{
+    // Forward declaration
+    class IGraphicsDevice;
+    class ICommandBuffer;
+    class RenderGraph;
+
+    // Graph resources. Only valid in the frame they were created or imported in
+    struct RenderGraphTextureTag {};
+    struct RenderGraphBufferTag {};
+
+    using RenderGraphTexture = Handle<RenderGraphTextureTag>;
+    using RenderGraphBuffer  = Handle<RenderGraphBufferTag>;
+
+    enum class RenderGraphPassType { Graphics, Compute };
+
+    struct RenderGraphStats {
+        uint32_t passes          = 0; // Passes executed
+        uint32_t culledPasses    = 0; // Passes whose outputs were never used
+        uint32_t barriers        = 0; // Texture barriers recorded
+        size_t   transientMemory = 0; // Heap memory backing transient textures
+        size_t   unaliasedMemory = 0; // Memory transient textures would need without aliasing
+    };
+
+    // Declares what a pass reads and writes. Only valid inside the setup callback
+    class ENGINE_EXPORT RenderGraphBuilder
+    {
+    private:
+        friend class RenderGraph;
+
+        RenderGraph& m_Graph;
+        uint32_t     m_Pass;
+
+        RenderGraphBuilder(RenderGraph& graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+    public:
+        // Attachments. Graphics passes only. Clear and DontCare discard the previous contents
+        void WriteColor(RenderGraphTexture texture, LoadOp loadOp = LoadOp::Clear, Vec4 clearColor = Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        void WriteDepth(RenderGraphTexture texture, LoadOp loadOp = LoadOp::Clear, float clearDepth = 1.0f);
+
+        // Shader access
+        void ReadTexture(RenderGraphTexture texture);    // Sampled
+        void ReadWriteTexture(RenderGraphTexture texture); // Storage texture
+
+        // Buffers only order and keep passes alive. Compute passes already make their storage writes visible.
+        // Buffers are imported, so a pass that writes one is never culled
+        void ReadBuffer(RenderGraphBuffer buffer);
+        void WriteBuffer(RenderGraphBuffer buffer);
+
+        // Never cull this pass, e.g. it writes something the graph doesn't know about
+        void SideEffect();
+    };
+
+    // Resolves graph resources to device resources while a pass executes
+    class ENGINE_EXPORT RenderGraphResources
+    {
+    private:
+        friend class RenderGraph;
+
+        const RenderGraph& m_Graph;
+
+        RenderGraphResources(const RenderGraph& graph) : m_Graph(graph) {}
+
+    public:
+        TextureHandle GetTexture(RenderGraphTexture texture) const;
+        BufferHandle  GetBuffer(RenderGraphBuffer buffer) const;
+    };
+
+    // Frame graph over the RHI. Every frame, create or import resources, add passes, then Compile() and Execute().
+    // Compile() culls passes nothing depends on, plans the barriers between passes and places transient textures whose
+    // lifetimes don't overlap in the same memory. Passes run in the order they were added, so a pass only depends on
+    // passes added before it. Transient memory is kept while the graph stays the same from frame to frame.
+    class ENGINE_EXPORT RenderGraph
+    {
+    public:
+        using SetupCallback   = std::function<void(RenderGraphBuilder&)>;
+        using ExecuteCallback = std::function<void(ICommandBuffer&, const RenderGraphResources&)>;
+
+        RenderGraph(IGraphicsDevice& device);
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        // Resources. Usage flags of transient textures are added from how passes use them.
+        // initialState is only used the first time a texture is imported, afterwards the graph remembers its state.
+        RenderGraphTexture CreateTexture(const std::string& name, const TextureDesc& desc);
+        RenderGraphTexture ImportTexture(const std::string& name, TextureHandle texture, ResourceState initialState = ResourceState::ShaderRead);
+        RenderGraphTexture ImportSwapChain(const std::string& name, SwapChainHandle swapChain);
+        RenderGraphBuffer  ImportBuffer(const std::string& name, BufferHandle buffer);
+
+        // setup runs immediately, execute runs in Execute() unless the pass is culled
+        void AddPass(const std::string& name, RenderGraphPassType type, const SetupCallback& setup, ExecuteCallback execute);
+
+        void Compile();
+        void Execute(); // Records every pass, then clears the passes and resources for the next frame
+
+        // Forgets the state of an imported texture, call before destroying it
+        void ForgetTexture(TextureHandle texture) { m_ImportedStates.erase(texture.id); }
+
+        const RenderGraphStats& GetStats() const { return m_Stats; }
+
+    private:
+        friend class RenderGraphBuilder;
+        friend class RenderGraphResources;
+
+        enum class ResourceKind { Transient, Imported, SwapChain };
+
+        struct TextureResource {
+            std::string     name;
+            ResourceKind    kind;
+            TextureDesc     desc;       // Transient only
+            TextureHandle   texture;    // Imported, or transient once realized
+            SwapChainHandle swapChain;
+            ResourceState   state = ResourceState::Undefined; // Imported state at the start of the frame
+        };
+
+        struct BufferResource {
+            std::string  name;
+            ResourceKind kind;
+            BufferHandle buffer;
+        };
+
+        struct TextureUse {
+            uint32_t      texture;
+            ResourceState state;
+            bool          write;
+            bool          discard = false; // Previous contents are not needed
+        };
+
+        struct Pass {
+            std::string         name;
+            RenderGraphPassType type;
+            ExecuteCallback     execute;
+            bool                sideEffect = false;
+
+            std::vector<TextureUse> textures;
+            std::vector<uint32_t>   bufferReads;
+            std::vector<uint32_t>   bufferWrites;
+
+            std::vector<ColorAttachment> colorAttachments; // Textures resolved in Execute()
+            std::vector<uint32_t>        colorTextures;
+            DepthAttachment              depthAttachment;
+            uint32_t                     depthTexture = ~0u;
+
+            // Compiled
+            bool                        culled = true;
+            std::vector<TextureBarrier> barriers;
+        };
+
+        // Transient memory. Slots are heaps that textures with disjoint lifetimes share
+        struct MemoryPlan {
+            std::vector<HeapDesc>    heaps;
+            std::vector<TextureDesc> textures;    // Transient textures in creation order
+            std::vector<uint32_t>    textureHeap; // Heap of each texture
+
+            bool operator==(const MemoryPlan& other) const = default;
+        };
+
+        IGraphicsDevice& m_Device;
+
+        std::vector<TextureResource> m_Textures;
+        std::vector<BufferResource>  m_Buffers;
+        std::vector<Pass>            m_Passes;
+        bool                         m_Compiled = false;
+
+        // Persistent across frames
+        std::unordered_map<uint32_t, ResourceState> m_ImportedStates; // By TextureHandle id
+        std::vector<std::pair<TextureDesc, MemoryRequirements>> m_RequirementsCache;
+        MemoryPlan                 m_Plan;
+        std::vector<HeapHandle>    m_Heaps;
+        std::vector<TextureHandle> m_PlacedTextures;
+
+        RenderGraphStats m_Stats;
+
+        TextureResource& GetTextureResource(RenderGraphTexture texture);
+        void AddTextureUse(uint32_t pass, RenderGraphTexture texture, ResourceState state, bool write, bool discard);
+
+        void Cull();
+        void PlanBarriers();
+        void PlanMemory();
+        void ReleaseMemory();
+        const MemoryRequirements& GetMemoryRequirements(const TextureDesc& desc);
+    };
+} // namespace Engine::RHI
+
+#endif // ENGINE_RHI_RENDERGRAPH
@@ -31,6 +31,11 @@ namespace Engine::RHI {
         uint32_t GetSize() const { return m_Size; }
         uint32_t GetOffset() const { return m_Offset; }
         bool IsNormalized() const { return m_Normalized; }
+
+        // Structural comparison: names are informational and don't affect the layout
+        bool operator==(const VertexElement& other) const {
+            return m_Type == other.m_Type && m_Size == other.m_Size && m_Offset == other.m_Offset && m_Normalized == other.m_Normalized;
+        }
     };
 
 
@@ -39,12 +44,17 @@ namespace Engine::RHI {
     private:
         std::vector<VertexElement> m_Elements;
         uint32_t m_Stride = 0;
+
+        void CalculateOffsets();
     
     public:
         VertexLayout(std::initializer_list<VertexElement> elements = {});
+        VertexLayout(const std::vector<VertexElement>& elements);
 
         uint32_t GetStride() const { return m_Stride; }
         const std::vector<VertexElement>& GetElements() const { return m_Elements; }
+
+        bool operator==(const VertexLayout& other) const = default;
     };
 } // namespace Engine::RHI
 
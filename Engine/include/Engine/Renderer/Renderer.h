@@ -20,12 +20,20 @@ namespace Engine
     private:
         // Sprite rendering data
         RHI::BufferHandle m_SpriteVertices;
-        RHI::BufferHandle m_SpriteIndices;
         RHI::BufferHandle m_SpriteUniform;
         RHI::ShaderHandle m_SpriteShader;
         RHI::PipelineHandle m_SpritePipeline;
         RHI::TextureHandle m_DepthBuffer;
 
+        // Render targets are sized in steps, so resizing a window only recreates them when a step is crossed.
+        // Resize events are coalesced and applied in Begin()
+        uint32_t m_TargetWidth  = 0;
+        uint32_t m_TargetHeight = 0;
+        uint32_t m_DepthWidth   = 0;
+        uint32_t m_DepthHeight  = 0;
+
+        void ResizeRenderTargets();
+
         // RHI
         RHI::ICommandBuffer* m_CurrentCommandBuffer = nullptr;
 
@@ -27,11 +27,6 @@ namespace Engine {
 
         m_Locator = CreateScope<ServiceLocator>();
 
-        // Initialize platform
-        m_Platform = IPlatform::Create();
-        ENGINE_CORE_ASSERT(m_Platform, "Platform is null!");
-        m_Locator->Register<IPlatform>(m_Platform.get());
-        
         // Set event callback
         //m_Platform->SetEventCallback(std::bind(&Engine::Application::EventCallback, this, std::placeholders::_1));
     }
@@ -42,12 +37,18 @@ namespace Engine {
 
     RHI::SwapChainHandle Application::GetSwapChain() { return m_SwapChain; }
 
-    void Application::Init(const WindowProperties& properties) {
+    void Application::Init(const WindowProperties& properties, const RHI::GraphicsDeviceDesc& graphicsDeviceDesc) {
         
         // Initialize logger
         Log::Init();
         LOG_CORE_INFO("Engine version Rocketbox2D_In_Development");
 
+        // Initialize platform. Headless and Null devices don't need a window system, so they run without a display
+        bool headless = graphicsDeviceDesc.headless || properties.api == RHI::GraphicsAPI::Null;
+        m_Platform = IPlatform::Create(headless);
+        ENGINE_CORE_ASSERT(m_Platform, "Platform is null!");
+        m_Locator->Register<IPlatform>(m_Platform.get());
+
         // Create window
         LOG_CORE_INFO("Creating window...");
         m_Window = std::move(m_Platform->CreateWindow(properties));
@@ -60,14 +61,25 @@ namespace Engine {
 
         // Create graphics device
         LOG_CORE_INFO("Initializing graphics device...");
-        m_GraphicsDevice = RHI::IGraphicsDevice::Create(m_Window->GetAPI());
+        RHI::GraphicsDeviceDesc gdDesc = graphicsDeviceDesc;
+        if(gdDesc.pipelineCachePath.empty())
+        {
+            gdDesc.pipelineCachePath = m_FileSystem->GetAbsolutePath("./pipeline_cache.bin");
+        }
+        if(gdDesc.pipelineManifestPath.empty())
+        {
+            gdDesc.pipelineManifestPath = m_FileSystem->GetAbsolutePath("./pipeline_manifest.bin");
+        }
+        m_GraphicsDevice = RHI::IGraphicsDevice::Create(m_Window->GetAPI(), gdDesc);
         m_Locator->Register<RHI::IGraphicsDevice>(m_GraphicsDevice.get());
 
-        // Create swapchain
+        // Create swapchain. Without a window system it renders offscreen at the window's size
         RHI::SwapChainDesc scdesc{
-            .window = m_Window.get(),
+            .window = headless ? nullptr : m_Window.get(),
             .presentation = RHI::PresentMode::VSync,
-            .format = RHI::PixelFormat::RGBA8
+            .format = RHI::PixelFormat::RGBA8,
+            .width = properties.width,
+            .height = properties.height
         };
         m_SwapChain = m_GraphicsDevice->CreateSwapChain(scdesc);
 
@@ -133,6 +145,8 @@ namespace Engine {
             float timeNow = m_Timer.GetTime();
             float dt = timeNow - timePrev;
 
+            m_GraphicsDevice->WaitForFrameLatency(); // Low latency mode: wait for previous frame before sampling input
+
             m_Platform->PollEvents(); // Process input events
 
             m_EventManager->FlushEvents();
@@ -0,0 +1,19 @@
+#include "Platform/Headless/HeadlessPlatform.h"
+#include "Platform/Headless/HeadlessWindow.h"
+
+#include <filesystem>
+
+namespace Engine
+{
+    HeadlessPlatform::HeadlessPlatform()
+    {
+        // The working directory stands in for the executable's directory. Ends in a separator like SDL_GetBasePath()
+        std::filesystem::path basePath = std::filesystem::current_path() / "";
+        m_BasePath = basePath.string();
+    }
+
+    Scope<IWindow> HeadlessPlatform::CreateWindow(const WindowProperties& properties)
+    {
+        return CreateScope<HeadlessWindow>(properties);
+    }
+} // namespace Engine
@@ -0,0 +1,24 @@
+#ifndef PLATFORM_HEADLESS_HEADLESSPLATFORM
+#define PLATFORM_HEADLESS_HEADLESSPLATFORM
+
+#include "engine_export.h"
+
+#include "Engine/Platform/IPlatform.h"
+
+namespace Engine
+{
+    // No window system and no input. For servers, tests and tools running without a display
+    class ENGINE_EXPORT HeadlessPlatform : public IPlatform {
+    public:
+        HeadlessPlatform();
+        ~HeadlessPlatform() override = default;
+
+        void PollEvents() override {} // Nothing to poll, quit through the event manager
+
+        // Resource creation
+        Scope<IWindow> CreateWindow(const WindowProperties& properties) override;
+    };
+} // namespace Engine
+
+
+#endif // PLATFORM_HEADLESS_HEADLESSPLATFORM
@@ -0,0 +1,27 @@
+#ifndef PLATFORM_HEADLESS_HEADLESSWINDOW
+#define PLATFORM_HEADLESS_HEADLESSWINDOW
+
+#include "engine_export.h"
+
+#include "Engine/Platform/IWindow.h"
+
+namespace Engine
+{
+    // Has the requested size and nothing else. Render to it through an offscreen swapchain
+    class ENGINE_EXPORT HeadlessWindow : public IWindow {
+    public:
+        HeadlessWindow(const WindowProperties& properties)
+            : IWindow(Platform::Headless, properties.api), m_Width(properties.width), m_Height(properties.height) {}
+        ~HeadlessWindow() override = default;
+
+        unsigned int GetWidth() override { return m_Width; }
+        unsigned int GetHeight() override { return m_Height; }
+
+    private:
+        unsigned int m_Width;
+        unsigned int m_Height;
+    };
+} // namespace Engine
+
+
+#endif // PLATFORM_HEADLESS_HEADLESSWINDOW
@@ -1,5 +1,6 @@
 #include "Engine/Platform/IPlatform.h"
 #include "Platform/SDL3/SDL3Platform.h"
+#include "Platform/Headless/HeadlessPlatform.h"
 
 namespace Engine
 {
@@ -13,7 +14,10 @@ namespace Engine
         return m_BasePath;
     }
 
-    Scope<IPlatform> IPlatform::Create() {
+    Scope<IPlatform> IPlatform::Create(bool headless) {
+        if (headless)
+            return CreateScope<HeadlessPlatform>();
+
         #if defined(ENGINE_PLATFORM_WINDOWS) || defined(ENGINE_PLATFORM_LINUX)
             return CreateScope<SDL3Platform>();
         #endif
@@ -13,6 +13,7 @@ namespace Engine
         
         switch(props.api) {
             case RHI::GraphicsAPI::Vulkan: flags |= SDL_WINDOW_VULKAN; break;
+            case RHI::GraphicsAPI::Null:   break; // Never presents
         }
 
         m_Window = SDL_CreateWindow(props.title.c_str(), props.width, props.height, flags);
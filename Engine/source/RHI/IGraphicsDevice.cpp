@@ -2,22 +2,30 @@
 #include "Engine/Platform/IGraphicsBridge.h"
 
 #include "RHI/Vulkan/RHI/VulkanGraphicsDevice.h"
+#include "RHI/Null/NullGraphicsDevice.h"
 #include "Platform/SDL3/Vulkan/SDL3VulkanGraphicsBridge.h"
 
 namespace Engine::RHI
 {
     // Static function to create GraphicsDevice with selected graphics api
-    Scope<IGraphicsDevice> IGraphicsDevice::Create(GraphicsAPI api) {
+    Scope<IGraphicsDevice> IGraphicsDevice::Create(GraphicsAPI api, const GraphicsDeviceDesc& desc) {
         switch (api) {
             case GraphicsAPI::Vulkan: {
 
+                // Headless devices never touch the window system
                 Scope<Vulkan::IVulkanGraphicsBridge> bridge;
                 
                 #if defined(ENGINE_PLATFORM_WINDOWS) | defined(ENGINE_PLATFORM_LINUX)
-                bridge = CreateScope<Vulkan::SDL3::SDL3VulkanGraphicsBridge>();
+                if (!desc.headless)
+                    bridge = CreateScope<Vulkan::SDL3::SDL3VulkanGraphicsBridge>();
                 #endif
 
-                return CreateScope<Vulkan::VulkanGraphicsDevice>(std::move(bridge));
+                return CreateScope<Vulkan::VulkanGraphicsDevice>(std::move(bridge), desc);
+                break;
+            }
+
+            case GraphicsAPI::Null: {
+                return CreateScope<Null::NullGraphicsDevice>(desc);
                 break;
             }
         }
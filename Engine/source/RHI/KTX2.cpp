@@ -0,0 +1,350 @@
+#include "Engine/RHI/KTX2.h"
+#include "Engine/RHI/IGraphicsDevice.h"
+#include "Engine/RHI/ICommandBuffer.h"
+#include "Engine/Core/Log.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+namespace Engine::RHI
+{
+    static constexpr uint8_t k_KTX2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    // Header and index that follow the identifier, up to the supercompression data index which isn't needed
+    struct KTX2Header {
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+    };
+    static_assert(sizeof(KTX2Header) == 52);
+
+    // Identifier, header and the 16 byte supercompression data index
+    static constexpr size_t k_KTX2LevelIndexOffset = 80;
+
+    struct KTX2LevelIndex {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    // VkFormat values as stored in the file
+    static bool GetPixelFormat(uint32_t vkFormat, PixelFormat& format)
+    {
+        switch (vkFormat)
+        {
+            case 37:  format = PixelFormat::RGBA8Unorm; return true; // R8G8B8A8_UNORM
+            case 43:  format = PixelFormat::RGBA8;      return true; // R8G8B8A8_SRGB
+            case 97:  format = PixelFormat::RGBA16F;    return true; // R16G16B16A16_SFLOAT
+            case 100: format = PixelFormat::R32F;       return true; // R32_SFLOAT
+            case 109: format = PixelFormat::RGBA32F;    return true; // R32G32B32A32_SFLOAT
+            case 131: format = PixelFormat::BC1Unorm;   return true; // BC1_RGB_UNORM_BLOCK
+            case 132: format = PixelFormat::BC1;        return true; // BC1_RGB_SRGB_BLOCK
+            case 133: format = PixelFormat::BC1Unorm;   return true; // BC1_RGBA_UNORM_BLOCK
+            case 134: format = PixelFormat::BC1;        return true; // BC1_RGBA_SRGB_BLOCK
+            case 137: format = PixelFormat::BC3Unorm;   return true; // BC3_UNORM_BLOCK
+            case 138: format = PixelFormat::BC3;        return true; // BC3_SRGB_BLOCK
+            case 139: format = PixelFormat::BC4;        return true; // BC4_UNORM_BLOCK
+            case 141: format = PixelFormat::BC5;        return true; // BC5_UNORM_BLOCK
+            case 145: format = PixelFormat::BC7Unorm;   return true; // BC7_UNORM_BLOCK
+            case 146: format = PixelFormat::BC7;        return true; // BC7_SRGB_BLOCK
+            case 148: format = PixelFormat::ETC2RGB8;   return true; // ETC2_R8G8B8_SRGB_BLOCK
+            case 152: format = PixelFormat::ETC2RGBA8;  return true; // ETC2_R8G8B8A8_SRGB_BLOCK
+            case 158: format = PixelFormat::ASTC4x4;    return true; // ASTC_4x4_SRGB_BLOCK
+        }
+        return false;
+    }
+
+    // Block extent and bytes per block. Uncompressed formats have 1x1 blocks
+    static void GetBlockInfo(PixelFormat format, uint32_t& extent, uint32_t& bytes)
+    {
+        extent = 4;
+        switch (format)
+        {
+            case PixelFormat::RGBA8:      extent = 1; bytes = 4; break;
+            case PixelFormat::RGBA8Unorm: extent = 1; bytes = 4; break;
+            case PixelFormat::RGBA16F:    extent = 1; bytes = 8; break;
+            case PixelFormat::RGBA32F:    extent = 1; bytes = 16; break;
+            case PixelFormat::R32F:       extent = 1; bytes = 4; break;
+            case PixelFormat::BC1:
+            case PixelFormat::BC1Unorm:
+            case PixelFormat::BC4:
+            case PixelFormat::ETC2RGB8:   bytes = 8; break;
+            default:                      bytes = 16; break;
+        }
+    }
+
+    static size_t GetLevelSize(PixelFormat format, uint32_t width, uint32_t height)
+    {
+        uint32_t extent, bytes;
+        GetBlockInfo(format, extent, bytes);
+        return static_cast<size_t>((width + extent - 1) / extent) * ((height + extent - 1) / extent) * bytes;
+    }
+
+    // ========================================================================
+    // BC1-BC5 decoding, used when the device can't sample them
+    // ========================================================================
+
+    static void Expand565(uint16_t color, uint8_t* rgba)
+    {
+        uint8_t r = (color >> 11) & 31;
+        uint8_t g = (color >> 5) & 63;
+        uint8_t b = color & 31;
+        rgba[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        rgba[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        rgba[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        rgba[3] = 255;
+    }
+
+    // BC1 color. BC3 color blocks always use four colors
+    static void DecodeColorBlock(const uint8_t* block, uint8_t (*pixels)[4], bool threeColorMode)
+    {
+        uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+        uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+
+        uint8_t palette[4][4];
+        Expand565(c0, palette[0]);
+        Expand565(c1, palette[1]);
+        for (int c = 0; c < 3; c++)
+        {
+            if (c0 > c1 || !threeColorMode)
+            {
+                palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+                palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+            }
+            else
+            {
+                palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+                palette[3][c] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = (c0 > c1 || !threeColorMode) ? 255 : 0;
+
+        uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+        for (int i = 0; i < 16; i++)
+            std::memcpy(pixels[i], palette[(indices >> (2 * i)) & 3], 4);
+    }
+
+    // BC4 and the alpha of BC3. Writes to one channel of pixels
+    static void DecodeChannelBlock(const uint8_t* block, uint8_t (*pixels)[4], int channel)
+    {
+        uint8_t palette[8];
+        palette[0] = block[0];
+        palette[1] = block[1];
+        if (palette[0] > palette[1])
+        {
+            for (int i = 1; i < 7; i++)
+                palette[i + 1] = static_cast<uint8_t>(((7 - i) * palette[0] + i * palette[1]) / 7);
+        }
+        else
+        {
+            for (int i = 1; i < 5; i++)
+                palette[i + 1] = static_cast<uint8_t>(((5 - i) * palette[0] + i * palette[1]) / 5);
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        for (int i = 0; i < 6; i++)
+            indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+        for (int i = 0; i < 16; i++)
+            pixels[i][channel] = palette[(indices >> (3 * i)) & 7];
+    }
+
+    static std::vector<char> DecodeBC(PixelFormat format, const char* data, uint32_t width, uint32_t height)
+    {
+        std::vector<char> decoded(static_cast<size_t>(width) * height * 4);
+        const uint8_t* block = reinterpret_cast<const uint8_t*>(data);
+
+        for (uint32_t by = 0; by < height; by += 4)
+        {
+            for (uint32_t bx = 0; bx < width; bx += 4)
+            {
+                // Sampling BC4/BC5 returns 0 for missing color channels and 1 for alpha
+                uint8_t pixels[16][4] = {};
+                for (auto& pixel : pixels)
+                    pixel[3] = 255;
+
+                switch (format)
+                {
+                    case PixelFormat::BC1:
+                    case PixelFormat::BC1Unorm:
+                        DecodeColorBlock(block, pixels, true);
+                        block += 8;
+                        break;
+                    case PixelFormat::BC3:
+                    case PixelFormat::BC3Unorm:
+                        DecodeColorBlock(block + 8, pixels, false);
+                        DecodeChannelBlock(block, pixels, 3);
+                        block += 16;
+                        break;
+                    case PixelFormat::BC4:
+                        DecodeChannelBlock(block, pixels, 0);
+                        block += 8;
+                        break;
+                    case PixelFormat::BC5:
+                        DecodeChannelBlock(block, pixels, 0);
+                        DecodeChannelBlock(block + 8, pixels, 1);
+                        block += 16;
+                        break;
+                    default:
+                        break;
+                }
+
+                // Blocks overhang the edges of levels that aren't a multiple of 4
+                for (uint32_t y = 0; y < 4 && by + y < height; y++)
+                {
+                    for (uint32_t x = 0; x < 4 && bx + x < width; x++)
+                    {
+                        size_t offset = ((static_cast<size_t>(by + y) * width) + bx + x) * 4;
+                        std::memcpy(&decoded[offset], pixels[y * 4 + x], 4);
+                    }
+                }
+            }
+        }
+
+        return decoded;
+    }
+
+    // ========================================================================
+    // Loading
+    // ========================================================================
+
+    bool LoadKTX2(IGraphicsDevice& device, const std::vector<char>& file, KTX2Texture& texture)
+    {
+        // Identifier, header, then one level index entry per level
+        if (file.size() < k_KTX2LevelIndexOffset ||
+            std::memcmp(file.data(), k_KTX2Identifier, sizeof(k_KTX2Identifier)) != 0)
+        {
+            LOG_CORE_ERROR("KTX2: Not a KTX2 file!");
+            return false;
+        }
+
+        KTX2Header header;
+        std::memcpy(&header, file.data() + sizeof(k_KTX2Identifier), sizeof(KTX2Header));
+
+        if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount != 0 || header.faceCount != 1)
+        {
+            LOG_CORE_ERROR("KTX2: Only 2D textures are supported!");
+            return false;
+        }
+        if (header.supercompressionScheme != 0)
+        {
+            LOG_CORE_ERROR("KTX2: Supercompression scheme {0} is not supported!", header.supercompressionScheme);
+            return false;
+        }
+
+        PixelFormat format;
+        if (!GetPixelFormat(header.vkFormat, format))
+        {
+            LOG_CORE_ERROR("KTX2: VkFormat {0} is not supported!", header.vkFormat);
+            return false;
+        }
+
+        // Fallback for devices that can't sample the format
+        bool decode = false;
+        if (!device.IsFormatSupported(format, TextureUsage::Sampled))
+        {
+            switch (format)
+            {
+                case PixelFormat::BC1:
+                case PixelFormat::BC3:
+                case PixelFormat::BC1Unorm:
+                case PixelFormat::BC3Unorm:
+                case PixelFormat::BC4:
+                case PixelFormat::BC5:
+                    decode = true;
+                    break;
+                default:
+                    LOG_CORE_ERROR("KTX2: VkFormat {0} is not supported by the device and has no fallback!", header.vkFormat);
+                    return false;
+            }
+        }
+
+        // levelCount 0 asks for generated mips
+        uint32_t levelCount = std::max(header.levelCount, 1u);
+        if (levelCount > static_cast<uint32_t>(std::bit_width(std::max(header.pixelWidth, header.pixelHeight))))
+        {
+            LOG_CORE_ERROR("KTX2: Level count {0} is more than a {1}x{2} image has!", levelCount, header.pixelWidth, header.pixelHeight);
+            return false;
+        }
+        if (file.size() < k_KTX2LevelIndexOffset + levelCount * sizeof(KTX2LevelIndex))
+        {
+            LOG_CORE_ERROR("KTX2: File is truncated!");
+            return false;
+        }
+
+        texture.levels.clear();
+        texture.levels.reserve(levelCount);
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            KTX2LevelIndex index;
+            std::memcpy(&index, file.data() + k_KTX2LevelIndexOffset + level * sizeof(KTX2LevelIndex), sizeof(KTX2LevelIndex));
+
+            uint32_t width  = std::max(header.pixelWidth >> level, 1u);
+            uint32_t height = std::max(header.pixelHeight >> level, 1u);
+            if (index.byteLength != GetLevelSize(format, width, height) ||
+                index.byteOffset > file.size() || index.byteLength > file.size() - index.byteOffset)
+            {
+                LOG_CORE_ERROR("KTX2: Level {0} has an invalid size!", level);
+                return false;
+            }
+
+            const char* data = file.data() + index.byteOffset;
+            if (decode)
+                texture.levels.push_back(DecodeBC(format, data, width, height));
+            else
+                texture.levels.emplace_back(data, data + index.byteLength);
+        }
+
+        if (decode)
+        {
+            bool srgb = format == PixelFormat::BC1 || format == PixelFormat::BC3;
+            format = srgb ? PixelFormat::RGBA8 : PixelFormat::RGBA8Unorm;
+            LOG_CORE_WARN("KTX2: VkFormat {0} is not supported by the device, decoded on the CPU", header.vkFormat);
+        }
+
+        // Block-compressed mips can't be generated
+        bool compressed = format >= PixelFormat::BC1;
+
+        texture.desc           = TextureDesc{};
+        texture.desc.width     = header.pixelWidth;
+        texture.desc.height    = header.pixelHeight;
+        texture.desc.format    = format;
+        texture.desc.usage     = TextureUsage::Sampled;
+        texture.desc.mipLevels = header.levelCount == 0 && !compressed ? 0 : levelCount;
+
+        return true;
+    }
+
+    TextureHandle CreateTextureKTX2(IGraphicsDevice& device, const KTX2Texture& texture)
+    {
+        TextureHandle handle = device.CreateTexture(texture.desc);
+
+        // Uploads only read the levels
+        std::vector<void*> levels;
+        for (const std::vector<char>& level : texture.levels)
+            levels.push_back(const_cast<char*>(level.data()));
+
+        ICommandBuffer* cmd = device.BeginImmediate();
+        if (levels.size() == 1)
+            cmd->UploadTexture(handle, levels[0]); // Generates the chain if mipLevels is 0
+        else
+            cmd->UploadTextureMips(handle, levels);
+        device.EndImmediate(cmd);
+
+        return handle;
+    }
+} // namespace Engine::RHI
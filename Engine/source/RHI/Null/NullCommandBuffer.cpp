@@ -0,0 +1,523 @@
+#include "RHI/Null/NullCommandBuffer.h"
+#include "RHI/Null/NullCommandBundle.h"
+#include "RHI/Null/NullGraphicsDevice.h"
+#include "Engine/Core/Assert.h"
+
+#include <algorithm>
+
+namespace Engine::RHI::Null
+{
+    NullCommandBuffer::NullCommandBuffer(NullGraphicsDevice& graphicsDevice)
+        : m_GraphicsDevice(graphicsDevice)
+    {
+    }
+
+    // Graphics
+    void NullCommandBuffer::BindPipeline(PipelineHandle pipeline)
+    {
+        if(pipeline.IsValid() && pipeline.id == m_BoundPipelineHandle.id)
+        {
+            m_Counters.filteredPipelineBinds++;
+            return;
+        }
+
+        NullPipelineData& data = m_GraphicsDevice.GetPipelineData(pipeline);
+
+        ENGINE_CORE_ASSERT(data.compute == m_InComputePass, "NullCommandBuffer: BindPipeline(): compute pipelines are only valid in compute passes and vice versa!");
+
+        // Bindings survive a pipeline change only when both pipelines share a layout, like in the GPU backends
+        if(!m_BoundPipelineHandle.IsValid())
+        {
+            ResetDescriptorState();
+        }
+        else
+        {
+            const NullPipelineData& bound = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
+            if(bound.uniformBindings != data.uniformBindings || bound.pushConstantRanges != data.pushConstantRanges)
+                ResetDescriptorState();
+        }
+
+        if(m_Bundle)
+            m_Bundle->TrackPipeline(pipeline.id);
+
+        m_BoundPipelineHandle = pipeline;
+        m_Counters.pipelineBinds++;
+    }
+
+    void NullCommandBuffer::BindVertexBuffer(BufferHandle buffer)
+    {
+        const BufferDesc& bdesc = m_GraphicsDevice.GetBufferDesc(buffer);
+
+        ENGINE_CORE_ASSERT(bdesc.type == BufferType::Vertex || bdesc.type == BufferType::Storage, "NullCommandBuffer: BindVertexBuffer(): buffer is not a vertex buffer!");
+        ENGINE_CORE_ASSERT(m_Bundle == nullptr || bdesc.usage == BufferUsage::Static, "NullCommandBuffer: BindVertexBuffer(): bundles can't reference dynamic buffers!");
+
+        if(m_Bundle)
+            m_Bundle->TrackBuffer(buffer.id);
+
+        NullBinding resource = GetBinding(buffer, bdesc);
+        if(resource == m_BoundVertexBuffer)
+        {
+            m_Counters.filteredVertexBufferBinds++;
+            return;
+        }
+
+        m_BoundVertexBuffer = resource;
+        m_Counters.vertexBufferBinds++;
+    }
+
+    void NullCommandBuffer::BindIndexBuffer(BufferHandle buffer)
+    {
+        const BufferDesc& bdesc = m_GraphicsDevice.GetBufferDesc(buffer);
+
+        ENGINE_CORE_ASSERT(bdesc.type == BufferType::Index || bdesc.type == BufferType::Storage, "NullCommandBuffer: BindIndexBuffer(): buffer is not an index buffer!");
+        ENGINE_CORE_ASSERT(m_Bundle == nullptr || bdesc.usage == BufferUsage::Static, "NullCommandBuffer: BindIndexBuffer(): bundles can't reference dynamic buffers!");
+
+        if(m_Bundle)
+            m_Bundle->TrackBuffer(buffer.id);
+
+        NullBinding resource = GetBinding(buffer, bdesc);
+        if(resource == m_BoundIndexBuffer)
+        {
+            m_Counters.filteredIndexBufferBinds++;
+            return;
+        }
+
+        m_BoundIndexBuffer = resource;
+        m_BoundIndexCount  = bdesc.size / (bdesc.indexFormat == IndexFormat::Uint32 ? sizeof(uint32_t) : sizeof(uint16_t));
+        m_Counters.indexBufferBinds++;
+    }
+
+    void NullCommandBuffer::ValidateBinding(uint32_t binding, UniformType type, const char* message)
+    {
+        ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "NullCommandBuffer: no bound pipeline!");
+        ENGINE_CORE_ASSERT(binding < k_MaxBindings, "NullCommandBuffer: binding exceeds k_MaxBindings!");
+
+        // Unlike the GPU backends, binding a resource the pipeline doesn't declare is an error here
+        const NullPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
+        auto declared = std::ranges::find_if(pdata.uniformBindings, [&](const UniformBinding& ub) { return ub.binding == binding; });
+        ENGINE_CORE_ASSERT(declared != pdata.uniformBindings.end() && declared->type == type, message);
+
+        m_BoundBindings.set(binding);
+        m_Counters.resourceBinds++;
+    }
+
+    NullCommandBuffer::NullBinding NullCommandBuffer::GetBinding(BufferHandle buffer, const BufferDesc& bdesc) const
+    {
+        if(bdesc.usage == BufferUsage::Static)
+            return NullBinding{ .id = buffer.id };
+
+        auto it = m_DynamicVersions.find(buffer.id);
+        return NullBinding{ .id = buffer.id, .version = it != m_DynamicVersions.end() ? it->second : 0 };
+    }
+
+    void NullCommandBuffer::SetBinding(uint32_t binding, NullBinding resource)
+    {
+        if(m_BindingResources[binding] == resource)
+            return;
+
+        m_BindingResources[binding] = resource;
+        m_DescriptorsDirty = true;
+    }
+
+    void NullCommandBuffer::ResetDescriptorState()
+    {
+        m_BoundBindings.reset();
+        m_BindingResources   = {};
+        m_DescriptorsDirty   = true;
+        m_DescriptorsFlushed = false;
+    }
+
+    void NullCommandBuffer::FlushDescriptors()
+    {
+        if(!m_DescriptorsDirty)
+            return;
+
+        m_DescriptorsDirty = false;
+
+        // Pipelines without bindings bind no set
+        const NullPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
+        if(pdata.uniformBindings.empty())
+            return;
+
+        if(m_DescriptorsFlushed && m_BindingResources == m_FlushedResources)
+        {
+            m_Counters.filteredDescriptorBinds++;
+            return;
+        }
+
+        m_FlushedResources   = m_BindingResources;
+        m_DescriptorsFlushed = true;
+        m_Counters.descriptorBinds++;
+    }
+
+    void NullCommandBuffer::BindUniformBuffer(BufferHandle buffer, uint32_t binding)
+    {
+        ValidateBinding(binding, UniformType::UniformBuffer, "NullCommandBuffer: BindUniformBuffer(): binding is not a uniform buffer in the bound pipeline!");
+
+        const BufferDesc& bdesc = m_GraphicsDevice.GetBufferDesc(buffer);
+
+        ENGINE_CORE_ASSERT(bdesc.type == BufferType::Uniform, "NullCommandBuffer: BindUniformBuffer(): buffer is not a uniform buffer!");
+        ENGINE_CORE_ASSERT(m_Bundle == nullptr || bdesc.usage == BufferUsage::Static, "NullCommandBuffer: BindUniformBuffer(): bundles can't reference dynamic buffers!");
+
+        if(m_Bundle)
+            m_Bundle->TrackBuffer(buffer.id);
+
+        SetBinding(binding, GetBinding(buffer, bdesc));
+    }
+
+    void NullCommandBuffer::BindTexture(TextureHandle texture, uint32_t binding)
+    {
+        ValidateBinding(binding, UniformType::Texture, "NullCommandBuffer: BindTexture(): binding is not a texture in the bound pipeline!");
+
+        NullTextureData& tdata = m_GraphicsDevice.GetTextureData(texture);
+
+        ENGINE_CORE_ASSERT(tdata.desc.usage.Has(TextureUsage::Sampled), "NullCommandBuffer: BindTexture(): texture was not created with TextureUsage::Sampled!");
+
+        if(m_Bundle)
+            m_Bundle->TrackTexture(texture.id);
+
+        SetBinding(binding, NullBinding{ .id = texture.id });
+    }
+
+    void NullCommandBuffer::BindStorageBuffer(BufferHandle buffer, uint32_t binding)
+    {
+        ValidateBinding(binding, UniformType::StorageBuffer, "NullCommandBuffer: BindStorageBuffer(): binding is not a storage buffer in the bound pipeline!");
+
+        const BufferDesc& bdesc = m_GraphicsDevice.GetBufferDesc(buffer);
+
+        ENGINE_CORE_ASSERT(bdesc.type == BufferType::Storage, "NullCommandBuffer: BindStorageBuffer(): buffer is not a storage buffer!");
+
+        if(m_Bundle)
+            m_Bundle->TrackBuffer(buffer.id);
+
+        SetBinding(binding, NullBinding{ .id = buffer.id });
+    }
+
+    void NullCommandBuffer::BindStorageTexture(TextureHandle texture, uint32_t binding)
+    {
+        ValidateBinding(binding, UniformType::StorageTexture, "NullCommandBuffer: BindStorageTexture(): binding is not a storage texture in the bound pipeline!");
+
+        NullTextureData& tdata = m_GraphicsDevice.GetTextureData(texture);
+
+        ENGINE_CORE_ASSERT(tdata.desc.usage.Has(TextureUsage::Storage), "NullCommandBuffer: BindStorageTexture(): texture was not created with TextureUsage::Storage!");
+
+        // Storage textures are moved to their layout on first use, which can't happen inside rendering
+        if(!tdata.written)
+        {
+            ENGINE_CORE_ASSERT(!m_InRenderPass && m_Bundle == nullptr, "NullCommandBuffer: BindStorageTexture(): first use of a storage texture must be outside of rendering!");
+            tdata.written = true;
+        }
+
+        if(m_Bundle)
+            m_Bundle->TrackTexture(texture.id);
+
+        SetBinding(binding, NullBinding{ .id = texture.id });
+    }
+
+    void NullCommandBuffer::PushConstants(ShaderStage stage, uint32_t offset, uint32_t size, const void* data)
+    {
+        ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "NullCommandBuffer: PushConstants(): no bound pipeline!");
+        ENGINE_CORE_ASSERT(data != nullptr && size > 0, "NullCommandBuffer: PushConstants(): no data!");
+
+        // Every range the update overlaps must cover it, and one of them must be declared for stage
+        const NullPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
+        bool declared = false;
+        for(const PushConstantRange& range : pdata.pushConstantRanges)
+        {
+            if(offset < range.offset + range.size && range.offset < offset + size)
+            {
+                ENGINE_CORE_ASSERT(range.offset <= offset && offset + size <= range.offset + range.size, "NullCommandBuffer: PushConstants(): update straddles a push constant range!");
+                declared |= range.stage == stage;
+            }
+        }
+
+        ENGINE_CORE_ASSERT(declared, "NullCommandBuffer: PushConstants(): range is not declared for this stage in the pipeline!");
+
+        m_Counters.pushConstants++;
+    }
+
+    void NullCommandBuffer::ValidateDraw(const char* message)
+    {
+        ENGINE_CORE_ASSERT(m_InRenderPass, message);
+        ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "NullCommandBuffer: Draw(): no bound pipeline!");
+
+        const NullPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
+        for(const UniformBinding& ub : pdata.uniformBindings)
+        {
+            ENGINE_CORE_ASSERT(m_BoundBindings.test(ub.binding), "NullCommandBuffer: Draw(): a uniform binding of the bound pipeline was never bound!");
+        }
+
+        FlushDescriptors();
+    }
+
+    void NullCommandBuffer::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+    {
+        ValidateDraw("NullCommandBuffer: Draw(): not in a graphics pass!");
+        m_Counters.draws++;
+    }
+
+    void NullCommandBuffer::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t indexOffset, uint32_t firstInstance)
+    {
+        ValidateDraw("NullCommandBuffer: DrawIndexed(): not in a graphics pass!");
+        ENGINE_CORE_ASSERT(m_BoundIndexBuffer.id != 0, "NullCommandBuffer: DrawIndexed(): no bound index buffer!");
+        ENGINE_CORE_ASSERT(static_cast<size_t>(firstIndex) + indexCount <= m_BoundIndexCount, "NullCommandBuffer: DrawIndexed(): indices exceed the bound index buffer!");
+        m_Counters.draws++;
+    }
+
+    void NullCommandBuffer::ValidateIndirectBuffer(BufferHandle buffer, size_t offset, size_t size)
+    {
+        const BufferDesc& bdesc = m_GraphicsDevice.GetBufferDesc(buffer);
+
+        ENGINE_CORE_ASSERT(bdesc.type == BufferType::Indirect || bdesc.type == BufferType::Storage, "NullCommandBuffer: indirect arguments must be in an indirect or storage buffer!");
+        ENGINE_CORE_ASSERT(m_Bundle == nullptr || bdesc.usage == BufferUsage::Static, "NullCommandBuffer: bundles can't reference dynamic buffers!");
+        ENGINE_CORE_ASSERT(offset % 4 == 0, "NullCommandBuffer: indirect offsets must be multiples of 4!");
+        ENGINE_CORE_ASSERT(offset + size <= bdesc.size, "NullCommandBuffer: indirect arguments exceed the buffer!");
+
+        if(m_Bundle)
+            m_Bundle->TrackBuffer(buffer.id);
+    }
+
+    void NullCommandBuffer::DrawIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride)
+    {
+        ValidateDraw("NullCommandBuffer: DrawIndirect(): not in a graphics pass!");
+        ENGINE_CORE_ASSERT(drawCount <= 1 || stride >= sizeof(DrawIndirectCommand), "NullCommandBuffer: DrawIndirect(): stride is smaller than a command!");
+        ValidateIndirectBuffer(buffer, offset, drawCount == 0 ? 0 : static_cast<size_t>(drawCount - 1) * stride + sizeof(DrawIndirectCommand));
+        m_Counters.indirectDraws++;
+    }
+
+    void NullCommandBuffer::DrawIndexedIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride)
+    {
+        ValidateDraw("NullCommandBuffer: DrawIndexedIndirect(): not in a graphics pass!");
+        ENGINE_CORE_ASSERT(m_BoundIndexBuffer.id != 0, "NullCommandBuffer: DrawIndexedIndirect(): no bound index buffer!");
+        ENGINE_CORE_ASSERT(drawCount <= 1 || stride >= sizeof(DrawIndexedIndirectCommand), "NullCommandBuffer: DrawIndexedIndirect(): stride is smaller than a command!");
+        ValidateIndirectBuffer(buffer, offset, drawCount == 0 ? 0 : static_cast<size_t>(drawCount - 1) * stride + sizeof(DrawIndexedIndirectCommand));
+        m_Counters.indirectDraws++;
+    }
+
+    void NullCommandBuffer::DrawIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride)
+    {
+        ENGINE_CORE_ASSERT(m_GraphicsDevice.GetCapabilities().drawIndirectCount, "NullCommandBuffer: DrawIndirectCount(): drawIndirectCount is not supported by this device!");
+        ValidateDraw("NullCommandBuffer: DrawIndirectCount(): not in a graphics pass!");
+        ValidateIndirectBuffer(buffer, offset, maxDrawCount == 0 ? 0 : static_cast<size_t>(maxDrawCount - 1) * stride + sizeof(DrawIndirectCommand));
+        ValidateIndirectBuffer(countBuffer, countOffset, sizeof(uint32_t));
+        m_Counters.indirectDraws++;
+    }
+
+    void NullCommandBuffer::DrawIndexedIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride)
+    {
+        ENGINE_CORE_ASSERT(m_GraphicsDevice.GetCapabilities().drawIndirectCount, "NullCommandBuffer: DrawIndexedIndirectCount(): drawIndirectCount is not supported by this device!");
+        ValidateDraw("NullCommandBuffer: DrawIndexedIndirectCount(): not in a graphics pass!");
+        ENGINE_CORE_ASSERT(m_BoundIndexBuffer.id != 0, "NullCommandBuffer: DrawIndexedIndirectCount(): no bound index buffer!");
+        ValidateIndirectBuffer(buffer, offset, maxDrawCount == 0 ? 0 : static_cast<size_t>(maxDrawCount - 1) * stride + sizeof(DrawIndexedIndirectCommand));
+        ValidateIndirectBuffer(countBuffer, countOffset, sizeof(uint32_t));
+        m_Counters.indirectDraws++;
+    }
+
+    void NullCommandBuffer::ExecuteBundle(ICommandBundle* bundle)
+    {
+        ENGINE_CORE_ASSERT(bundle != nullptr, "NullCommandBuffer: ExecuteBundle(): bundle is nullptr!");
+        ENGINE_CORE_ASSERT(m_InRenderPass && m_Bundle == nullptr, "NullCommandBuffer: ExecuteBundle(): not in a graphics pass!");
+
+        NullCommandBundle* nbundle = static_cast<NullCommandBundle*>(bundle);
+
+        ENGINE_CORE_ASSERT(nbundle->IsValid(), "NullCommandBuffer: ExecuteBundle(): bundle is not recorded or was invalidated, re-record it!");
+        if(!nbundle->IsValid())
+            return;
+
+        ENGINE_CORE_ASSERT(m_ColorAttachmentCount == 1 && nbundle->GetDesc().swapChain == m_SwapChain, "NullCommandBuffer: ExecuteBundle(): bundle was recorded for a different target!");
+        ENGINE_CORE_ASSERT(nbundle->GetDesc().depthBuffer == m_DepthBuffer, "NullCommandBuffer: ExecuteBundle(): bundle depth buffer does not match the pass!");
+
+        // The bundle's commands count in every pass that replays them
+        m_Counters += nbundle->GetCounters();
+        m_Counters.bundles++;
+
+        // State bound before the bundle is undefined afterwards
+        m_BoundPipelineHandle = PipelineHandle{ .id = 0 };
+        m_BoundVertexBuffer   = {};
+        m_BoundIndexBuffer    = {};
+        m_BoundIndexCount     = 0;
+        ResetDescriptorState();
+    }
+
+    // Debug markers
+    void NullCommandBuffer::BeginMarker(const char* name)
+    {
+        ENGINE_CORE_ASSERT(name != nullptr, "NullCommandBuffer: BeginMarker(): name is nullptr!");
+        m_MarkerDepth++;
+    }
+
+    void NullCommandBuffer::EndMarker()
+    {
+        ENGINE_CORE_ASSERT(m_MarkerDepth > 0, "NullCommandBuffer: EndMarker(): no open marker!");
+        if(m_MarkerDepth > 0)
+            m_MarkerDepth--;
+    }
+
+    // Compute
+    void NullCommandBuffer::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+    {
+        ENGINE_CORE_ASSERT(m_InComputePass, "NullCommandBuffer: Dispatch(): not in a compute pass!");
+        ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "NullCommandBuffer: Dispatch(): no bound pipeline!");
+
+        const NullPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
+        for(const UniformBinding& ub : pdata.uniformBindings)
+        {
+            ENGINE_CORE_ASSERT(m_BoundBindings.test(ub.binding), "NullCommandBuffer: Dispatch(): a uniform binding of the bound pipeline was never bound!");
+        }
+
+        FlushDescriptors();
+        m_Counters.dispatches++;
+    }
+
+    void NullCommandBuffer::DispatchIndirect(BufferHandle buffer, size_t offset)
+    {
+        ENGINE_CORE_ASSERT(m_InComputePass, "NullCommandBuffer: DispatchIndirect(): not in a compute pass!");
+        ValidateIndirectBuffer(buffer, offset, 3 * sizeof(uint32_t));
+
+        // Group counts come from the buffer, everything else is checked like a direct dispatch
+        Dispatch(1);
+    }
+
+    void NullCommandBuffer::ComputeBarrier()
+    {
+        ENGINE_CORE_ASSERT(m_InComputePass, "NullCommandBuffer: ComputeBarrier(): not in a compute pass!");
+    }
+
+    // Data
+    void NullCommandBuffer::UploadBuffer(BufferHandle buffer, void* data, size_t size, size_t offset)
+    {
+        ENGINE_CORE_ASSERT(m_Bundle == nullptr, "NullCommandBuffer: UploadBuffer(): not valid in a bundle!");
+        ENGINE_CORE_ASSERT(data != nullptr, "NullCommandBuffer: UploadBuffer(): data is nullptr!");
+
+        const BufferDesc& bdesc = m_GraphicsDevice.GetBufferDesc(buffer);
+
+        // Dynamic buffers ignore offset
+        size_t end = bdesc.usage == BufferUsage::Static ? offset + size : size;
+        ENGINE_CORE_ASSERT(end <= bdesc.size, "NullCommandBuffer: UploadBuffer(): upload exceeds the buffer!");
+
+        if(bdesc.usage == BufferUsage::Dynamic)
+            m_DynamicVersions[buffer.id]++;
+
+        m_Counters.uploads++;
+        m_Counters.uploadBytes += size;
+    }
+
+    void* NullCommandBuffer::MapDynamic(BufferHandle buffer, size_t size)
+    {
+        ENGINE_CORE_ASSERT(m_Bundle == nullptr, "NullCommandBuffer: MapDynamic(): not valid in a bundle!");
+
+        const BufferDesc& bdesc = m_GraphicsDevice.GetBufferDesc(buffer);
+
+        ENGINE_CORE_ASSERT(bdesc.usage == BufferUsage::Dynamic, "NullCommandBuffer: MapDynamic(): buffer is not dynamic!");
+        ENGINE_CORE_ASSERT(size <= bdesc.size, "NullCommandBuffer: MapDynamic(): size exceeds the buffer!");
+
+        m_DynamicVersions[buffer.id]++;
+
+        m_Counters.uploads++;
+        m_Counters.uploadBytes += size;
+        return AllocateDynamic(size);
+    }
+
+    void* NullCommandBuffer::AllocateDynamic(size_t size)
+    {
+        // Bump through the pages, skipping the rest of a page that doesn't fit. Pages never move
+        size = (size + 15) & ~size_t(15);
+        while(m_DynamicPage < m_DynamicPages.size())
+        {
+            std::vector<char>& page = m_DynamicPages[m_DynamicPage];
+            if(m_DynamicOffset + size <= page.size())
+            {
+                void* mapped = page.data() + m_DynamicOffset;
+                m_DynamicOffset += size;
+                return mapped;
+            }
+
+            m_DynamicPage++;
+            m_DynamicOffset = 0;
+        }
+
+        m_DynamicPages.emplace_back(std::max(size, k_DynamicPageSize));
+        m_DynamicOffset = size;
+        return m_DynamicPages.back().data();
+    }
+
+    void NullCommandBuffer::UploadTexture(TextureHandle texture, void* data)
+    {
+        ENGINE_CORE_ASSERT(m_Bundle == nullptr, "NullCommandBuffer: UploadTexture(): not valid in a bundle!");
+        ENGINE_CORE_ASSERT(data != nullptr, "NullCommandBuffer: UploadTexture(): data is nullptr!");
+
+        NullTextureData& tdata = m_GraphicsDevice.GetTextureData(texture);
+        ENGINE_CORE_ASSERT(tdata.desc.mipLevels == 1 || tdata.desc.format < PixelFormat::BC1, "NullCommandBuffer: UploadTexture(): compressed mips can't be generated, use UploadTextureMips()!");
+
+        tdata.written = true;
+        m_Counters.uploads++;
+        m_Counters.uploadBytes += NullGraphicsDevice::GetMipSize(tdata.desc, 0);
+    }
+
+    void NullCommandBuffer::UploadTextureMips(TextureHandle texture, const std::vector<void*>& levels)
+    {
+        ENGINE_CORE_ASSERT(m_Bundle == nullptr, "NullCommandBuffer: UploadTextureMips(): not valid in a bundle!");
+
+        NullTextureData& tdata = m_GraphicsDevice.GetTextureData(texture);
+        ENGINE_CORE_ASSERT(levels.size() == tdata.desc.mipLevels, "NullCommandBuffer: UploadTextureMips(): need one level per mip!");
+
+        tdata.written = true;
+        m_Counters.uploads++;
+        for(uint32_t level = 0; level < levels.size(); level++)
+        {
+            ENGINE_CORE_ASSERT(levels[level] != nullptr, "NullCommandBuffer: UploadTextureMips(): level is nullptr!");
+            m_Counters.uploadBytes += NullGraphicsDevice::GetMipSize(tdata.desc, level);
+        }
+    }
+
+    // Pass state
+    void NullCommandBuffer::BeginRendering(SwapChainHandle swapChain, TextureHandle depthBuffer, uint32_t colorAttachmentCount)
+    {
+        ENGINE_CORE_ASSERT(!m_InRenderPass && !m_InComputePass, "NullCommandBuffer: BeginRendering(): already in a pass!");
+
+        m_InRenderPass         = true;
+        m_SwapChain            = swapChain;
+        m_DepthBuffer          = depthBuffer;
+        m_ColorAttachmentCount = colorAttachmentCount;
+    }
+
+    void NullCommandBuffer::EndRendering()
+    {
+        ENGINE_CORE_ASSERT(m_InRenderPass, "NullCommandBuffer: EndRendering(): not in a render pass!");
+        ENGINE_CORE_ASSERT(m_MarkerDepth == 0, "NullCommandBuffer: pass ended with open markers!");
+        m_InRenderPass = false;
+    }
+
+    void NullCommandBuffer::BeginCompute()
+    {
+        ENGINE_CORE_ASSERT(!m_InRenderPass && !m_InComputePass, "NullCommandBuffer: BeginCompute(): already in a pass!");
+        m_InComputePass = true;
+    }
+
+    void NullCommandBuffer::EndCompute()
+    {
+        ENGINE_CORE_ASSERT(m_InComputePass, "NullCommandBuffer: EndCompute(): not in a compute pass!");
+        ENGINE_CORE_ASSERT(m_MarkerDepth == 0, "NullCommandBuffer: pass ended with open markers!");
+        m_InComputePass = false;
+    }
+
+    void NullCommandBuffer::Reset()
+    {
+        m_InRenderPass         = false;
+        m_InComputePass        = false;
+        m_SwapChain            = {};
+        m_DepthBuffer          = {};
+        m_ColorAttachmentCount = 0;
+        m_BoundPipelineHandle  = {};
+        m_BoundVertexBuffer    = {};
+        m_BoundIndexBuffer     = {};
+        m_BoundIndexCount      = 0;
+        m_MarkerDepth          = 0;
+        m_Bundle               = nullptr;
+        m_Counters             = {};
+        m_DynamicPage          = 0;
+        m_DynamicOffset        = 0;
+        m_DynamicVersions.clear();
+        ResetDescriptorState();
+    }
+} // namespace Engine::RHI::Null
@@ -0,0 +1,133 @@
+#ifndef RHI_NULL_NULLCOMMANDBUFFER
+#define RHI_NULL_NULLCOMMANDBUFFER
+
+#include "engine_export.h"
+
+#include "Engine/RHI/ICommandBuffer.h"
+
+#include <array>
+#include <bitset>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine::RHI::Null
+{
+    // Forward
+    class NullGraphicsDevice;
+    class NullCommandBundle;
+
+    // Same limit as the Vulkan backend, so code validated here binds the same way there
+    static constexpr uint32_t k_MaxBindings = 8;
+
+    // Records nothing. Every command is checked against the rules the GPU backends enforce and counted
+    class ENGINE_EXPORT NullCommandBuffer : public ICommandBuffer
+    {
+    private:
+        friend class NullGraphicsDevice;
+        friend class NullCommandBundle;
+
+        NullGraphicsDevice& m_GraphicsDevice;
+
+        // State
+        bool                       m_InRenderPass  = false;
+        bool                       m_InComputePass = false;
+        SwapChainHandle            m_SwapChain;      // Rendered swapchain, if any
+        TextureHandle              m_DepthBuffer;    // Depth attachment, if any
+        uint32_t                   m_ColorAttachmentCount = 0;
+        PipelineHandle             m_BoundPipelineHandle;
+        std::bitset<k_MaxBindings> m_BoundBindings;
+        uint32_t                   m_MarkerDepth = 0;
+
+        // Shadow of the bound state, filtered and counted like the Vulkan backend. A dynamic buffer moves on every
+        // upload, so it is told apart by the number of uploads this command buffer made to it
+        struct NullBinding {
+            uint32_t id      = 0;
+            uint32_t version = 0;
+
+            bool operator==(const NullBinding&) const = default;
+        };
+        NullBinding                            m_BoundVertexBuffer;
+        NullBinding                            m_BoundIndexBuffer;
+        size_t                                 m_BoundIndexCount = 0; // Indices that fit in the bound index buffer
+        std::array<NullBinding, k_MaxBindings> m_BindingResources = {}; // Bound since the last draw or dispatch
+        std::array<NullBinding, k_MaxBindings> m_FlushedResources = {}; // Applied by the last draw or dispatch
+        bool                                   m_DescriptorsDirty   = false;
+        bool                                   m_DescriptorsFlushed = false;
+        std::unordered_map<uint32_t, uint32_t> m_DynamicVersions;
+
+        NullBinding GetBinding(BufferHandle buffer, const BufferDesc& bdesc) const;
+        void SetBinding(uint32_t binding, NullBinding resource);
+        void ResetDescriptorState();
+        void FlushDescriptors();
+
+        // Bundle being recorded. Referenced resources are reported to it so it can be invalidated
+        NullCommandBundle* m_Bundle = nullptr;
+
+        // Merged into the frame's counters when the pass ends
+        CommandCounters m_Counters;
+
+        // MapDynamic() memory, reused once the command buffer is reset
+        static constexpr size_t k_DynamicPageSize = 64 * 1024;
+        std::vector<std::vector<char>> m_DynamicPages;
+        size_t                         m_DynamicPage   = 0;
+        size_t                         m_DynamicOffset = 0;
+
+        void* AllocateDynamic(size_t size);
+
+        // Shared checks
+        void ValidateBinding(uint32_t binding, UniformType type, const char* message);
+        void ValidateDraw(const char* message);
+        void ValidateIndirectBuffer(BufferHandle buffer, size_t offset, size_t size);
+
+    public:
+        NullCommandBuffer(NullGraphicsDevice& graphicsDevice);
+
+        // Graphics
+        void BindPipeline(PipelineHandle pipeline) override;
+        void BindVertexBuffer(BufferHandle buffer) override;
+        void BindIndexBuffer(BufferHandle buffer) override;
+        void BindUniformBuffer(BufferHandle buffer, uint32_t binding) override;
+        void BindTexture(TextureHandle texture, uint32_t binding) override;
+        void PushConstants(ShaderStage stage, uint32_t offset, uint32_t size, const void* data) override;
+        void BindStorageBuffer(BufferHandle buffer, uint32_t binding) override;
+        void BindStorageTexture(TextureHandle texture, uint32_t binding) override;
+        void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) override;
+        void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t indexOffset = 0, uint32_t firstInstance = 0) override;
+
+        // Indirect drawing
+        void DrawIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride = sizeof(DrawIndirectCommand)) override;
+        void DrawIndexedIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride = sizeof(DrawIndexedIndirectCommand)) override;
+        void DrawIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride = sizeof(DrawIndirectCommand)) override;
+        void DrawIndexedIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride = sizeof(DrawIndexedIndirectCommand)) override;
+
+        // Bundles
+        void ExecuteBundle(ICommandBundle* bundle) override;
+
+        // Debug markers
+        void BeginMarker(const char* name) override;
+        void EndMarker() override;
+
+        // Compute
+        void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) override;
+        void DispatchIndirect(BufferHandle buffer, size_t offset = 0) override;
+        void ComputeBarrier() override;
+
+        // Data
+        void UploadBuffer(BufferHandle buffer, void* data, size_t size, size_t offset) override;
+        void* MapDynamic(BufferHandle buffer, size_t size) override;
+        void UploadTexture(TextureHandle texture, void* data) override;
+        void UploadTextureMips(TextureHandle texture, const std::vector<void*>& levels) override;
+
+        // Pass state, set by the device
+        void BeginRendering(SwapChainHandle swapChain, TextureHandle depthBuffer, uint32_t colorAttachmentCount);
+        void EndRendering();
+        void BeginCompute();
+        void EndCompute();
+
+        const CommandCounters& GetCounters() const { return m_Counters; }
+        bool IsComputePass() const { return m_InComputePass; }
+        void Reset();
+    };
+} // namespace Engine::RHI::Null
+
+#endif // RHI_NULL_NULLCOMMANDBUFFER
@@ -0,0 +1,71 @@
+#include "RHI/Null/NullCommandBundle.h"
+#include "RHI/Null/NullCommandBuffer.h"
+#include "RHI/Null/NullGraphicsDevice.h"
+#include "Engine/Core/Assert.h"
+
+namespace Engine::RHI::Null
+{
+    NullCommandBundle::NullCommandBundle(NullGraphicsDevice& graphicsDevice, uint32_t id, const CommandBundleDesc& desc)
+        : m_GraphicsDevice(graphicsDevice), m_ID(id), m_Desc(desc)
+    {
+        ENGINE_CORE_ASSERT(desc.swapChain.IsValid(), "Null: NullCommandBundle: swapChain is invalid!");
+
+        m_CommandBuffer = CreateScope<NullCommandBuffer>(graphicsDevice);
+    }
+
+    NullCommandBundle::~NullCommandBundle() = default;
+
+    ICommandBuffer* NullCommandBundle::Begin()
+    {
+        ENGINE_CORE_ASSERT(!m_IsRecording, "Null: NullCommandBundle: Begin(): already recording!");
+
+        // Snapshot the target
+        NullSwapChainData& sc = m_GraphicsDevice.GetSwapChainData(m_Desc.swapChain);
+        m_Width  = sc.width;
+        m_Height = sc.height;
+        m_Format = sc.desc.format;
+
+        m_Buffers.clear();
+        m_Textures.clear();
+        m_Pipelines.clear();
+
+        if(m_Desc.depthBuffer.IsValid())
+        {
+            NullTextureData& depth = m_GraphicsDevice.GetTextureData(m_Desc.depthBuffer);
+            ENGINE_CORE_ASSERT(depth.desc.usage.Has(TextureUsage::DepthStencil), "Null: NullCommandBundle: Begin(): depth buffer was not created with TextureUsage::DepthStencil!");
+            TrackTexture(m_Desc.depthBuffer.id);
+        }
+
+        m_IsRecording = true;
+        m_Recorded    = false;
+        m_Invalidated = false;
+
+        // Bundles record inside the rendering of the passes that execute them
+        NullCommandBuffer* cmd = m_CommandBuffer.get();
+        cmd->Reset();
+        cmd->m_Bundle = this;
+        cmd->BeginRendering(m_Desc.swapChain, m_Desc.depthBuffer, 1);
+        return cmd;
+    }
+
+    void NullCommandBundle::End()
+    {
+        ENGINE_CORE_ASSERT(m_IsRecording, "Null: NullCommandBundle: End(): not recording!");
+
+        m_CommandBuffer->EndRendering();
+        m_Counters = m_CommandBuffer->GetCounters();
+
+        m_IsRecording = false;
+        m_Recorded    = true;
+    }
+
+    bool NullCommandBundle::IsValid() const
+    {
+        if(!m_Recorded || m_Invalidated)
+            return false;
+
+        // A resized swapchain has a new size
+        NullSwapChainData& sc = m_GraphicsDevice.GetSwapChainData(m_Desc.swapChain);
+        return sc.width == m_Width && sc.height == m_Height && sc.desc.format == m_Format;
+    }
+} // namespace Engine::RHI::Null
@@ -0,0 +1,75 @@
+#ifndef RHI_NULL_NULLCOMMANDBUNDLE
+#define RHI_NULL_NULLCOMMANDBUNDLE
+
+#include "engine_export.h"
+
+#include "Engine/Core/Base.h"
+
+#include "Engine/RHI/ICommandBundle.h"
+
+#include <cstdint>
+#include <unordered_set>
+
+namespace Engine::RHI::Null
+{
+    // Forward
+    class NullGraphicsDevice;
+    class NullCommandBuffer;
+
+    // Keeps the recorded counters and referenced resources, so executing it counts and invalidates like a real bundle
+    class ENGINE_EXPORT NullCommandBundle : public ICommandBundle
+    {
+    private:
+        friend class NullGraphicsDevice;
+        friend class NullCommandBuffer;
+
+        NullGraphicsDevice&      m_GraphicsDevice;
+        uint32_t                 m_ID;
+        CommandBundleDesc        m_Desc;
+        Scope<NullCommandBuffer> m_CommandBuffer;
+
+        // State
+        bool m_IsRecording = false;
+        bool m_Recorded    = false;
+        bool m_Invalidated = false;
+
+        // Target the recording was made for
+        uint32_t    m_Width  = 0;
+        uint32_t    m_Height = 0;
+        PixelFormat m_Format = PixelFormat::RGBA8;
+
+        // Counters of the current recording, added to every pass that executes it
+        CommandCounters m_Counters;
+
+        // Resources referenced by the current recording
+        std::unordered_set<uint32_t> m_Buffers;
+        std::unordered_set<uint32_t> m_Textures;
+        std::unordered_set<uint32_t> m_Pipelines;
+
+    public:
+        NullCommandBundle(NullGraphicsDevice& graphicsDevice, uint32_t id, const CommandBundleDesc& desc);
+        ~NullCommandBundle() override;
+
+        ICommandBuffer* Begin() override;
+        void End() override;
+        bool IsValid() const override;
+
+        // Tracking for Null classes
+        void TrackBuffer(uint32_t id)   { m_Buffers.insert(id); }
+        void TrackTexture(uint32_t id)  { m_Textures.insert(id); }
+        void TrackPipeline(uint32_t id) { m_Pipelines.insert(id); }
+
+        // Called by the device when a resource is destroyed or resized
+        void OnBufferDestroyed(uint32_t id)    { if (m_Buffers.contains(id)) m_Invalidated = true; }
+        void OnTextureDestroyed(uint32_t id)   { if (m_Textures.contains(id)) m_Invalidated = true; }
+        void OnPipelineDestroyed(uint32_t id)  { if (m_Pipelines.contains(id)) m_Invalidated = true; }
+        void OnSwapChainDestroyed(uint32_t id) { if (m_Desc.swapChain.id == id) m_Invalidated = true; }
+
+        // Getters for Null classes
+        uint32_t GetID() const { return m_ID; }
+        const CommandBundleDesc& GetDesc() const { return m_Desc; }
+        const CommandCounters& GetCounters() const { return m_Counters; }
+    };
+} // namespace Engine::RHI::Null
+
+#endif // RHI_NULL_NULLCOMMANDBUNDLE
@@ -0,0 +1,732 @@
+#include "RHI/Null/NullGraphicsDevice.h"
+#include "RHI/Null/NullCommandBuffer.h"
+#include "RHI/Null/NullCommandBundle.h"
+#include "Engine/Platform/IWindow.h"
+#include "Engine/Core/Assert.h"
+#include "Engine/Core/Log.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Engine::RHI::Null
+{
+    // Placed texture layout. Heaps have a single memory type
+    static constexpr size_t   k_TextureAlignment  = 256;
+    static constexpr uint32_t k_MemoryTypeBits    = 1;
+    static constexpr uint32_t k_MaxFramesInFlight = 4;
+    static constexpr uint32_t k_MaxPushConstants  = 128; // Minimum every device supports
+
+    NullGraphicsDevice::NullGraphicsDevice(const GraphicsDeviceDesc& desc)
+        : m_Desc(desc)
+    {
+        if(m_Desc.framesInFlight < 1 || m_Desc.framesInFlight > k_MaxFramesInFlight)
+        {
+            LOG_CORE_WARN("Null: NullGraphicsDevice: framesInFlight must be between 1 and {0}, got {1}. Clamping.", k_MaxFramesInFlight, m_Desc.framesInFlight);
+            m_Desc.framesInFlight = std::clamp<uint32_t>(m_Desc.framesInFlight, 1, k_MaxFramesInFlight);
+        }
+
+        // Code paths for optional features are validated too. There are no queries to time anything with
+        m_Capabilities.multiDrawIndirect      = true;
+        m_Capabilities.drawIndirectCount      = true;
+        m_Capabilities.memoryBudget           = true;
+        m_Capabilities.samplerAnisotropy      = true;
+        m_Capabilities.textureCompressionBC   = true;
+        m_Capabilities.textureCompressionETC2 = true;
+        m_Capabilities.textureCompressionASTC = true;
+
+        m_ImmediateCommandBuffer = CreateScope<NullCommandBuffer>(*this);
+
+        LOG_CORE_INFO("Null: NullGraphicsDevice: Created, no GPU work will be issued");
+    }
+
+    NullGraphicsDevice::~NullGraphicsDevice() = default;
+
+    size_t NullGraphicsDevice::GetPixelSize(PixelFormat format)
+    {
+        switch(format)
+        {
+            case PixelFormat::RGBA8:           return 4;
+            case PixelFormat::Depth32:         return 4;
+            case PixelFormat::Depth24Stencil8: return 4;
+            case PixelFormat::RGBA8Unorm:      return 4;
+            case PixelFormat::RGBA16F:         return 8;
+            case PixelFormat::RGBA32F:         return 16;
+            case PixelFormat::R32F:            return 4;
+            case PixelFormat::BC1:             return 8;
+            case PixelFormat::BC1Unorm:        return 8;
+            case PixelFormat::BC3:             return 16;
+            case PixelFormat::BC3Unorm:        return 16;
+            case PixelFormat::BC4:             return 8;
+            case PixelFormat::BC5:             return 16;
+            case PixelFormat::BC7:             return 16;
+            case PixelFormat::BC7Unorm:        return 16;
+            case PixelFormat::ETC2RGB8:        return 8;
+            case PixelFormat::ETC2RGBA8:       return 16;
+            case PixelFormat::ASTC4x4:         return 16;
+        }
+        return 0;
+    }
+
+    size_t NullGraphicsDevice::GetMipSize(const TextureDesc& desc, uint32_t mipLevel)
+    {
+        size_t block  = desc.format >= PixelFormat::BC1 ? 4 : 1;
+        size_t width  = (std::max(desc.width >> mipLevel, 1u) + block - 1) / block;
+        size_t height = (std::max(desc.height >> mipLevel, 1u) + block - 1) / block;
+        return width * height * GetPixelSize(desc.format);
+    }
+
+    // Resource creation
+    BufferHandle NullGraphicsDevice::CreateBuffer(const BufferDesc& desc)
+    {
+        ENGINE_CORE_ASSERT(desc.size > 0, "Null: NullGraphicsDevice: CreateBuffer(): size is 0!");
+        ENGINE_CORE_ASSERT(desc.type != BufferType::Storage || desc.usage == BufferUsage::Static, "Null: NullGraphicsDevice: CreateBuffer(): storage buffers must be static!");
+
+        uint32_t id = BufferHandle::AllocateID();
+        m_Buffers[id] = desc;
+        return BufferHandle{ .id = id };
+    }
+
+    NullTextureData NullGraphicsDevice::CreateTextureData(const TextureDesc& desc)
+    {
+        ENGINE_CORE_ASSERT(desc.width > 0 && desc.height > 0, "Null: NullGraphicsDevice: texture size is 0!");
+        ENGINE_CORE_ASSERT(desc.usage != TextureUsageFlags(TextureUsage::None), "Null: NullGraphicsDevice: texture has no usage!");
+
+        NullTextureData data;
+        data.desc = desc;
+        if(data.desc.mipLevels == 0)
+            data.desc.mipLevels = static_cast<uint32_t>(std::bit_width(std::max(desc.width, desc.height)));
+
+        bool compressed = desc.format >= PixelFormat::BC1;
+        ENGINE_CORE_ASSERT(data.desc.mipLevels == 1 || data.desc.usage == TextureUsageFlags(TextureUsage::Sampled), "Null: NullGraphicsDevice: mipmapped textures can only be sampled!");
+        ENGINE_CORE_ASSERT(!compressed || data.desc.usage == TextureUsageFlags(TextureUsage::Sampled), "Null: NullGraphicsDevice: compressed textures can only be sampled!");
+        ENGINE_CORE_ASSERT(data.desc.mipLevels <= static_cast<uint32_t>(std::bit_width(std::max(desc.width, desc.height))), "Null: NullGraphicsDevice: more mip levels than the chain has!");
+
+        bool depth = desc.format == PixelFormat::Depth32 || desc.format == PixelFormat::Depth24Stencil8;
+        ENGINE_CORE_ASSERT(depth == desc.usage.Has(TextureUsage::DepthStencil), "Null: NullGraphicsDevice: depth formats and TextureUsage::DepthStencil go together!");
+
+        return data;
+    }
+
+    TextureHandle NullGraphicsDevice::CreateTexture(const TextureDesc& desc)
+    {
+        uint32_t id = TextureHandle::AllocateID();
+        m_Textures[id] = CreateTextureData(desc);
+        return TextureHandle{ .id = id };
+    }
+
+    MemoryRequirements NullGraphicsDevice::GetTextureMemoryRequirements(const TextureDesc& desc)
+    {
+        NullTextureData data = CreateTextureData(desc);
+
+        size_t size = 0;
+        for(uint32_t level = 0; level < data.desc.mipLevels; level++)
+            size += GetMipSize(data.desc, level);
+
+        return MemoryRequirements{
+            .size           = (size + k_TextureAlignment - 1) / k_TextureAlignment * k_TextureAlignment,
+            .alignment      = k_TextureAlignment,
+            .memoryTypeBits = k_MemoryTypeBits
+        };
+    }
+
+    HeapHandle NullGraphicsDevice::CreateHeap(const HeapDesc& desc)
+    {
+        ENGINE_CORE_ASSERT(desc.size > 0, "Null: NullGraphicsDevice: CreateHeap(): size is 0!");
+        ENGINE_CORE_ASSERT(desc.memoryTypeBits & k_MemoryTypeBits, "Null: NullGraphicsDevice: CreateHeap(): no supported memory type!");
+
+        uint32_t id = HeapHandle::AllocateID();
+        m_Heaps[id].desc = desc;
+        return HeapHandle{ .id = id };
+    }
+
+    TextureHandle NullGraphicsDevice::CreatePlacedTexture(const TextureDesc& desc, HeapHandle heap, size_t offset)
+    {
+        ENGINE_CORE_ASSERT(heap.IsValid(), "Null: NullGraphicsDevice: CreatePlacedTexture(): heap is invalid!");
+        auto it = m_Heaps.find(heap.id);
+        ENGINE_CORE_ASSERT(it != m_Heaps.end(), "Null: NullGraphicsDevice: CreatePlacedTexture(): heap is not found!");
+
+        MemoryRequirements requirements = GetTextureMemoryRequirements(desc);
+        ENGINE_CORE_ASSERT(offset % requirements.alignment == 0, "Null: NullGraphicsDevice: CreatePlacedTexture(): offset is not aligned!");
+        ENGINE_CORE_ASSERT(offset + requirements.size <= it->second.desc.size, "Null: NullGraphicsDevice: CreatePlacedTexture(): texture doesn't fit in the heap!");
+
+        uint32_t id = TextureHandle::AllocateID();
+        NullTextureData& data = m_Textures[id];
+        data = CreateTextureData(desc);
+        data.heap = heap.id;
+        it->second.placedTextures++;
+
+        return TextureHandle{ .id = id };
+    }
+
+    ShaderHandle NullGraphicsDevice::CreateShader(const ShaderDesc& desc)
+    {
+        ENGINE_CORE_ASSERT(!desc.modules.empty(), "Null: NullGraphicsDevice: CreateShader(): shader has no modules!");
+
+        uint32_t id = ShaderHandle::AllocateID();
+        NullShaderData& data = m_Shaders[id];
+
+        for(const ShaderModule& mod : desc.modules)
+        {
+            ENGINE_CORE_ASSERT(!mod.spirv.empty(), "Null: NullGraphicsDevice: CreateShader(): module has no SPIR-V!");
+
+            for(auto const& [stage, entryPoint] : mod.entryPoints)
+            {
+                if(stage == ShaderStage::Compute)
+                    data.compute = true;
+                else
+                    data.graphics = true;
+            }
+        }
+
+        return ShaderHandle{ .id = id };
+    }
+
+    void NullGraphicsDevice::ValidateBindings(const std::vector<UniformBinding>& uniformBindings, const std::vector<PushConstantRange>& pushConstantRanges)
+    {
+        uint32_t bindings = 0;
+        for(const UniformBinding& ub : uniformBindings)
+        {
+            ENGINE_CORE_ASSERT(ub.binding < k_MaxBindings, "Null: NullGraphicsDevice: uniform binding exceeds k_MaxBindings!");
+            ENGINE_CORE_ASSERT(!(bindings & (1u << ub.binding)), "Null: NullGraphicsDevice: uniform binding is declared twice!");
+            bindings |= 1u << ub.binding;
+        }
+
+        for(const PushConstantRange& pc : pushConstantRanges)
+        {
+            ENGINE_CORE_ASSERT(pc.size > 0 && pc.offset % 4 == 0 && pc.size % 4 == 0, "Null: NullGraphicsDevice: push constant offset and size must be non-zero multiples of 4!");
+            ENGINE_CORE_ASSERT(pc.offset + pc.size <= k_MaxPushConstants, "Null: NullGraphicsDevice: push constant range exceeds the guaranteed 128 bytes!");
+        }
+    }
+
+    PipelineHandle NullGraphicsDevice::CreatePipeline(const PipelineDesc& desc)
+    {
+        // Return existing pipeline if an identical one was already created
+        auto existing = m_PipelineLookup.find(desc);
+        if(existing != m_PipelineLookup.end())
+        {
+            m_Pipelines.at(existing->second).refCount++;
+            return PipelineHandle{ .id = existing->second };
+        }
+
+        ENGINE_CORE_ASSERT(desc.shader.IsValid() && m_Shaders.contains(desc.shader.id), "Null: NullGraphicsDevice: CreatePipeline(): shader is not found!");
+        ENGINE_CORE_ASSERT(m_Shaders[desc.shader.id].graphics, "Null: NullGraphicsDevice: CreatePipeline(): shader has no graphics entry points!");
+        ENGINE_CORE_ASSERT(!desc.primitiveRestart || desc.topology == PrimitiveTopology::LineStrip || desc.topology == PrimitiveTopology::TriangleStrip, "Null: NullGraphicsDevice: CreatePipeline(): primitiveRestart needs a strip topology!");
+        ValidateBindings(desc.uniformBindings, desc.pushConstantRanges);
+
+        uint32_t id = PipelineHandle::AllocateID();
+        NullPipelineData& data = m_Pipelines[id];
+        data.uniformBindings    = desc.uniformBindings;
+        data.pushConstantRanges = desc.pushConstantRanges;
+
+        m_PipelineLookup[desc] = id;
+
+        return PipelineHandle{ .id = id };
+    }
+
+    PipelineHandle NullGraphicsDevice::CreatePipelineAsync(const PipelineDesc& desc)
+    {
+        return CreatePipeline(desc);
+    }
+
+    bool NullGraphicsDevice::IsPipelineReady(PipelineHandle pipeline)
+    {
+        GetPipelineData(pipeline);
+        return true;
+    }
+
+    PipelineHandle NullGraphicsDevice::CreateComputePipeline(const ComputePipelineDesc& desc)
+    {
+        // Return existing pipeline if an identical one was already created
+        auto existing = m_ComputePipelineLookup.find(desc);
+        if(existing != m_ComputePipelineLookup.end())
+        {
+            m_Pipelines.at(existing->second).refCount++;
+            return PipelineHandle{ .id = existing->second };
+        }
+
+        ENGINE_CORE_ASSERT(desc.shader.IsValid() && m_Shaders.contains(desc.shader.id), "Null: NullGraphicsDevice: CreateComputePipeline(): shader is not found!");
+        ENGINE_CORE_ASSERT(m_Shaders[desc.shader.id].compute, "Null: NullGraphicsDevice: CreateComputePipeline(): shader has no compute entry point!");
+        ValidateBindings(desc.uniformBindings, desc.pushConstantRanges);
+
+        uint32_t id = PipelineHandle::AllocateID();
+        NullPipelineData& data = m_Pipelines[id];
+        data.compute            = true;
+        data.uniformBindings    = desc.uniformBindings;
+        data.pushConstantRanges = desc.pushConstantRanges;
+
+        m_ComputePipelineLookup[desc] = id;
+
+        return PipelineHandle{ .id = id };
+    }
+
+    SwapChainHandle NullGraphicsDevice::CreateSwapChain(const SwapChainDesc& desc)
+    {
+        uint32_t id = SwapChainHandle::AllocateID();
+        NullSwapChainData& data = m_SwapChains[id];
+        data.desc = desc;
+
+        // Windows provide their size, offscreen swapchains need one
+        if(desc.window != nullptr)
+        {
+            data.width  = desc.window->GetWidth();
+            data.height = desc.window->GetHeight();
+        }
+        else
+        {
+            ENGINE_CORE_ASSERT(desc.width > 0 && desc.height > 0, "Null: NullGraphicsDevice: CreateSwapChain(): offscreen swapchains need a size!");
+            data.width  = desc.width;
+            data.height = desc.height;
+        }
+
+        return SwapChainHandle{ .id = id };
+    }
+
+    // Command bundles
+    ICommandBundle* NullGraphicsDevice::CreateCommandBundle(const CommandBundleDesc& desc)
+    {
+        uint32_t id = m_NextCommandBundleID++;
+        Scope<NullCommandBundle>& bundle = m_CommandBundles[id];
+        bundle = CreateScope<NullCommandBundle>(*this, id, desc);
+        return bundle.get();
+    }
+
+    void NullGraphicsDevice::DestroyCommandBundle(ICommandBundle*& bundle)
+    {
+        if(bundle != nullptr)
+        {
+            m_CommandBundles.erase(static_cast<NullCommandBundle*>(bundle)->GetID());
+        }
+        bundle = nullptr;
+    }
+
+    // Resource destruction
+    void NullGraphicsDevice::DestroyBuffer(BufferHandle& buffer)
+    {
+        if(buffer.IsValid())
+        {
+            size_t erased = m_Buffers.erase(buffer.id);
+            ENGINE_CORE_ASSERT(erased == 1, "Null: NullGraphicsDevice: DestroyBuffer(): buffer is not found!");
+
+            for(auto& [id, bundle] : m_CommandBundles)
+                bundle->OnBufferDestroyed(buffer.id);
+        }
+        buffer.id = 0;
+    }
+
+    void NullGraphicsDevice::DestroyTexture(TextureHandle& texture)
+    {
+        if(texture.IsValid())
+        {
+            NullTextureData& data = GetTextureData(texture);
+            if(auto heap = m_Heaps.find(data.heap); heap != m_Heaps.end())
+                heap->second.placedTextures--;
+            m_Textures.erase(texture.id);
+
+            for(auto& [id, bundle] : m_CommandBundles)
+                bundle->OnTextureDestroyed(texture.id);
+        }
+        texture.id = 0;
+    }
+
+    void NullGraphicsDevice::DestroyShader(ShaderHandle& shader)
+    {
+        if(shader.IsValid())
+        {
+            size_t erased = m_Shaders.erase(shader.id);
+            ENGINE_CORE_ASSERT(erased == 1, "Null: NullGraphicsDevice: DestroyShader(): shader is not found!");
+        }
+        shader.id = 0;
+    }
+
+    void NullGraphicsDevice::DestroyPipeline(PipelineHandle& pipeline)
+    {
+        if(pipeline.IsValid())
+        {
+            // Pipelines are shared between identical descs, only destroy once the last user is gone
+            NullPipelineData& data = GetPipelineData(pipeline);
+            if(--data.refCount == 0)
+            {
+                if(data.compute)
+                    std::erase_if(m_ComputePipelineLookup, [&](const auto& entry) { return entry.second == pipeline.id; });
+                else
+                    std::erase_if(m_PipelineLookup, [&](const auto& entry) { return entry.second == pipeline.id; });
+
+                for(auto& [id, bundle] : m_CommandBundles)
+                    bundle->OnPipelineDestroyed(pipeline.id);
+
+                m_Pipelines.erase(pipeline.id);
+            }
+        }
+        pipeline.id = 0;
+    }
+
+    void NullGraphicsDevice::DestroyHeap(HeapHandle& heap)
+    {
+        if(heap.IsValid())
+        {
+            auto it = m_Heaps.find(heap.id);
+            ENGINE_CORE_ASSERT(it != m_Heaps.end(), "Null: NullGraphicsDevice: DestroyHeap(): heap is not found!");
+            ENGINE_CORE_ASSERT(it == m_Heaps.end() || it->second.placedTextures == 0, "Null: NullGraphicsDevice: DestroyHeap(): textures are still placed in the heap!");
+            m_Heaps.erase(heap.id);
+        }
+        heap.id = 0;
+    }
+
+    void NullGraphicsDevice::DestroySwapChain(SwapChainHandle& swapchain)
+    {
+        if(swapchain.IsValid())
+        {
+            size_t erased = m_SwapChains.erase(swapchain.id);
+            ENGINE_CORE_ASSERT(erased == 1, "Null: NullGraphicsDevice: DestroySwapChain(): swapchain is not found!");
+
+            for(auto& [id, bundle] : m_CommandBundles)
+                bundle->OnSwapChainDestroyed(swapchain.id);
+        }
+        swapchain.id = 0;
+    }
+
+    BufferHandle NullGraphicsDevice::GetQuadIndexBuffer(uint32_t quadCount)
+    {
+        if(m_QuadIndexBuffer.IsValid() && quadCount <= m_QuadIndexCapacity)
+            return m_QuadIndexBuffer;
+
+        ENGINE_CORE_ASSERT(!m_InImmediatePass, "Null: NullGraphicsDevice: GetQuadIndexBuffer(): can't grow inside an immediate pass!");
+
+        // Same limits as the Vulkan device
+        static constexpr uint32_t k_MinQuadIndexCapacity = 1024;
+        static constexpr uint32_t k_MaxQuadIndexCapacity = 1 << 23;
+        ENGINE_CORE_ASSERT(quadCount <= k_MaxQuadIndexCapacity, "Null: NullGraphicsDevice: GetQuadIndexBuffer(): quadCount exceeds k_MaxQuadIndexCapacity!");
+
+        uint32_t capacity = std::bit_ceil(std::max(quadCount, k_MinQuadIndexCapacity));
+
+        BufferHandle buffer = CreateBuffer(BufferDesc{
+            .size        = static_cast<size_t>(capacity) * 6 * sizeof(uint32_t),
+            .type        = BufferType::Index,
+            .usage       = BufferUsage::Static,
+            .indexFormat = IndexFormat::Uint32
+        });
+
+        DestroyBuffer(m_QuadIndexBuffer);
+        m_QuadIndexBuffer   = buffer;
+        m_QuadIndexCapacity = capacity;
+        return buffer;
+    }
+
+    // Frame pacing
+    void NullGraphicsDevice::BeginFrame()
+    {
+        ENGINE_CORE_ASSERT(!m_InFrame, "Null: NullGraphicsDevice: BeginFrame(): previous frame was never ended!");
+        m_InFrame = true;
+    }
+
+    void NullGraphicsDevice::EndFrame()
+    {
+        ENGINE_CORE_ASSERT(m_InFrame, "Null: NullGraphicsDevice: EndFrame(): frame was never begun!");
+
+        std::lock_guard<std::mutex> lock(m_PassMutex);
+        ENGINE_CORE_ASSERT(m_ActiveCommandBuffers.empty(), "Null: NullGraphicsDevice: EndFrame(): a pass was begun but never ended!");
+
+        // Publish counters
+        m_CommandCounters = m_FrameCounters;
+        m_FrameCounters   = {};
+
+        // The frame is complete as soon as it ends
+        m_FrameNumber++;
+        m_FrameIndex = (m_FrameIndex + 1) % m_Desc.framesInFlight;
+        m_InFrame = false;
+    }
+
+    void NullGraphicsDevice::SetMemoryBudgetCallback(std::function<void(const MemoryStats&)> callback)
+    {
+        m_MemoryBudgetCallback = std::move(callback);
+    }
+
+    // Render passes
+    NullCommandBuffer* NullGraphicsDevice::AcquireCommandBuffer()
+    {
+        // Caller holds m_PassMutex
+        if(m_FreeCommandBuffers.empty())
+        {
+            m_ActiveCommandBuffers.push_back(CreateScope<NullCommandBuffer>(*this));
+        }
+        else
+        {
+            m_ActiveCommandBuffers.push_back(std::move(m_FreeCommandBuffers.back()));
+            m_FreeCommandBuffers.pop_back();
+        }
+
+        NullCommandBuffer* cmd = m_ActiveCommandBuffers.back().get();
+        cmd->Reset();
+        return cmd;
+    }
+
+    ICommandBuffer* NullGraphicsDevice::BeginPass(SwapChainHandle renderTarget, Vec4 clearColor, TextureHandle depthBuffer)
+    {
+        RenderPassDesc desc;
+        desc.colorAttachments.push_back({ .swapChain = renderTarget, .clearColor = clearColor });
+        desc.depthAttachment.texture = depthBuffer;
+        return BeginPass(desc);
+    }
+
+    ICommandBuffer* NullGraphicsDevice::BeginPass(const RenderPassDesc& desc)
+    {
+        ENGINE_CORE_ASSERT(m_InFrame, "Null: NullGraphicsDevice: BeginPass(): not between BeginFrame() and EndFrame()!");
+        ENGINE_CORE_ASSERT(!desc.colorAttachments.empty() || desc.depthAttachment.texture.IsValid(), "Null: NullGraphicsDevice: BeginPass(): pass has no attachments!");
+
+        // Resolve attachments
+        SwapChainHandle swapChain;
+        for(const ColorAttachment& attachment : desc.colorAttachments)
+        {
+            ENGINE_CORE_ASSERT(attachment.swapChain.IsValid() != attachment.texture.IsValid(), "Null: NullGraphicsDevice: BeginPass(): a color attachment needs either a texture or a swapchain!");
+
+            if(attachment.swapChain.IsValid())
+            {
+                ENGINE_CORE_ASSERT(!swapChain.IsValid(), "Null: NullGraphicsDevice: BeginPass(): a pass can only render to one swapchain!");
+                swapChain = attachment.swapChain;
+            }
+            else
+            {
+                NullTextureData& tdata = GetTextureData(attachment.texture);
+                ENGINE_CORE_ASSERT(tdata.desc.usage.Has(TextureUsage::RenderTarget), "Null: NullGraphicsDevice: BeginPass(): color attachment was not created with TextureUsage::RenderTarget!");
+                tdata.written = true;
+            }
+        }
+
+        if(desc.depthAttachment.texture.IsValid())
+        {
+            NullTextureData& tdata = GetTextureData(desc.depthAttachment.texture);
+            ENGINE_CORE_ASSERT(tdata.desc.usage.Has(TextureUsage::DepthStencil), "Null: NullGraphicsDevice: BeginPass(): depth attachment was not created with TextureUsage::DepthStencil!");
+            tdata.written = true;
+        }
+
+        for(const TextureBarrier& barrier : desc.barriers)
+            GetTextureData(barrier.texture);
+
+        std::lock_guard<std::mutex> lock(m_PassMutex);
+
+        // Minimized windows can't be rendered to
+        if(swapChain.IsValid())
+        {
+            NullSwapChainData& sc = GetSwapChainData(swapChain);
+            if(sc.width == 0 || sc.height == 0)
+                return nullptr;
+        }
+
+        NullCommandBuffer* cmd = AcquireCommandBuffer();
+        cmd->BeginRendering(swapChain, desc.depthAttachment.texture, static_cast<uint32_t>(desc.colorAttachments.size()));
+        return cmd;
+    }
+
+    void NullGraphicsDevice::EndPass(ICommandBuffer* cmd)
+    {
+        ENGINE_ASSERT(cmd != nullptr, "Null: NullGraphicsDevice: EndPass(): cmd is nullptr!");
+
+        NullCommandBuffer* ncmd = static_cast<NullCommandBuffer*>(cmd);
+        if(ncmd->IsComputePass())
+        {
+            ncmd->EndCompute();
+        }
+        else
+        {
+            ncmd->EndRendering();
+        }
+
+        std::lock_guard<std::mutex> lock(m_PassMutex);
+        m_FrameCounters += ncmd->GetCounters();
+        m_FrameCounters.passes++;
+
+        // Return it to the pool
+        auto it = std::ranges::find_if(m_ActiveCommandBuffers, [&](const Scope<NullCommandBuffer>& active) { return active.get() == ncmd; });
+        ENGINE_CORE_ASSERT(it != m_ActiveCommandBuffers.end(), "Null: NullGraphicsDevice: EndPass(): cmd is not an active pass!");
+        if(it != m_ActiveCommandBuffers.end())
+        {
+            m_FreeCommandBuffers.push_back(std::move(*it));
+            m_ActiveCommandBuffers.erase(it);
+        }
+    }
+
+    ICommandBuffer* NullGraphicsDevice::BeginComputePass(const std::vector<TextureBarrier>& barriers, const std::string& name)
+    {
+        ENGINE_CORE_ASSERT(m_InFrame, "Null: NullGraphicsDevice: BeginComputePass(): not between BeginFrame() and EndFrame()!");
+
+        for(const TextureBarrier& barrier : barriers)
+        {
+            NullTextureData& tdata = GetTextureData(barrier.texture);
+            ENGINE_CORE_ASSERT(barrier.after != ResourceState::Storage || tdata.desc.usage.Has(TextureUsage::Storage), "Null: NullGraphicsDevice: BeginComputePass(): barrier moves a texture without TextureUsage::Storage to Storage!");
+        }
+
+        std::lock_guard<std::mutex> lock(m_PassMutex);
+        NullCommandBuffer* cmd = AcquireCommandBuffer();
+        cmd->BeginCompute();
+        return cmd;
+    }
+
+    // Readback
+    ReadbackTicket NullGraphicsDevice::AddReadback(size_t size)
+    {
+        ENGINE_CORE_ASSERT(m_InFrame, "Null: NullGraphicsDevice: RequestReadback(): not between BeginFrame() and EndFrame()!");
+
+        ReadbackTicket ticket{ .id = ReadbackTicket::AllocateID() };
+        m_Readbacks[ticket.id] = NullReadback{ .size = size, .frame = m_FrameNumber + 1 };
+
+        std::lock_guard<std::mutex> lock(m_PassMutex);
+        m_FrameCounters.readbacks++;
+
+        return ticket;
+    }
+
+    ReadbackTicket NullGraphicsDevice::RequestReadback(TextureHandle texture, const TextureRegion& region)
+    {
+        NullTextureData& tdata = GetTextureData(texture);
+        ENGINE_CORE_ASSERT(tdata.desc.format < PixelFormat::BC1, "Null: NullGraphicsDevice: RequestReadback(): compressed textures can't be read back!");
+        ENGINE_CORE_ASSERT(region.mipLevel < tdata.desc.mipLevels, "Null: NullGraphicsDevice: RequestReadback(): mip level is out of range!");
+        ENGINE_CORE_ASSERT(tdata.written, "Null: NullGraphicsDevice: RequestReadback(): texture was never written!");
+
+        uint32_t levelWidth  = std::max(1u, tdata.desc.width >> region.mipLevel);
+        uint32_t levelHeight = std::max(1u, tdata.desc.height >> region.mipLevel);
+        ENGINE_CORE_ASSERT(region.x < levelWidth && region.y < levelHeight, "Null: NullGraphicsDevice: RequestReadback(): region is out of bounds!");
+        uint32_t width  = region.width  != 0 ? region.width  : levelWidth - region.x;
+        uint32_t height = region.height != 0 ? region.height : levelHeight - region.y;
+        ENGINE_CORE_ASSERT(width <= levelWidth - region.x && height <= levelHeight - region.y, "Null: NullGraphicsDevice: RequestReadback(): region is out of bounds!");
+
+        return AddReadback(static_cast<size_t>(width) * height * GetPixelSize(tdata.desc.format));
+    }
+
+    ReadbackTicket NullGraphicsDevice::RequestReadback(SwapChainHandle swapChain, const TextureRegion& region)
+    {
+        NullSwapChainData& sc = GetSwapChainData(swapChain);
+        ENGINE_CORE_ASSERT(sc.desc.window == nullptr, "Null: NullGraphicsDevice: RequestReadback(): only offscreen swapchains can be read back!");
+        ENGINE_CORE_ASSERT(region.mipLevel == 0, "Null: NullGraphicsDevice: RequestReadback(): swapchains have no mips!");
+
+        ENGINE_CORE_ASSERT(region.x < sc.width && region.y < sc.height, "Null: NullGraphicsDevice: RequestReadback(): region is out of bounds!");
+        uint32_t width  = region.width  != 0 ? region.width  : sc.width - region.x;
+        uint32_t height = region.height != 0 ? region.height : sc.height - region.y;
+        ENGINE_CORE_ASSERT(width <= sc.width - region.x && height <= sc.height - region.y, "Null: NullGraphicsDevice: RequestReadback(): region is out of bounds!");
+
+        return AddReadback(static_cast<size_t>(width) * height * GetPixelSize(sc.desc.format));
+    }
+
+    ReadbackTicket NullGraphicsDevice::RequestReadback(BufferHandle buffer, const BufferRegion& region)
+    {
+        const BufferDesc& bdesc = GetBufferDesc(buffer);
+        ENGINE_CORE_ASSERT(bdesc.usage == BufferUsage::Static, "Null: NullGraphicsDevice: RequestReadback(): only static buffers can be read back!");
+
+        ENGINE_CORE_ASSERT(region.offset < bdesc.size, "Null: NullGraphicsDevice: RequestReadback(): region is out of bounds!");
+        size_t size = region.size != 0 ? region.size : bdesc.size - region.offset;
+        ENGINE_CORE_ASSERT(size <= bdesc.size - region.offset, "Null: NullGraphicsDevice: RequestReadback(): region is out of bounds!");
+
+        return AddReadback(size);
+    }
+
+    bool NullGraphicsDevice::PollReadback(ReadbackTicket& ticket, std::vector<char>& data)
+    {
+        ENGINE_CORE_ASSERT(ticket.IsValid(), "Null: NullGraphicsDevice: PollReadback(): ticket is invalid!");
+
+        auto it = m_Readbacks.find(ticket.id);
+        ENGINE_CORE_ASSERT(it != m_Readbacks.end(), "Null: NullGraphicsDevice: PollReadback(): ticket is not found!");
+        if(it == m_Readbacks.end() || it->second.frame > m_FrameNumber)
+            return false;
+
+        // Nothing was rendered, the contents are zeros
+        data.assign(it->second.size, 0);
+        m_Readbacks.erase(it);
+
+        ticket.id = 0;
+        return true;
+    }
+
+    void NullGraphicsDevice::CancelReadback(ReadbackTicket& ticket)
+    {
+        if(ticket.IsValid())
+            m_Readbacks.erase(ticket.id);
+        ticket.id = 0;
+    }
+
+    // Immediate command buffer
+    ICommandBuffer* NullGraphicsDevice::BeginImmediate()
+    {
+        ENGINE_CORE_ASSERT(m_InImmediatePass == false, "Null: NullGraphicsDevice: BeginImmediate(): already in immediate pass!");
+        m_ImmediateCommandBuffer->Reset();
+        m_InImmediatePass = true;
+        return m_ImmediateCommandBuffer.get();
+    }
+
+    void NullGraphicsDevice::EndImmediate(ICommandBuffer* cmd)
+    {
+        ENGINE_ASSERT(cmd != nullptr, "Null: NullGraphicsDevice: EndImmediate(): cmd is nullptr!");
+        ENGINE_CORE_ASSERT(cmd == m_ImmediateCommandBuffer.get(), "Null: NullGraphicsDevice: EndImmediate(): cmd is not immediate command buffer!");
+        ENGINE_CORE_ASSERT(m_InImmediatePass != false, "Null: NullGraphicsDevice: EndImmediate(): not in immediate pass!");
+        ENGINE_CORE_ASSERT(m_ImmediateCommandBuffer->m_MarkerDepth == 0, "Null: NullGraphicsDevice: EndImmediate(): ended with open markers!");
+
+        {
+            std::lock_guard<std::mutex> lock(m_PassMutex);
+            m_FrameCounters += m_ImmediateCommandBuffer->GetCounters();
+        }
+
+        m_ImmediateCommandBuffer->Reset();
+        m_InImmediatePass = false;
+    }
+
+    // Swapchain configuration
+    void NullGraphicsDevice::ResizeSwapChain(SwapChainHandle swapchain, uint32_t width, uint32_t height)
+    {
+        NullSwapChainData& sc = GetSwapChainData(swapchain);
+        sc.width  = width;
+        sc.height = height;
+    }
+
+    void NullGraphicsDevice::SetSwapChainPresentMode(SwapChainHandle swapchain, PresentMode mode)
+    {
+        GetSwapChainData(swapchain).desc.presentation = mode;
+    }
+
+    // Destroy
+    void NullGraphicsDevice::OnDestroy()
+    {
+        ENGINE_CORE_ASSERT(!m_InFrame, "Null: NullGraphicsDevice: OnDestroy(): a frame is still being recorded!");
+
+        m_CommandBundles.clear();
+        m_Readbacks.clear();
+    }
+
+    // Resources
+    const BufferDesc& NullGraphicsDevice::GetBufferDesc(BufferHandle buffer)
+    {
+        ENGINE_CORE_ASSERT(buffer.IsValid(), "Null: NullGraphicsDevice: GetBufferDesc: buffer is invalid!");
+
+        auto it = m_Buffers.find(buffer.id);
+        ENGINE_ASSERT(it != m_Buffers.end(), "Null: NullGraphicsDevice: GetBufferDesc: buffer is not found!");
+
+        return it->second;
+    }
+
+    NullTextureData& NullGraphicsDevice::GetTextureData(TextureHandle texture)
+    {
+        ENGINE_CORE_ASSERT(texture.IsValid(), "Null: NullGraphicsDevice: GetTextureData: texture is invalid!");
+
+        auto it = m_Textures.find(texture.id);
+        ENGINE_ASSERT(it != m_Textures.end(), "Null: NullGraphicsDevice: GetTextureData: texture is not found!");
+
+        return it->second;
+    }
+
+    NullPipelineData& NullGraphicsDevice::GetPipelineData(PipelineHandle pipeline)
+    {
+        ENGINE_CORE_ASSERT(pipeline.IsValid(), "Null: NullGraphicsDevice: GetPipelineData: pipeline is invalid!");
+
+        auto it = m_Pipelines.find(pipeline.id);
+        ENGINE_ASSERT(it != m_Pipelines.end(), "Null: NullGraphicsDevice: GetPipelineData: pipeline is not found!");
+
+        return it->second;
+    }
+
+    NullSwapChainData& NullGraphicsDevice::GetSwapChainData(SwapChainHandle swapchain)
+    {
+        ENGINE_CORE_ASSERT(swapchain.IsValid(), "Null: NullGraphicsDevice: GetSwapChainData: swapchain is invalid!");
+
+        auto it = m_SwapChains.find(swapchain.id);
+        ENGINE_ASSERT(it != m_SwapChains.end(), "Null: NullGraphicsDevice: GetSwapChainData: swapchain is not found!");
+
+        return it->second;
+    }
+} // namespace Engine::RHI::Null
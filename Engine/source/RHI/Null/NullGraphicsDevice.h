@@ -0,0 +1,205 @@
+#ifndef RHI_NULL_NULLGRAPHICSDEVICE
+#define RHI_NULL_NULLGRAPHICSDEVICE
+
+#include "engine_export.h"
+
+#include "Engine/Core/Base.h"
+
+#include "Engine/RHI/IGraphicsDevice.h"
+#include "Engine/RHI/RHIHash.h"
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine::RHI::Null
+{
+    // Forward
+    class NullCommandBuffer;
+    class NullCommandBundle;
+
+    // Resource bookkeeping. Only what validation needs is kept, nothing is allocated
+    struct NullTextureData {
+        TextureDesc desc;           // mipLevels resolved
+        uint32_t    heap    = 0;    // Heap of a placed texture
+        bool        written = false; // Uploaded, rendered to or bound for storage writes
+    };
+
+    struct NullShaderData {
+        bool graphics = false; // Has a vertex or fragment entry point
+        bool compute  = false;
+    };
+
+    struct NullPipelineData {
+        bool                           compute = false;
+        std::vector<UniformBinding>    uniformBindings;
+        std::vector<PushConstantRange> pushConstantRanges;
+        uint32_t                       refCount = 1; // Identical descs share a pipeline
+    };
+
+    struct NullSwapChainData {
+        SwapChainDesc desc;
+        uint32_t      width  = 0;
+        uint32_t      height = 0;
+    };
+
+    struct NullHeapData {
+        HeapDesc desc;
+        uint32_t placedTextures = 0;
+    };
+
+    // A device that keeps real handles and checks how they are used, but issues no GPU work. For tests and tools on
+    // machines without a GPU. Frames complete in EndFrame(), so readbacks are ready in the next frame and hold zeros.
+    class ENGINE_EXPORT NullGraphicsDevice : public IGraphicsDevice
+    {
+    private:
+        // Config
+        GraphicsDeviceDesc m_Desc;
+        DeviceCapabilities m_Capabilities;
+        GpuFrameTimings    m_GpuTimings; // Always empty
+
+        // Frame pacing
+        bool     m_InFrame        = false;
+        uint64_t m_FrameNumber    = 0; // Frames ended so far, the current frame is m_FrameNumber + 1
+        uint32_t m_FrameIndex     = 0;
+
+        // Passes. Command buffers are pooled and may be recorded on any thread
+        std::vector<Scope<NullCommandBuffer>> m_FreeCommandBuffers;
+        std::vector<Scope<NullCommandBuffer>> m_ActiveCommandBuffers;
+        std::mutex                            m_PassMutex; // Guards the two vectors above and m_FrameCounters
+
+        NullCommandBuffer* AcquireCommandBuffer();
+
+        // Command counters of the frame being recorded and of the last ended frame
+        CommandCounters m_FrameCounters;
+        CommandCounters m_CommandCounters;
+
+        // Memory budget. Never fires, nothing is allocated
+        std::function<void(const MemoryStats&)> m_MemoryBudgetCallback;
+
+        // Readbacks hold their size until the frame they were requested in has ended
+        struct NullReadback {
+            size_t   size  = 0;
+            uint64_t frame = 0;
+        };
+        std::unordered_map<uint32_t, NullReadback> m_Readbacks;
+
+        ReadbackTicket AddReadback(size_t size);
+
+        // Immediate command buffer
+        bool                     m_InImmediatePass = false;
+        Scope<NullCommandBuffer> m_ImmediateCommandBuffer;
+
+        // Resources
+        std::unordered_map<uint32_t, BufferDesc> m_Buffers;
+        std::unordered_map<uint32_t, NullTextureData> m_Textures;
+        std::unordered_map<uint32_t, NullShaderData> m_Shaders;
+        std::unordered_map<uint32_t, NullPipelineData> m_Pipelines;
+        std::unordered_map<uint32_t, NullSwapChainData> m_SwapChains;
+        std::unordered_map<uint32_t, NullHeapData> m_Heaps;
+        std::unordered_map<uint32_t, Scope<NullCommandBundle>> m_CommandBundles;
+        uint32_t m_NextCommandBundleID = 1;
+
+        // Shared quad index buffer
+        BufferHandle m_QuadIndexBuffer;
+        uint32_t     m_QuadIndexCapacity = 0;
+
+        // Deduplication, like the GPU backends
+        std::unordered_map<PipelineDesc, uint32_t> m_PipelineLookup;
+        std::unordered_map<ComputePipelineDesc, uint32_t> m_ComputePipelineLookup;
+
+        NullTextureData CreateTextureData(const TextureDesc& desc);
+        void ValidateBindings(const std::vector<UniformBinding>& uniformBindings, const std::vector<PushConstantRange>& pushConstantRanges);
+
+    public:
+        NullGraphicsDevice(const GraphicsDeviceDesc& desc = {});
+        ~NullGraphicsDevice() override;
+
+        // Resource creation
+        BufferHandle    CreateBuffer(const BufferDesc& desc) override;
+        TextureHandle   CreateTexture(const TextureDesc& desc) override;
+        ShaderHandle    CreateShader(const ShaderDesc& desc) override;
+        PipelineHandle  CreatePipeline(const PipelineDesc& desc) override;
+        SwapChainHandle CreateSwapChain(const SwapChainDesc& desc) override;
+
+        // Background pipeline compilation. Pipelines are ready immediately
+        PipelineHandle  CreatePipelineAsync(const PipelineDesc& desc) override;
+        bool            IsPipelineReady(PipelineHandle pipeline) override;
+
+        PipelineHandle  CreateComputePipeline(const ComputePipelineDesc& desc) override;
+
+        // Heaps and placed textures
+        MemoryRequirements GetTextureMemoryRequirements(const TextureDesc& desc) override;
+        HeapHandle         CreateHeap(const HeapDesc& desc) override;
+        TextureHandle      CreatePlacedTexture(const TextureDesc& desc, HeapHandle heap, size_t offset) override;
+        void               DestroyHeap(HeapHandle& heap) override;
+
+        // Command bundles
+        ICommandBundle* CreateCommandBundle(const CommandBundleDesc& desc) override;
+        void            DestroyCommandBundle(ICommandBundle*& bundle) override;
+
+        // Resource destruction. Nothing is in flight, so resources are freed immediately
+        void DestroyBuffer(BufferHandle& buffer) override;
+        void DestroyTexture(TextureHandle& texture) override;
+        void DestroyShader(ShaderHandle& shader) override;
+        void DestroyPipeline(PipelineHandle& pipeline) override;
+        void DestroySwapChain(SwapChainHandle& swapchain) override;
+
+        // Shared quad indices. Grows like the GPU backends, so handles change at the same points
+        BufferHandle GetQuadIndexBuffer(uint32_t quadCount) override;
+
+        // Frame pacing
+        void BeginFrame() override;
+        void EndFrame() override;
+        void WaitForFrameLatency() override {}
+        uint32_t GetFramesInFlight() const override { return m_Desc.framesInFlight; }
+
+        // Device info. Every optional feature is reported except GPU timing, and every format is supported
+        const DeviceCapabilities& GetCapabilities() const override { return m_Capabilities; }
+        bool IsFormatSupported(PixelFormat format, TextureUsageFlags usage) override { return true; }
+        const GpuFrameTimings& GetGpuTimings() const override { return m_GpuTimings; }
+        const CommandCounters& GetCommandCounters() const override { return m_CommandCounters; }
+
+        // Memory
+        MemoryStats GetMemoryStats() override { return {}; }
+        void SetMemoryBudgetCallback(std::function<void(const MemoryStats&)> callback) override;
+
+        // Render passes
+        ICommandBuffer* BeginPass(SwapChainHandle renderTarget, Vec4 clearColor, TextureHandle depthBuffer = {}) override;
+        ICommandBuffer* BeginPass(const RenderPassDesc& desc) override;
+        void EndPass(ICommandBuffer* cmd) override;
+        ICommandBuffer* BeginComputePass(const std::vector<TextureBarrier>& barriers = {}, const std::string& name = "") override;
+
+        // Readback
+        ReadbackTicket RequestReadback(TextureHandle texture, const TextureRegion& region = {}) override;
+        ReadbackTicket RequestReadback(SwapChainHandle swapChain, const TextureRegion& region = {}) override;
+        ReadbackTicket RequestReadback(BufferHandle buffer, const BufferRegion& region = {}) override;
+        bool           PollReadback(ReadbackTicket& ticket, std::vector<char>& data) override;
+        void           CancelReadback(ReadbackTicket& ticket) override;
+
+        // Immediate command buffer
+        ICommandBuffer* BeginImmediate() override;
+        void EndImmediate(ICommandBuffer* cmd) override;
+
+        // Swapchain configuration
+        void ResizeSwapChain(SwapChainHandle swapchain, uint32_t width, uint32_t height) override;
+        void SetSwapChainPresentMode(SwapChainHandle swapchain, PresentMode mode) override;
+
+        // Destroy
+        void OnDestroy() override;
+
+        // Resources. These assert that the handle is valid
+        const BufferDesc&  GetBufferDesc(BufferHandle buffer);
+        NullTextureData&   GetTextureData(TextureHandle texture);
+        NullPipelineData&  GetPipelineData(PipelineHandle pipeline);
+        NullSwapChainData& GetSwapChainData(SwapChainHandle swapchain);
+        bool               IsInFrame() const { return m_InFrame; }
+
+        // Sizes as the GPU backends lay data out. Compressed formats are measured in 4x4 blocks
+        static size_t GetPixelSize(PixelFormat format);
+        static size_t GetMipSize(const TextureDesc& desc, uint32_t mipLevel);
+    };
+} // namespace Engine::RHI::Null
+
+#endif // RHI_NULL_NULLGRAPHICSDEVICE
@@ -0,0 +1,299 @@
+#include "RHI/PipelineManifest.h"
+#include "Engine/Core/Log.h"
+
+#include <fstream>
+
+namespace Engine::RHI
+{
+    static constexpr uint32_t k_ManifestMagic   = 0x4D504252; // "RBPM"
+    static constexpr uint32_t k_ManifestVersion = 3;
+
+    // Limits for values read back, far above anything a real pipeline uses
+    static constexpr uint32_t k_MaxEntries      = 1 << 16;
+    static constexpr uint32_t k_MaxListLength   = 64;  // Vertex elements, bindings, push constant ranges, color formats
+    static constexpr uint32_t k_MaxStringLength = 256;
+
+    // Binary helpers
+    template<typename T>
+    static void Write(std::ofstream& file, T value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    static void WriteString(std::ofstream& file, const std::string& str)
+    {
+        Write<uint32_t>(file, static_cast<uint32_t>(str.size()));
+        file.write(str.data(), str.size());
+    }
+
+    template<typename T>
+    static T Read(std::ifstream& file)
+    {
+        T value{};
+        file.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+
+    // Enums are stored as uint32_t, last is the highest valid value
+    template<typename E>
+    static bool ReadEnum(std::ifstream& file, E& value, E last)
+    {
+        uint32_t raw = Read<uint32_t>(file);
+        value = static_cast<E>(raw);
+        return file && raw <= static_cast<uint32_t>(last);
+    }
+
+    static bool ReadCount(std::ifstream& file, uint32_t& count, uint32_t max)
+    {
+        count = Read<uint32_t>(file);
+        return file && count <= max;
+    }
+
+    static bool ReadString(std::ifstream& file, std::string& str)
+    {
+        uint32_t size = 0;
+        if(!ReadCount(file, size, k_MaxStringLength))
+            return false;
+
+        str.assign(size, '\0');
+        file.read(str.data(), size);
+        return static_cast<bool>(file);
+    }
+
+    static bool ReadDesc(std::ifstream& file, PipelineDesc& desc)
+    {
+        // Vertex layout
+        uint32_t elementCount = 0;
+        if(!ReadCount(file, elementCount, k_MaxListLength))
+            return false;
+
+        std::vector<VertexElement> elements;
+        for(uint32_t e = 0; e < elementCount; e++)
+        {
+            VertexElementType type;
+            if(!ReadEnum(file, type, VertexElementType::Vec4))
+                return false;
+
+            bool normalized = Read<uint8_t>(file) != 0;
+            std::string name;
+            if(!ReadString(file, name))
+                return false;
+
+            elements.emplace_back(type, name, normalized);
+        }
+        desc.vertexLayout = VertexLayout(elements);
+
+        // Uniform bindings
+        uint32_t bindingCount = 0;
+        if(!ReadCount(file, bindingCount, k_MaxListLength))
+            return false;
+
+        for(uint32_t b = 0; b < bindingCount; b++)
+        {
+            UniformBinding binding;
+            binding.binding = Read<uint32_t>(file);
+            if(!ReadEnum(file, binding.stage, ShaderStage::Compute) || !ReadEnum(file, binding.type, UniformType::StorageTexture))
+                return false;
+
+            desc.uniformBindings.push_back(binding);
+        }
+
+        // Push constants
+        uint32_t rangeCount = 0;
+        if(!ReadCount(file, rangeCount, k_MaxListLength))
+            return false;
+
+        for(uint32_t r = 0; r < rangeCount; r++)
+        {
+            PushConstantRange range;
+            if(!ReadEnum(file, range.stage, ShaderStage::Compute))
+                return false;
+
+            range.offset = Read<uint32_t>(file);
+            range.size   = Read<uint32_t>(file);
+            desc.pushConstantRanges.push_back(range);
+        }
+
+        // Color attachments
+        uint32_t formatCount = 0;
+        if(!ReadCount(file, formatCount, k_MaxListLength))
+            return false;
+
+        for(uint32_t f = 0; f < formatCount; f++)
+        {
+            PixelFormat format;
+            if(!ReadEnum(file, format, PixelFormat::ASTC4x4))
+                return false;
+
+            desc.colorAttachmentFormats.push_back(format);
+        }
+
+        // Fixed function state
+        if(!ReadEnum(file, desc.topology, PrimitiveTopology::TriangleStrip) ||
+           !ReadEnum(file, desc.polygonMode, PolygonMode::Point) ||
+           !ReadEnum(file, desc.cullMode, CullMode::Front) ||
+           !ReadEnum(file, desc.frontFace, FrontFace::CounterClockwise))
+            return false;
+
+        desc.blending   = Read<uint8_t>(file) != 0;
+        desc.depthTest  = Read<uint8_t>(file) != 0;
+        desc.depthWrite = Read<uint8_t>(file) != 0;
+        if(!ReadEnum(file, desc.depthFormat, PixelFormat::ASTC4x4))
+            return false;
+
+        desc.primitiveRestart = Read<uint8_t>(file) != 0;
+        return static_cast<bool>(file);
+    }
+
+    bool PipelineManifest::Load(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if(!file.is_open())
+            return false;
+
+        if(Read<uint32_t>(file) != k_ManifestMagic || Read<uint32_t>(file) != k_ManifestVersion)
+        {
+            LOG_CORE_WARN("PipelineManifest: Ignoring invalid or outdated manifest: {0}", path);
+            return false;
+        }
+
+        m_Entries.clear();
+        m_EntriesByShader.clear();
+
+        // Any bad value means the file can't be trusted, so drop the whole manifest
+        uint32_t count = 0;
+        bool valid = ReadCount(file, count, k_MaxEntries);
+        for(uint32_t i = 0; i < count && valid; i++)
+        {
+            uint64_t shaderHash = Read<uint64_t>(file);
+            PipelineDesc desc;
+            valid = ReadDesc(file, desc);
+            if(valid)
+                FindOrAdd(shaderHash, desc);
+        }
+
+        if(!valid)
+        {
+            m_Entries.clear();
+            m_EntriesByShader.clear();
+            LOG_CORE_WARN("PipelineManifest: Ignoring truncated or corrupt manifest: {0}", path);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool PipelineManifest::Save(const std::string& path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if(!file.is_open())
+        {
+            LOG_CORE_WARN("PipelineManifest: Could not write manifest: {0}", path);
+            return false;
+        }
+
+        Write<uint32_t>(file, k_ManifestMagic);
+        Write<uint32_t>(file, k_ManifestVersion);
+
+        uint32_t count = 0;
+        for(const Entry& entry : m_Entries)
+        {
+            if(entry.recorded)
+                count++;
+        }
+        Write<uint32_t>(file, count);
+
+        for(const Entry& entry : m_Entries)
+        {
+            // Drop entries nothing asked for this session
+            if(!entry.recorded)
+                continue;
+
+            const PipelineDesc& desc = entry.desc;
+            Write<uint64_t>(file, entry.shaderHash);
+
+            // Vertex layout
+            const std::vector<VertexElement>& elements = desc.vertexLayout.GetElements();
+            Write<uint32_t>(file, static_cast<uint32_t>(elements.size()));
+            for(const VertexElement& element : elements)
+            {
+                Write<uint32_t>(file, static_cast<uint32_t>(element.GetType()));
+                Write<uint8_t>(file, element.IsNormalized());
+                WriteString(file, element.GetName());
+            }
+
+            // Uniform bindings
+            Write<uint32_t>(file, static_cast<uint32_t>(desc.uniformBindings.size()));
+            for(const UniformBinding& binding : desc.uniformBindings)
+            {
+                Write<uint32_t>(file, binding.binding);
+                Write<uint32_t>(file, static_cast<uint32_t>(binding.stage));
+                Write<uint32_t>(file, static_cast<uint32_t>(binding.type));
+            }
+
+            // Push constants
+            Write<uint32_t>(file, static_cast<uint32_t>(desc.pushConstantRanges.size()));
+            for(const PushConstantRange& range : desc.pushConstantRanges)
+            {
+                Write<uint32_t>(file, static_cast<uint32_t>(range.stage));
+                Write<uint32_t>(file, range.offset);
+                Write<uint32_t>(file, range.size);
+            }
+
+            // Color attachments
+            Write<uint32_t>(file, static_cast<uint32_t>(desc.colorAttachmentFormats.size()));
+            for(PixelFormat format : desc.colorAttachmentFormats)
+            {
+                Write<uint32_t>(file, static_cast<uint32_t>(format));
+            }
+
+            // Fixed function state
+            Write<uint32_t>(file, static_cast<uint32_t>(desc.topology));
+            Write<uint32_t>(file, static_cast<uint32_t>(desc.polygonMode));
+            Write<uint32_t>(file, static_cast<uint32_t>(desc.cullMode));
+            Write<uint32_t>(file, static_cast<uint32_t>(desc.frontFace));
+            Write<uint8_t>(file, desc.blending);
+            Write<uint8_t>(file, desc.depthTest);
+            Write<uint8_t>(file, desc.depthWrite);
+            Write<uint32_t>(file, static_cast<uint32_t>(desc.depthFormat));
+            Write<uint8_t>(file, desc.primitiveRestart);
+        }
+
+        return true;
+    }
+
+    void PipelineManifest::Record(uint64_t shaderHash, const PipelineDesc& desc)
+    {
+        FindOrAdd(shaderHash, desc).recorded = true;
+    }
+
+    PipelineManifest::Entry& PipelineManifest::FindOrAdd(uint64_t shaderHash, const PipelineDesc& desc)
+    {
+        // Shader handles are per-session
+        PipelineDesc stored = desc;
+        stored.shader = {};
+
+        // Skip duplicates
+        auto [begin, end] = m_EntriesByShader.equal_range(shaderHash);
+        for(auto it = begin; it != end; ++it)
+        {
+            if(m_Entries[it->second].desc == stored)
+                return m_Entries[it->second];
+        }
+
+        m_EntriesByShader.emplace(shaderHash, m_Entries.size());
+        return m_Entries.emplace_back(Entry{ shaderHash, std::move(stored), false });
+    }
+
+    std::vector<PipelineDesc> PipelineManifest::GetDescsForShader(uint64_t shaderHash, ShaderHandle shader) const
+    {
+        std::vector<PipelineDesc> descs;
+        auto [begin, end] = m_EntriesByShader.equal_range(shaderHash);
+        for(auto it = begin; it != end; ++it)
+        {
+            PipelineDesc& desc = descs.emplace_back(m_Entries[it->second].desc);
+            desc.shader = shader;
+        }
+        return descs;
+    }
+} // namespace Engine::RHI
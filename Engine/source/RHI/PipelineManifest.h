@@ -0,0 +1,49 @@
+#ifndef RHI_PIPELINEMANIFEST
+#define RHI_PIPELINEMANIFEST
+
+#include "engine_export.h"
+
+#include "Engine/RHI/RHI.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Engine::RHI
+{
+    // PipelineManifest records every PipelineDesc used during a session so they can be compiled ahead of time
+    // on the next launch. Shader handles are only valid for one session, so each entry refers to its shader
+    // by a hash of the shader's contents instead. The desc's shader handle is ignored when recording.
+    // Only descs recorded this session are saved, so entries for changed or unused shaders age out.
+    class ENGINE_EXPORT PipelineManifest
+    {
+    private:
+        struct Entry {
+            uint64_t     shaderHash;
+            PipelineDesc desc;
+            bool         recorded; // Requested this session, loaded entries start false
+        };
+        std::vector<Entry> m_Entries;
+        std::unordered_multimap<uint64_t, size_t> m_EntriesByShader; // Shader hash -> index into m_Entries
+
+    public:
+        // Returns false if the file does not exist or is not a valid manifest, nothing is loaded then
+        bool Load(const std::string& path);
+        bool Save(const std::string& path) const;
+
+        // Records desc if it is not already in the manifest
+        void Record(uint64_t shaderHash, const PipelineDesc& desc);
+
+        // Returns all recorded descs that use this shader. The returned descs have their shader handle set to shader.
+        std::vector<PipelineDesc> GetDescsForShader(uint64_t shaderHash, ShaderHandle shader) const;
+
+        size_t GetSize() const { return m_Entries.size(); }
+
+    private:
+        Entry& FindOrAdd(uint64_t shaderHash, const PipelineDesc& desc);
+    };
+} // namespace Engine::RHI
+
+
+#endif // RHI_PIPELINEMANIFEST
@@ -0,0 +1,88 @@
+#include "Engine/RHI/RHIHash.h"
+#include "Engine/Core/Base.h"
+
+#include <bit>
+
+namespace Engine::RHI
+{
+    size_t HashVertexLayout(const VertexLayout& layout)
+    {
+        size_t seed = 0;
+        HashCombine(seed, layout.GetStride());
+        for(const VertexElement& element : layout.GetElements())
+        {
+            HashCombine(seed, static_cast<uint64_t>(element.GetType()));
+            HashCombine(seed, element.GetOffset());
+            HashCombine(seed, element.IsNormalized());
+        }
+        return seed;
+    }
+
+    size_t HashUniformBindings(const std::vector<UniformBinding>& bindings)
+    {
+        size_t seed = 0;
+        for(const UniformBinding& binding : bindings)
+        {
+            HashCombine(seed, binding.binding);
+            HashCombine(seed, static_cast<uint64_t>(binding.stage));
+            HashCombine(seed, static_cast<uint64_t>(binding.type));
+        }
+        return seed;
+    }
+
+    size_t HashPushConstantRanges(const std::vector<PushConstantRange>& ranges)
+    {
+        size_t seed = 0;
+        for(const PushConstantRange& range : ranges)
+        {
+            HashCombine(seed, static_cast<uint64_t>(range.stage));
+            HashCombine(seed, range.offset);
+            HashCombine(seed, range.size);
+        }
+        return seed;
+    }
+
+    size_t HashPipelineDesc(const PipelineDesc& desc)
+    {
+        size_t seed = 0;
+        HashCombine(seed, desc.shader.id);
+        HashCombine(seed, HashVertexLayout(desc.vertexLayout));
+        HashCombine(seed, HashUniformBindings(desc.uniformBindings));
+        HashCombine(seed, HashPushConstantRanges(desc.pushConstantRanges));
+        for(PixelFormat format : desc.colorAttachmentFormats)
+        {
+            HashCombine(seed, static_cast<uint64_t>(format));
+        }
+        HashCombine(seed, static_cast<uint64_t>(desc.topology));
+        HashCombine(seed, static_cast<uint64_t>(desc.polygonMode));
+        HashCombine(seed, static_cast<uint64_t>(desc.cullMode));
+        HashCombine(seed, static_cast<uint64_t>(desc.frontFace));
+        HashCombine(seed, desc.blending);
+        HashCombine(seed, desc.depthTest);
+        HashCombine(seed, desc.depthWrite);
+        HashCombine(seed, static_cast<uint64_t>(desc.depthFormat));
+        HashCombine(seed, desc.primitiveRestart);
+        return seed;
+    }
+
+    size_t HashComputePipelineDesc(const ComputePipelineDesc& desc)
+    {
+        size_t seed = 0;
+        HashCombine(seed, desc.shader.id);
+        HashCombine(seed, HashUniformBindings(desc.uniformBindings));
+        HashCombine(seed, HashPushConstantRanges(desc.pushConstantRanges));
+        return seed;
+    }
+
+    size_t HashSamplerDesc(const SamplerDesc& desc)
+    {
+        size_t seed = 0;
+        HashCombine(seed, static_cast<uint64_t>(desc.minFilter));
+        HashCombine(seed, static_cast<uint64_t>(desc.magFilter));
+        HashCombine(seed, static_cast<uint64_t>(desc.mipFilter));
+        HashCombine(seed, static_cast<uint64_t>(desc.addressU));
+        HashCombine(seed, static_cast<uint64_t>(desc.addressV));
+        HashCombine(seed, std::bit_cast<uint32_t>(desc.maxAnisotropy));
+        return seed;
+    }
+} // namespace Engine::RHI
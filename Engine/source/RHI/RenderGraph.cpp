@@ -0,0 +1,494 @@
+#include "Engine/RHI/RenderGraph.h"
+#include "Engine/RHI/IGraphicsDevice.h"
+#include "Engine/RHI/ICommandBuffer.h"
+#include "Engine/Core/Assert.h"
+
+#include <algorithm>
+
+namespace Engine::RHI
+{
+    // ========================================================================
+    // RenderGraphBuilder
+    // ========================================================================
+
+    void RenderGraphBuilder::WriteColor(RenderGraphTexture texture, LoadOp loadOp, Vec4 clearColor)
+    {
+        RenderGraph::Pass& pass = m_Graph.m_Passes[m_Pass];
+        ENGINE_CORE_ASSERT(pass.type == RenderGraphPassType::Graphics, "RenderGraph: WriteColor(): only graphics passes have attachments!");
+
+        m_Graph.AddTextureUse(m_Pass, texture, ResourceState::RenderTarget, true, loadOp != LoadOp::Load);
+
+        ColorAttachment attachment;
+        attachment.loadOp     = loadOp;
+        attachment.clearColor = clearColor;
+        pass.colorAttachments.push_back(attachment);
+        pass.colorTextures.push_back(texture.id - 1);
+    }
+
+    void RenderGraphBuilder::WriteDepth(RenderGraphTexture texture, LoadOp loadOp, float clearDepth)
+    {
+        RenderGraph::Pass& pass = m_Graph.m_Passes[m_Pass];
+        ENGINE_CORE_ASSERT(pass.type == RenderGraphPassType::Graphics, "RenderGraph: WriteDepth(): only graphics passes have attachments!");
+        ENGINE_CORE_ASSERT(pass.depthTexture == ~0u, "RenderGraph: WriteDepth(): pass already has a depth attachment!");
+
+        m_Graph.AddTextureUse(m_Pass, texture, ResourceState::DepthWrite, true, loadOp != LoadOp::Load);
+
+        pass.depthAttachment.loadOp     = loadOp;
+        pass.depthAttachment.clearDepth = clearDepth;
+        pass.depthTexture               = texture.id - 1;
+    }
+
+    void RenderGraphBuilder::ReadTexture(RenderGraphTexture texture)
+    {
+        m_Graph.AddTextureUse(m_Pass, texture, ResourceState::ShaderRead, false, false);
+    }
+
+    void RenderGraphBuilder::ReadWriteTexture(RenderGraphTexture texture)
+    {
+        m_Graph.AddTextureUse(m_Pass, texture, ResourceState::Storage, true, false);
+    }
+
+    void RenderGraphBuilder::ReadBuffer(RenderGraphBuffer buffer)
+    {
+        ENGINE_CORE_ASSERT(buffer.IsValid() && buffer.id <= m_Graph.m_Buffers.size(), "RenderGraph: ReadBuffer(): invalid buffer!");
+        m_Graph.m_Passes[m_Pass].bufferReads.push_back(buffer.id - 1);
+    }
+
+    void RenderGraphBuilder::WriteBuffer(RenderGraphBuffer buffer)
+    {
+        ENGINE_CORE_ASSERT(buffer.IsValid() && buffer.id <= m_Graph.m_Buffers.size(), "RenderGraph: WriteBuffer(): invalid buffer!");
+        m_Graph.m_Passes[m_Pass].bufferWrites.push_back(buffer.id - 1);
+    }
+
+    void RenderGraphBuilder::SideEffect()
+    {
+        m_Graph.m_Passes[m_Pass].sideEffect = true;
+    }
+
+    // ========================================================================
+    // RenderGraphResources
+    // ========================================================================
+
+    TextureHandle RenderGraphResources::GetTexture(RenderGraphTexture texture) const
+    {
+        ENGINE_CORE_ASSERT(texture.IsValid() && texture.id <= m_Graph.m_Textures.size(), "RenderGraph: GetTexture(): invalid texture!");
+        return m_Graph.m_Textures[texture.id - 1].texture;
+    }
+
+    BufferHandle RenderGraphResources::GetBuffer(RenderGraphBuffer buffer) const
+    {
+        ENGINE_CORE_ASSERT(buffer.IsValid() && buffer.id <= m_Graph.m_Buffers.size(), "RenderGraph: GetBuffer(): invalid buffer!");
+        return m_Graph.m_Buffers[buffer.id - 1].buffer;
+    }
+
+    // ========================================================================
+    // RenderGraph
+    // ========================================================================
+
+    RenderGraph::RenderGraph(IGraphicsDevice& device)
+        : m_Device(device)
+    {
+    }
+
+    RenderGraph::~RenderGraph()
+    {
+        ReleaseMemory();
+    }
+
+    RenderGraphTexture RenderGraph::CreateTexture(const std::string& name, const TextureDesc& desc)
+    {
+        ENGINE_CORE_ASSERT(!m_Compiled, "RenderGraph: CreateTexture(): graph is already compiled!");
+
+        TextureResource resource;
+        resource.name = name;
+        resource.kind = ResourceKind::Transient;
+        resource.desc = desc;
+        m_Textures.push_back(resource);
+
+        return RenderGraphTexture{ static_cast<uint32_t>(m_Textures.size()) };
+    }
+
+    RenderGraphTexture RenderGraph::ImportTexture(const std::string& name, TextureHandle texture, ResourceState initialState)
+    {
+        ENGINE_CORE_ASSERT(!m_Compiled, "RenderGraph: ImportTexture(): graph is already compiled!");
+        ENGINE_CORE_ASSERT(texture.IsValid(), "RenderGraph: ImportTexture(): texture is invalid!");
+
+        TextureResource resource;
+        resource.name    = name;
+        resource.kind    = ResourceKind::Imported;
+        resource.texture = texture;
+        resource.state   = m_ImportedStates.try_emplace(texture.id, initialState).first->second;
+        m_Textures.push_back(resource);
+
+        return RenderGraphTexture{ static_cast<uint32_t>(m_Textures.size()) };
+    }
+
+    RenderGraphTexture RenderGraph::ImportSwapChain(const std::string& name, SwapChainHandle swapChain)
+    {
+        ENGINE_CORE_ASSERT(!m_Compiled, "RenderGraph: ImportSwapChain(): graph is already compiled!");
+        ENGINE_CORE_ASSERT(swapChain.IsValid(), "RenderGraph: ImportSwapChain(): swapChain is invalid!");
+
+        TextureResource resource;
+        resource.name      = name;
+        resource.kind      = ResourceKind::SwapChain;
+        resource.swapChain = swapChain;
+        m_Textures.push_back(resource);
+
+        return RenderGraphTexture{ static_cast<uint32_t>(m_Textures.size()) };
+    }
+
+    RenderGraphBuffer RenderGraph::ImportBuffer(const std::string& name, BufferHandle buffer)
+    {
+        ENGINE_CORE_ASSERT(!m_Compiled, "RenderGraph: ImportBuffer(): graph is already compiled!");
+        ENGINE_CORE_ASSERT(buffer.IsValid(), "RenderGraph: ImportBuffer(): buffer is invalid!");
+
+        m_Buffers.push_back({ name, ResourceKind::Imported, buffer });
+        return RenderGraphBuffer{ static_cast<uint32_t>(m_Buffers.size()) };
+    }
+
+    void RenderGraph::AddPass(const std::string& name, RenderGraphPassType type, const SetupCallback& setup, ExecuteCallback execute)
+    {
+        ENGINE_CORE_ASSERT(!m_Compiled, "RenderGraph: AddPass(): graph is already compiled!");
+
+        Pass pass;
+        pass.name    = name;
+        pass.type    = type;
+        pass.execute = std::move(execute);
+        m_Passes.push_back(std::move(pass));
+
+        uint32_t index = static_cast<uint32_t>(m_Passes.size() - 1);
+        RenderGraphBuilder builder(*this, index);
+        setup(builder);
+
+        ENGINE_CORE_ASSERT(type != RenderGraphPassType::Graphics || !m_Passes[index].colorTextures.empty() || m_Passes[index].depthTexture != ~0u,
+            "RenderGraph: AddPass(): graphics pass has no attachments!");
+    }
+
+    RenderGraph::TextureResource& RenderGraph::GetTextureResource(RenderGraphTexture texture)
+    {
+        ENGINE_CORE_ASSERT(texture.IsValid() && texture.id <= m_Textures.size(), "RenderGraph: invalid texture!");
+        return m_Textures[texture.id - 1];
+    }
+
+    void RenderGraph::AddTextureUse(uint32_t pass, RenderGraphTexture texture, ResourceState state, bool write, bool discard)
+    {
+        TextureResource& resource = GetTextureResource(texture);
+        ENGINE_CORE_ASSERT(resource.kind != ResourceKind::SwapChain || state == ResourceState::RenderTarget,
+            "RenderGraph: swapchains can only be written as color attachments!");
+
+        // A texture is in one state for the whole pass
+        std::vector<TextureUse>& uses = m_Passes[pass].textures;
+        auto it = std::ranges::find_if(uses, [&](const TextureUse& use) { return use.texture == texture.id - 1; });
+        if (it != uses.end())
+        {
+            ENGINE_CORE_ASSERT(it->state == state, "RenderGraph: a pass uses a texture in two states!");
+            it->write   = it->write || write;
+            it->discard = it->discard && discard;
+            return;
+        }
+
+        uses.push_back({ texture.id - 1, state, write, discard });
+
+        if (resource.kind == ResourceKind::Transient)
+        {
+            switch (state)
+            {
+                case ResourceState::RenderTarget: resource.desc.usage |= TextureUsage::RenderTarget; break;
+                case ResourceState::DepthWrite:
+                case ResourceState::DepthRead:    resource.desc.usage |= TextureUsage::DepthStencil; break;
+                case ResourceState::ShaderRead:   resource.desc.usage |= TextureUsage::Sampled;      break;
+                case ResourceState::Storage:      resource.desc.usage |= TextureUsage::Storage;      break;
+                default: break;
+            }
+        }
+    }
+
+    void RenderGraph::Compile()
+    {
+        ENGINE_CORE_ASSERT(!m_Compiled, "RenderGraph: Compile(): graph is already compiled!");
+
+        m_Stats = {};
+
+        Cull();
+        PlanMemory();
+        PlanBarriers();
+
+        m_Compiled = true;
+    }
+
+    void RenderGraph::Cull()
+    {
+        // Walk backwards, keeping passes whose writes are needed by a later pass or leave the graph
+        std::vector<bool> textureNeeded(m_Textures.size(), false);
+        std::vector<bool> bufferNeeded(m_Buffers.size(), false);
+
+        for (auto pass = m_Passes.rbegin(); pass != m_Passes.rend(); ++pass)
+        {
+            bool live = pass->sideEffect;
+            for (const TextureUse& use : pass->textures)
+                live = live || (use.write && (m_Textures[use.texture].kind != ResourceKind::Transient || textureNeeded[use.texture]));
+            for (uint32_t buffer : pass->bufferWrites)
+                live = live || m_Buffers[buffer].kind != ResourceKind::Transient || bufferNeeded[buffer];
+
+            pass->culled = !live;
+            if (!live)
+            {
+                m_Stats.culledPasses++;
+                continue;
+            }
+
+            // Writes that discard the contents make earlier writers unnecessary
+            for (const TextureUse& use : pass->textures)
+            {
+                if (use.discard)
+                    textureNeeded[use.texture] = false;
+            }
+
+            for (const TextureUse& use : pass->textures)
+            {
+                if (!use.discard)
+                    textureNeeded[use.texture] = true;
+            }
+
+            for (uint32_t buffer : pass->bufferReads)
+                bufferNeeded[buffer] = true;
+        }
+
+        m_Stats.passes = static_cast<uint32_t>(m_Passes.size()) - m_Stats.culledPasses;
+    }
+
+    void RenderGraph::PlanMemory()
+    {
+        // Lifetime of every transient texture, in pass indices
+        constexpr uint32_t k_Unused = ~0u;
+        std::vector<std::pair<uint32_t, uint32_t>> lifetimes(m_Textures.size(), { k_Unused, 0 });
+        for (uint32_t i = 0; i < m_Passes.size(); i++)
+        {
+            if (m_Passes[i].culled)
+                continue;
+
+            for (const TextureUse& use : m_Passes[i].textures)
+            {
+                auto& [first, last] = lifetimes[use.texture];
+                first = std::min(first, i);
+                last  = std::max(last, i);
+            }
+        }
+
+        MemoryPlan plan;
+        std::vector<uint32_t> transients;
+        std::vector<uint32_t> planIndex(m_Textures.size(), k_Unused);
+        for (uint32_t i = 0; i < m_Textures.size(); i++)
+        {
+            if (m_Textures[i].kind != ResourceKind::Transient)
+                continue;
+
+            planIndex[i] = static_cast<uint32_t>(plan.textures.size());
+            plan.textures.push_back(m_Textures[i].desc);
+            plan.textureHeap.push_back(k_Unused);
+            if (lifetimes[i].first != k_Unused)
+                transients.push_back(i);
+        }
+
+        // Place the largest textures first. A texture shares a heap when it fits and its lifetime doesn't overlap
+        // any texture already in the heap
+        std::vector<MemoryRequirements> requirements(m_Textures.size());
+        for (uint32_t i : transients)
+            requirements[i] = GetMemoryRequirements(m_Textures[i].desc);
+
+        std::ranges::stable_sort(transients, [&](uint32_t a, uint32_t b) { return requirements[a].size > requirements[b].size; });
+
+        std::vector<std::vector<uint32_t>> heapTextures;
+        for (uint32_t i : transients)
+        {
+            const MemoryRequirements& req = requirements[i];
+            m_Stats.unaliasedMemory += req.size;
+
+            auto overlaps = [&](uint32_t other) {
+                return lifetimes[i].first <= lifetimes[other].second && lifetimes[other].first <= lifetimes[i].second;
+            };
+
+            uint32_t heap = 0;
+            for (; heap < plan.heaps.size(); heap++)
+            {
+                const HeapDesc& desc = plan.heaps[heap];
+                if ((desc.memoryTypeBits & req.memoryTypeBits) != 0 && req.size <= desc.size &&
+                    std::ranges::none_of(heapTextures[heap], overlaps))
+                    break;
+            }
+
+            if (heap == plan.heaps.size())
+            {
+                plan.heaps.push_back({ req.size, req.alignment, req.memoryTypeBits });
+                heapTextures.emplace_back();
+            }
+
+            HeapDesc& desc = plan.heaps[heap];
+            desc.alignment      = std::max(desc.alignment, req.alignment);
+            desc.memoryTypeBits = desc.memoryTypeBits & req.memoryTypeBits;
+            heapTextures[heap].push_back(i);
+            plan.textureHeap[planIndex[i]] = heap;
+        }
+
+        for (const HeapDesc& desc : plan.heaps)
+            m_Stats.transientMemory += desc.size;
+
+        // Keep last frame's memory if nothing changed
+        if (plan != m_Plan || m_PlacedTextures.size() != plan.textures.size())
+        {
+            ReleaseMemory();
+
+            for (const HeapDesc& desc : plan.heaps)
+                m_Heaps.push_back(m_Device.CreateHeap(desc));
+
+            for (size_t i = 0; i < plan.textures.size(); i++)
+            {
+                TextureHandle texture;
+                if (plan.textureHeap[i] != k_Unused)
+                    texture = m_Device.CreatePlacedTexture(plan.textures[i], m_Heaps[plan.textureHeap[i]], 0);
+                m_PlacedTextures.push_back(texture);
+            }
+
+            m_Plan = std::move(plan);
+        }
+
+        size_t transient = 0;
+        for (TextureResource& resource : m_Textures)
+        {
+            if (resource.kind == ResourceKind::Transient)
+                resource.texture = m_PlacedTextures[transient++];
+        }
+    }
+
+    void RenderGraph::PlanBarriers()
+    {
+        struct TextureTrack {
+            ResourceState state;
+            bool          written;
+        };
+
+        // Transients start undefined, their memory may have been used by another texture. Imported textures may have
+        // been written outside the graph.
+        std::vector<TextureTrack> tracks(m_Textures.size());
+        for (size_t i = 0; i < m_Textures.size(); i++)
+            tracks[i] = { m_Textures[i].state, m_Textures[i].kind == ResourceKind::Imported };
+
+        for (Pass& pass : m_Passes)
+        {
+            if (pass.culled)
+                continue;
+
+            for (const TextureUse& use : pass.textures)
+            {
+                const TextureResource& resource = m_Textures[use.texture];
+                TextureTrack& track = tracks[use.texture];
+
+                // Swapchain images are transitioned by the device
+                if (resource.kind == ResourceKind::SwapChain)
+                    continue;
+
+                // Reads in the same state need no barrier
+                if (track.state != use.state || track.written || use.write)
+                {
+                    pass.barriers.push_back({
+                        resource.texture,
+                        use.discard ? ResourceState::Undefined : track.state,
+                        use.state
+                    });
+                    m_Stats.barriers++;
+                }
+
+                track.state   = use.state;
+                track.written = use.write;
+            }
+        }
+
+        for (size_t i = 0; i < m_Textures.size(); i++)
+        {
+            if (m_Textures[i].kind == ResourceKind::Imported)
+                m_ImportedStates[m_Textures[i].texture.id] = tracks[i].state;
+        }
+    }
+
+    void RenderGraph::Execute()
+    {
+        ENGINE_CORE_ASSERT(m_Compiled, "RenderGraph: Execute(): graph is not compiled!");
+
+        RenderGraphResources resources(*this);
+        for (Pass& pass : m_Passes)
+        {
+            if (pass.culled)
+                continue;
+
+            ICommandBuffer* cmd = nullptr;
+            if (pass.type == RenderGraphPassType::Graphics)
+            {
+                RenderPassDesc desc;
+                desc.name             = pass.name;
+                desc.colorAttachments = pass.colorAttachments;
+                for (size_t i = 0; i < desc.colorAttachments.size(); i++)
+                {
+                    const TextureResource& resource = m_Textures[pass.colorTextures[i]];
+                    desc.colorAttachments[i].texture   = resource.texture;
+                    desc.colorAttachments[i].swapChain = resource.swapChain;
+                }
+
+                desc.depthAttachment = pass.depthAttachment;
+                if (pass.depthTexture != ~0u)
+                    desc.depthAttachment.texture = m_Textures[pass.depthTexture].texture;
+
+                desc.barriers = pass.barriers;
+                cmd = m_Device.BeginPass(desc);
+
+                // The swapchain can't be rendered to this frame. Later passes still expect this pass's transitions
+                if (cmd == nullptr)
+                {
+                    if (!pass.barriers.empty())
+                        m_Device.EndPass(m_Device.BeginComputePass(pass.barriers, pass.name));
+                    continue;
+                }
+            }
+            else
+            {
+                cmd = m_Device.BeginComputePass(pass.barriers, pass.name);
+            }
+
+            pass.execute(*cmd, resources);
+            m_Device.EndPass(cmd);
+        }
+
+        m_Textures.clear();
+        m_Buffers.clear();
+        m_Passes.clear();
+        m_Compiled = false;
+    }
+
+    void RenderGraph::ReleaseMemory()
+    {
+        // Textures before the heaps they are placed in
+        for (TextureHandle& texture : m_PlacedTextures)
+        {
+            if (texture.IsValid())
+                m_Device.DestroyTexture(texture);
+        }
+
+        for (HeapHandle& heap : m_Heaps)
+            m_Device.DestroyHeap(heap);
+
+        m_PlacedTextures.clear();
+        m_Heaps.clear();
+        m_Plan = {};
+    }
+
+    const MemoryRequirements& RenderGraph::GetMemoryRequirements(const TextureDesc& desc)
+    {
+        for (const auto& [cachedDesc, requirements] : m_RequirementsCache)
+        {
+            if (cachedDesc == desc)
+                return requirements;
+        }
+
+        m_RequirementsCache.emplace_back(desc, m_Device.GetTextureMemoryRequirements(desc));
+        return m_RequirementsCache.back().second;
+    }
+} // namespace Engine::RHI
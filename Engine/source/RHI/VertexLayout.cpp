@@ -23,6 +23,17 @@ namespace Engine::RHI
 
     VertexLayout::VertexLayout(std::initializer_list<VertexElement> elements)
         : m_Elements(elements)
+    {
+        CalculateOffsets();
+    }
+
+    VertexLayout::VertexLayout(const std::vector<VertexElement>& elements)
+        : m_Elements(elements)
+    {
+        CalculateOffsets();
+    }
+
+    void VertexLayout::CalculateOffsets()
     {
         uint32_t currentOffset = 0;
         m_Stride = 0;
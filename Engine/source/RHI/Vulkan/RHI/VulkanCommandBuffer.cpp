@@ -1,18 +1,25 @@
 #include "RHI/Vulkan/RHI/VulkanCommandBuffer.h"
 #include "RHI/Vulkan/RHI/VulkanGraphicsDevice.h"
+#include "RHI/Vulkan/RHI/VulkanCommandBundle.h"
 #include "RHI/Vulkan/VulkanCommon.h"
 #include "RHI/Vulkan/VulkanResourceData.h"
 #include "RHI/Vulkan/VulkanFrame.h"
 #include "Engine/Core/Assert.h"
 
+#include <algorithm>
+
 namespace Engine::RHI::Vulkan
 {
-        VulkanCommandBuffer::VulkanCommandBuffer(VulkanGraphicsDevice& graphicsDevice, vk::CommandPool commandPool)
-            : m_GraphicsDevice(graphicsDevice)
+        VulkanCommandBuffer::VulkanCommandBuffer(
+            VulkanGraphicsDevice& graphicsDevice,
+            vk::CommandPool commandPool,
+            VulkanDescriptorSetAllocator& descriptorSetAllocator,
+            vk::CommandBufferLevel level)
+            : m_GraphicsDevice(graphicsDevice), m_DescriptorSetAllocator(descriptorSetAllocator)
         {
             vk::CommandBufferAllocateInfo allocInfo(
                 commandPool,
-                vk::CommandBufferLevel::ePrimary,
+                level,
                 1
             );
 
@@ -22,18 +29,51 @@ namespace Engine::RHI::Vulkan
         // Graphics
         void VulkanCommandBuffer::BindPipeline(PipelineHandle pipeline)
         {
+            // Already bound, and already waited for and tracked
+            if(pipeline.IsValid() && pipeline.id == m_BoundPipelineHandle.id)
+            {
+                m_Counters.filteredPipelineBinds++;
+                return;
+            }
+
             // Get data and bind
             VulkanPipelineData& data = m_GraphicsDevice.GetPipelineData(pipeline);
+
+            // Pipelines created with CreatePipelineAsync() may still be compiling
+            if(!data.ready)
+            {
+                m_GraphicsDevice.WaitForPipeline(pipeline);
+            }
+
+            // Switching to a different layout disturbs the bound descriptor sets, so bindings start over
+            if(!m_BoundPipelineHandle.IsValid() || m_DescriptorKey.layoutId != data.layoutId)
+            {
+                ResetDescriptorState(data.layoutId);
+            }
+
+            ENGINE_CORE_ASSERT((data.bindPoint == vk::PipelineBindPoint::eCompute) == m_InComputePass, "VulkanCommandBuffer: BindPipeline(): compute pipelines are only valid in compute passes and vice versa!");
+
+            if(m_Bundle)
+                m_Bundle->TrackPipeline(pipeline.id);
+
             m_BoundPipelineHandle = pipeline;
-            m_CommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, data.pipeline);
+            m_CommandBuffer.bindPipeline(data.bindPoint, data.pipeline);
+            m_Counters.pipelineBinds++;
         }
 
         void VulkanCommandBuffer::BindVertexBuffer(BufferHandle buffer)
         {
+            // Static buffers never move, so binding one again is dropped before the lookup
+            if(buffer.id == m_BoundVertexBuffer.id && m_BoundVertexBuffer.isStatic)
+            {
+                m_Counters.filteredVertexBufferBinds++;
+                return;
+            }
+
             // Get data
             VulkanBufferData& bdata = m_GraphicsDevice.GetBufferData(buffer);
 
-            ENGINE_CORE_ASSERT(bdata.desc.type == BufferType::Vertex, "VulkanCommandBuffer: BindVertexBuffer(): buffer is not a vertex buffer!");
+            ENGINE_CORE_ASSERT(bdata.desc.type == BufferType::Vertex || bdata.desc.type == BufferType::Storage, "VulkanCommandBuffer: BindVertexBuffer(): buffer is not a vertex buffer!");
 
             vk::Buffer vkBuffer = nullptr;
             uint32_t dynamicOffset = 0;
@@ -48,21 +88,42 @@ namespace Engine::RHI::Vulkan
                 
                 case BufferUsage::Dynamic:
                 {
-                    vkBuffer = m_GraphicsDevice.GetCurrentFrame()->GetVertexDynamicBufferAllocator().GetBuffer();
-                    dynamicOffset = bdata.dynamicOffsets[m_GraphicsDevice.GetFrameIndex()];
+                    ENGINE_CORE_ASSERT(m_Bundle == nullptr, "VulkanCommandBuffer: BindVertexBuffer(): bundles can't reference dynamic buffers!");
+                    const VulkanDynamicAllocation& allocation = bdata.dynamicAllocations[m_GraphicsDevice.GetFrameIndex()];
+                    vkBuffer = allocation.buffer;
+                    dynamicOffset = allocation.offset;
                     break;
                 }
             }
 
+            if(m_Bundle)
+                m_Bundle->TrackBuffer(buffer.id);
+
+            // Dynamic buffers only need a rebind after an upload moved them
+            if(vkBuffer == m_BoundVertexBuffer.buffer && dynamicOffset == m_BoundVertexBuffer.offset)
+            {
+                m_Counters.filteredVertexBufferBinds++;
+                return;
+            }
+
+            m_BoundVertexBuffer = BoundBuffer{ buffer.id, bdata.desc.usage == BufferUsage::Static, vkBuffer, dynamicOffset };
             m_CommandBuffer.bindVertexBuffers(0, {vkBuffer}, {dynamicOffset});
+            m_Counters.vertexBufferBinds++;
         }
 
         void VulkanCommandBuffer::BindIndexBuffer(BufferHandle buffer)
         {
+            // Static buffers never move, so binding one again is dropped before the lookup
+            if(buffer.id == m_BoundIndexBuffer.id && m_BoundIndexBuffer.isStatic)
+            {
+                m_Counters.filteredIndexBufferBinds++;
+                return;
+            }
+
             // Get data
             VulkanBufferData& bdata = m_GraphicsDevice.GetBufferData(buffer);
 
-            ENGINE_CORE_ASSERT(bdata.desc.type == BufferType::Index, "VulkanCommandBuffer: BindIndexBuffer(): buffer is not an index buffer!");
+            ENGINE_CORE_ASSERT(bdata.desc.type == BufferType::Index || bdata.desc.type == BufferType::Storage, "VulkanCommandBuffer: BindIndexBuffer(): buffer is not an index buffer!");
 
             vk::Buffer vkBuffer = nullptr;
             uint32_t dynamicOffset = 0;
@@ -77,22 +138,38 @@ namespace Engine::RHI::Vulkan
                 
                 case BufferUsage::Dynamic:
                 {
-                    vkBuffer = m_GraphicsDevice.GetCurrentFrame()->GetIndexDynamicBufferAllocator().GetBuffer();
-                    dynamicOffset = bdata.dynamicOffsets[m_GraphicsDevice.GetFrameIndex()];
+                    ENGINE_CORE_ASSERT(m_Bundle == nullptr, "VulkanCommandBuffer: BindIndexBuffer(): bundles can't reference dynamic buffers!");
+                    const VulkanDynamicAllocation& allocation = bdata.dynamicAllocations[m_GraphicsDevice.GetFrameIndex()];
+                    vkBuffer = allocation.buffer;
+                    dynamicOffset = allocation.offset;
                     break;
                 }
             }
 
-            // TODO: Vulkan: Change index size
-            m_CommandBuffer.bindIndexBuffer(vkBuffer, dynamicOffset, vk::IndexType::eUint16);
+            if(m_Bundle)
+                m_Bundle->TrackBuffer(buffer.id);
+
+            // Dynamic buffers only need a rebind after an upload moved them
+            if(vkBuffer == m_BoundIndexBuffer.buffer && dynamicOffset == m_BoundIndexBuffer.offset)
+            {
+                m_Counters.filteredIndexBufferBinds++;
+                return;
+            }
+
+            m_BoundIndexBuffer = BoundBuffer{ buffer.id, bdata.desc.usage == BufferUsage::Static, vkBuffer, dynamicOffset };
+
+            m_CommandBuffer.bindIndexBuffer(vkBuffer, dynamicOffset, VulkanCommon::GetIndexType(bdata.desc.indexFormat));
+            m_Counters.indexBufferBinds++;
         }
 
         void VulkanCommandBuffer::BindUniformBuffer(BufferHandle buffer, uint32_t binding)
         {
             ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "VulkanCommandBuffer: BindUniformBuffer(): no bound pipeline!");
+            m_Counters.resourceBinds++;
             
+            ENGINE_CORE_ASSERT(binding < k_MaxBindings, "VulkanCommandBuffer: BindUniformBuffer(): binding exceeds k_MaxBindings!");
+
             // Get data
-            VulkanPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
             VulkanBufferData& bdata = m_GraphicsDevice.GetBufferData(buffer);
 
             ENGINE_CORE_ASSERT(bdata.desc.type == BufferType::Uniform, "VulkanCommandBuffer: BindUniformBuffer(): buffer is not a uniform buffer!");
@@ -100,6 +177,7 @@ namespace Engine::RHI::Vulkan
             // Get buffer
             vk::Buffer vkBuffer = nullptr;
             uint32_t dynamicOffset = 0;
+            uint32_t pageId = 0;
 
             switch(bdata.desc.usage)
             {
@@ -111,108 +189,372 @@ namespace Engine::RHI::Vulkan
                 
                 case BufferUsage::Dynamic:
                 {
-                    vkBuffer = m_GraphicsDevice.GetCurrentFrame()->GetUniformDynamicBufferAllocator().GetBuffer();
-                    dynamicOffset = bdata.dynamicOffsets[m_GraphicsDevice.GetFrameIndex()];
+                    ENGINE_CORE_ASSERT(m_Bundle == nullptr, "VulkanCommandBuffer: BindUniformBuffer(): bundles can't reference dynamic buffers!");
+                    const VulkanDynamicAllocation& allocation = bdata.dynamicAllocations[m_GraphicsDevice.GetFrameIndex()];
+                    vkBuffer = allocation.buffer;
+                    dynamicOffset = static_cast<uint32_t>(allocation.offset);
+                    pageId = allocation.pageId;
                     break;
                 }
             }
 
-            // Get descriptor set
-            VulkanDescriptorSetAllocator& alloc = m_GraphicsDevice.GetCurrentFrame()->GetDescriptorSetAllocator();
-            vk::DescriptorSet set = alloc.GetOrAllocate(m_BoundPipelineHandle.id, *pdata.descriptorSetLayout);
+            if (m_Bundle)
+                m_Bundle->TrackBuffer(buffer.id);
 
-            // Check if descriptor set needs written
-            if (alloc.NeedsWriteBuffer(m_BoundPipelineHandle.id, binding, buffer.id))
+            // Record binding. A different buffer or page needs a different set, a different offset only needs a rebind
+            if (m_DescriptorKey.resources[binding] != buffer.id || m_DescriptorKey.pages[binding] != pageId)
             {
-                vk::DescriptorBufferInfo bufferInfo;
-                bufferInfo.buffer = vkBuffer;
-                bufferInfo.offset = 0;
-                bufferInfo.range  = bdata.desc.size;
-
-                vk::WriteDescriptorSet write;
-                write.dstSet          = set;
-                write.dstBinding      = binding;
-                write.descriptorCount = 1;
-                write.descriptorType  = vk::DescriptorType::eUniformBufferDynamic;
-                write.pBufferInfo     = &bufferInfo;
-
-                m_GraphicsDevice.GetContext().GetDevice().updateDescriptorSets(write, {});
-
-                alloc.MarkWrittenBuffer(m_BoundPipelineHandle.id, binding, buffer.id);
+                m_DescriptorWrites[binding].buffer = vk::DescriptorBufferInfo(vkBuffer, 0, bdata.desc.size);
+                m_DescriptorKey.resources[binding] = buffer.id;
+                m_DescriptorKey.pages[binding]     = pageId;
+                m_DescriptorsDirty = true;
             }
 
-            alloc.SetDynamicOffset(m_BoundPipelineHandle.id, binding, dynamicOffset);
+            if (m_DynamicOffsets[binding] != dynamicOffset)
+            {
+                m_DynamicOffsets[binding] = dynamicOffset;
+                m_DescriptorsDirty = true;
+            }
         }
 
         void VulkanCommandBuffer::BindTexture(TextureHandle texture, uint32_t binding)
         {
-            ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "VulkanCommandBuffer: BindUniformBuffer(): no bound pipeline!");
+            ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "VulkanCommandBuffer: BindTexture(): no bound pipeline!");
+            ENGINE_CORE_ASSERT(binding < k_MaxBindings, "VulkanCommandBuffer: BindTexture(): binding exceeds k_MaxBindings!");
+            m_Counters.resourceBinds++;
+
+            if (m_Bundle)
+                m_Bundle->TrackTexture(texture.id);
+
+            if (m_DescriptorKey.resources[binding] == texture.id)
+                return;
 
             // Get Data
-            VulkanTextureData&  tdata = m_GraphicsDevice.GetTextureData(texture);
+            VulkanTextureData& tdata = m_GraphicsDevice.GetTextureData(texture);
+
+            // Record binding
+            m_DescriptorWrites[binding].image = vk::DescriptorImageInfo(tdata.sampler, *tdata.imageView, VulkanCommon::GetShaderReadLayout(tdata.desc.usage));
+            m_DescriptorKey.resources[binding] = texture.id;
+            m_DescriptorsDirty = true;
+        }
+
+        void VulkanCommandBuffer::BindStorageBuffer(BufferHandle buffer, uint32_t binding)
+        {
+            ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "VulkanCommandBuffer: BindStorageBuffer(): no bound pipeline!");
+            ENGINE_CORE_ASSERT(binding < k_MaxBindings, "VulkanCommandBuffer: BindStorageBuffer(): binding exceeds k_MaxBindings!");
+            m_Counters.resourceBinds++;
+
+            if (m_Bundle)
+                m_Bundle->TrackBuffer(buffer.id);
+
+            if (m_DescriptorKey.resources[binding] == buffer.id)
+                return;
+
+            // Get data
+            VulkanBufferData& bdata = m_GraphicsDevice.GetBufferData(buffer);
+
+            ENGINE_CORE_ASSERT(bdata.desc.type == BufferType::Storage, "VulkanCommandBuffer: BindStorageBuffer(): buffer is not a storage buffer!");
+
+            // Record binding
+            m_DescriptorWrites[binding].buffer = vk::DescriptorBufferInfo(bdata.buffer, 0, VK_WHOLE_SIZE);
+            m_DescriptorKey.resources[binding] = buffer.id;
+            m_DescriptorsDirty = true;
+        }
+
+        void VulkanCommandBuffer::BindStorageTexture(TextureHandle texture, uint32_t binding)
+        {
+            ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "VulkanCommandBuffer: BindStorageTexture(): no bound pipeline!");
+            ENGINE_CORE_ASSERT(binding < k_MaxBindings, "VulkanCommandBuffer: BindStorageTexture(): binding exceeds k_MaxBindings!");
+            m_Counters.resourceBinds++;
+
+            if (m_Bundle)
+                m_Bundle->TrackTexture(texture.id);
+
+            // Get data
+            VulkanTextureData& tdata = m_GraphicsDevice.GetTextureData(texture);
+
+            ENGINE_CORE_ASSERT(tdata.desc.usage.Has(TextureUsage::Storage), "VulkanCommandBuffer: BindStorageTexture(): texture was not created with TextureUsage::Storage!");
+
+            // Storage images are put in eGeneral when created. Passes that use them as attachments must barrier back
+            // to ResourceState::Storage or ShaderRead before they are bound again
+            if (m_DescriptorKey.resources[binding] == texture.id)
+                return;
+
+            // Record binding
+            m_DescriptorWrites[binding].image = vk::DescriptorImageInfo(nullptr, *tdata.imageView, vk::ImageLayout::eGeneral);
+            m_DescriptorKey.resources[binding] = texture.id;
+            m_DescriptorsDirty = true;
+        }
+
+        void VulkanCommandBuffer::PushConstants(ShaderStage stage, uint32_t offset, uint32_t size, const void* data)
+        {
+            ENGINE_CORE_ASSERT(m_BoundPipelineHandle.IsValid(), "VulkanCommandBuffer: PushConstants(): no bound pipeline!");
+
+            // Get data
             VulkanPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
+            VulkanPipelineLayoutData& ldata = m_GraphicsDevice.GetPipelineLayoutData(pdata.layoutId);
 
-            // Get descriptor set
-            VulkanDescriptorSetAllocator& alloc = m_GraphicsDevice.GetCurrentFrame()->GetDescriptorSetAllocator();
-            vk::DescriptorSet set = alloc.GetOrAllocate(m_BoundPipelineHandle.id, *pdata.descriptorSetLayout);
+            // Vulkan requires every stage whose range overlaps the update to be named, and each named range to cover it
+            vk::ShaderStageFlags stageFlags;
+            for (const vk::PushConstantRange& range : ldata.pushConstantRanges)
+            {
+                if (offset < range.offset + range.size && range.offset < offset + size)
+                {
+                    ENGINE_CORE_ASSERT(range.offset <= offset && offset + size <= range.offset + range.size, "VulkanCommandBuffer: PushConstants(): update straddles a push constant range!");
+                    stageFlags |= range.stageFlags;
+                }
+            }
+
+            ENGINE_CORE_ASSERT(stageFlags & VulkanCommon::GetShaderStage(stage), "VulkanCommandBuffer: PushConstants(): range is not declared for this stage in the pipeline!");
+
+            (*m_CommandBuffer).pushConstants(pdata.pipelineLayout, stageFlags, offset, size, data);
+            m_Counters.pushConstants++;
+        }
 
-            // Check if descriptor set needs written
-            if (alloc.NeedsWriteTexture(m_BoundPipelineHandle.id, binding, texture.id))
+        void VulkanCommandBuffer::ResetDescriptorState(uint32_t layoutId)
+        {
+            m_DescriptorKey    = VulkanDescriptorSetKey{ .layoutId = layoutId };
+            m_DescriptorWrites = {};
+            m_DynamicOffsets   = {};
+            m_DescriptorsDirty = true;
+
+            // Sets bound with another layout are not compatible
+            m_BoundDescriptorSet = nullptr;
+        }
+
+        void VulkanCommandBuffer::ResetBoundState()
+        {
+            m_BoundPipelineHandle = PipelineHandle{.id = 0};
+            m_BoundVertexBuffer   = {};
+            m_BoundIndexBuffer    = {};
+            ResetDescriptorState(0);
+        }
+
+        void VulkanCommandBuffer::FlushDescriptors()
+        {
+            if (!m_DescriptorsDirty || !m_BoundPipelineHandle.IsValid())
+                return;
+
+            m_DescriptorsDirty = false;
+
+            // Get data
+            VulkanPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
+            if (!pdata.updateTemplate)
+                return; // Layout has no bindings
+
+            VulkanPipelineLayoutData& ldata = m_GraphicsDevice.GetPipelineLayoutData(pdata.layoutId);
+            for (const UniformBinding& ub : ldata.key.uniformBindings)
             {
-                vk::DescriptorImageInfo imageInfo;
-                imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-                imageInfo.imageView   = *tdata.imageView;
-                imageInfo.sampler     = *tdata.sampler;
+                ENGINE_CORE_ASSERT(m_DescriptorKey.resources[ub.binding] != 0, "VulkanCommandBuffer: Draw(): a uniform binding of the bound pipeline was never bound!");
+            }
 
-                vk::WriteDescriptorSet write;
-                write.dstSet          = set;
-                write.dstBinding      = binding;
-                write.descriptorCount = 1;
-                write.descriptorType  = vk::DescriptorType::eCombinedImageSampler;
-                write.pImageInfo      = &imageInfo;
+            // Get or build the set for the current bindings
+            vk::DescriptorSet set = m_DescriptorSetAllocator.GetOrAllocate(
+                m_DescriptorKey,
+                pdata.descriptorSetLayout,
+                pdata.updateTemplate,
+                m_DescriptorWrites
+            );
 
-                m_GraphicsDevice.GetContext().GetDevice().updateDescriptorSets(write, {});
+            // Dynamic offsets in binding order
+            std::array<uint32_t, k_MaxBindings> offsets;
+            uint32_t offsetCount = 0;
+            for (uint32_t binding : ldata.dynamicBindings)
+            {
+                offsets[offsetCount++] = m_DynamicOffsets[binding];
+            }
 
-                alloc.MarkWrittenTexture(m_BoundPipelineHandle.id, binding, texture.id);
+            // Bindings changed and changed back, like a material rebinding what the previous one used
+            if (set == m_BoundDescriptorSet && std::equal(offsets.begin(), offsets.begin() + offsetCount, m_BoundDynamicOffsets.begin()))
+            {
+                m_Counters.filteredDescriptorBinds++;
+                return;
             }
 
-            alloc.MarkDirty(m_BoundPipelineHandle.id);
+            m_BoundDescriptorSet  = set;
+            m_BoundDynamicOffsets = offsets;
+            m_Counters.descriptorBinds++;
+            m_CommandBuffer.bindDescriptorSets(
+                pdata.bindPoint,
+                pdata.pipelineLayout,
+                0, set,
+                vk::ArrayProxy<const uint32_t>(offsetCount, offsets.data())
+            );
         }
 
         void VulkanCommandBuffer::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
         {
-            if(m_BoundPipelineHandle.IsValid())
-            {
-                VulkanPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
-                m_GraphicsDevice.GetCurrentFrame()->GetDescriptorSetAllocator().BindDescriptorSets(
-                    m_BoundPipelineHandle.id,
-                    pdata.descriptorSetLayout,
-                    pdata.pipelineLayout,
-                    m_CommandBuffer
-                );
-            }
+            FlushDescriptors();
             m_CommandBuffer.draw(vertexCount, instanceCount, firstVertex, firstInstance);
+            m_Counters.draws++;
         }
 
         void VulkanCommandBuffer::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t indexOffset, uint32_t firstInstance)
         {
-            if(m_BoundPipelineHandle.IsValid())
+            FlushDescriptors();
+            m_CommandBuffer.drawIndexed(indexCount, instanceCount, firstIndex, indexOffset, firstInstance);
+            m_Counters.draws++;
+        }
+
+        vk::Buffer VulkanCommandBuffer::GetIndirectBuffer(BufferHandle buffer, size_t& offset)
+        {
+            // Get data
+            VulkanBufferData& bdata = m_GraphicsDevice.GetBufferData(buffer);
+
+            ENGINE_CORE_ASSERT(bdata.desc.type == BufferType::Indirect || bdata.desc.type == BufferType::Storage, "VulkanCommandBuffer: indirect arguments must be in an indirect or storage buffer!");
+
+            if (m_Bundle)
             {
-                VulkanPipelineData& pdata = m_GraphicsDevice.GetPipelineData(m_BoundPipelineHandle);
-                m_GraphicsDevice.GetCurrentFrame()->GetDescriptorSetAllocator().BindDescriptorSets(
-                    m_BoundPipelineHandle.id,
-                    pdata.descriptorSetLayout,
-                    pdata.pipelineLayout,
-                    m_CommandBuffer
-                );
+                ENGINE_CORE_ASSERT(bdata.desc.usage == BufferUsage::Static, "VulkanCommandBuffer: bundles can't reference dynamic buffers!");
+                m_Bundle->TrackBuffer(buffer.id);
             }
-            m_CommandBuffer.drawIndexed(indexCount, instanceCount, firstIndex, indexOffset, firstInstance);
+
+            switch(bdata.desc.usage)
+            {
+                case BufferUsage::Static:
+                    return bdata.buffer;
+
+                case BufferUsage::Dynamic:
+                {
+                    const VulkanDynamicAllocation& allocation = bdata.dynamicAllocations[m_GraphicsDevice.GetFrameIndex()];
+                    offset += allocation.offset;
+                    return allocation.buffer;
+                }
+            }
+
+            return nullptr;
+        }
+
+        void VulkanCommandBuffer::DrawIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride)
+        {
+            vk::Buffer vkBuffer = GetIndirectBuffer(buffer, offset);
+            FlushDescriptors();
+            m_Counters.indirectDraws++;
+
+            // Without multiDrawIndirect each draw is its own call
+            if (drawCount > 1 && !m_GraphicsDevice.GetCapabilities().multiDrawIndirect)
+            {
+                for (uint32_t i = 0; i < drawCount; i++)
+                    m_CommandBuffer.drawIndirect(vkBuffer, offset + i * stride, 1, stride);
+                return;
+            }
+
+            m_CommandBuffer.drawIndirect(vkBuffer, offset, drawCount, stride);
+        }
+
+        void VulkanCommandBuffer::DrawIndexedIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride)
+        {
+            vk::Buffer vkBuffer = GetIndirectBuffer(buffer, offset);
+            FlushDescriptors();
+            m_Counters.indirectDraws++;
+
+            // Without multiDrawIndirect each draw is its own call
+            if (drawCount > 1 && !m_GraphicsDevice.GetCapabilities().multiDrawIndirect)
+            {
+                for (uint32_t i = 0; i < drawCount; i++)
+                    m_CommandBuffer.drawIndexedIndirect(vkBuffer, offset + i * stride, 1, stride);
+                return;
+            }
+
+            m_CommandBuffer.drawIndexedIndirect(vkBuffer, offset, drawCount, stride);
+        }
+
+        void VulkanCommandBuffer::DrawIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride)
+        {
+            ENGINE_CORE_ASSERT(m_GraphicsDevice.GetCapabilities().drawIndirectCount, "VulkanCommandBuffer: DrawIndirectCount(): drawIndirectCount is not supported by this device!");
+
+            vk::Buffer vkBuffer = GetIndirectBuffer(buffer, offset);
+            vk::Buffer vkCountBuffer = GetIndirectBuffer(countBuffer, countOffset);
+            FlushDescriptors();
+            m_CommandBuffer.drawIndirectCount(vkBuffer, offset, vkCountBuffer, countOffset, maxDrawCount, stride);
+            m_Counters.indirectDraws++;
+        }
+
+        void VulkanCommandBuffer::DrawIndexedIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride)
+        {
+            ENGINE_CORE_ASSERT(m_GraphicsDevice.GetCapabilities().drawIndirectCount, "VulkanCommandBuffer: DrawIndexedIndirectCount(): drawIndirectCount is not supported by this device!");
+
+            vk::Buffer vkBuffer = GetIndirectBuffer(buffer, offset);
+            vk::Buffer vkCountBuffer = GetIndirectBuffer(countBuffer, countOffset);
+            FlushDescriptors();
+            m_CommandBuffer.drawIndexedIndirectCount(vkBuffer, offset, vkCountBuffer, countOffset, maxDrawCount, stride);
+            m_Counters.indirectDraws++;
+        }
+
+        void VulkanCommandBuffer::ExecuteBundle(ICommandBundle* bundle)
+        {
+            ENGINE_CORE_ASSERT(bundle != nullptr, "VulkanCommandBuffer: ExecuteBundle(): bundle is nullptr!");
+            ENGINE_CORE_ASSERT(m_InRenderPass, "VulkanCommandBuffer: ExecuteBundle(): not in a graphics pass!");
+
+            VulkanCommandBundle* vbundle = static_cast<VulkanCommandBundle*>(bundle);
+
+            // Replaying a stale bundle would touch destroyed resources
+            ENGINE_CORE_ASSERT(vbundle->IsValid(), "VulkanCommandBuffer: ExecuteBundle(): bundle is not recorded or was invalidated, re-record it!");
+            if (!vbundle->IsValid())
+                return;
+
+            ENGINE_CORE_ASSERT(m_ColorAttachments.size() == 1 && vbundle->GetDesc().swapChain == m_SwapChain, "VulkanCommandBuffer: ExecuteBundle(): bundle was recorded for a different target!");
+            ENGINE_CORE_ASSERT(vbundle->GetDepthFormat() == (m_DepthAttachment.texture ? m_DepthAttachment.texture->format : vk::Format::eUndefined), "VulkanCommandBuffer: ExecuteBundle(): bundle depth buffer does not match the pass!");
+
+            // A dynamic rendering instance holds either inline commands or secondary command buffers,
+            // so the bundle gets an instance of its own. Attachments are loaded, nothing is cleared twice.
+            m_CommandBuffer.endRendering();
+            BeginRenderingInstance(true, vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+            m_CommandBuffer.executeCommands(vbundle->GetCommandBuffer());
+
+            // The bundle's commands count in every pass that replays them
+            m_Counters += vbundle->m_Recording->commandBuffer->GetCounters();
+            m_Counters.bundles++;
+            m_CommandBuffer.endRendering();
+            BeginRenderingInstance(true, {});
+
+            // Frame that will execute it, so re-recording doesn't reset it under the GPU
+            vbundle->MarkUsed(m_GraphicsDevice.GetFrameTimelineValue() + 1);
+
+            // State bound before the bundle is undefined after executeCommands
+            ResetBoundState();
         }
 
+        // Compute
+        void VulkanCommandBuffer::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+        {
+            ENGINE_CORE_ASSERT(m_InComputePass, "VulkanCommandBuffer: Dispatch(): not in a compute pass!");
+
+            FlushDescriptors();
+            m_CommandBuffer.dispatch(groupCountX, groupCountY, groupCountZ);
+            m_Counters.dispatches++;
+        }
+
+        void VulkanCommandBuffer::DispatchIndirect(BufferHandle buffer, size_t offset)
+        {
+            ENGINE_CORE_ASSERT(m_InComputePass, "VulkanCommandBuffer: DispatchIndirect(): not in a compute pass!");
+
+            vk::Buffer vkBuffer = GetIndirectBuffer(buffer, offset);
+            FlushDescriptors();
+            m_CommandBuffer.dispatchIndirect(vkBuffer, offset);
+            m_Counters.dispatches++;
+        }
+
+        void VulkanCommandBuffer::ComputeBarrier()
+        {
+            ENGINE_CORE_ASSERT(m_InComputePass, "VulkanCommandBuffer: ComputeBarrier(): not in a compute pass!");
+
+            vk::MemoryBarrier2 barrier(
+                vk::PipelineStageFlagBits2::eComputeShader,
+                vk::AccessFlagBits2::eShaderStorageWrite,
+                vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect,
+                vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eIndirectCommandRead
+            );
+            m_CommandBuffer.pipelineBarrier2(vk::DependencyInfo({}, barrier));
+        }
    
         // Data
         void VulkanCommandBuffer::UploadBuffer(BufferHandle buffer, void* data, size_t size, size_t offset)
         {
+            ENGINE_CORE_ASSERT(m_Bundle == nullptr, "VulkanCommandBuffer: UploadBuffer(): not valid in a bundle!");
+            m_Counters.uploads++;
+            m_Counters.uploadBytes += size;
+
             // Get data
             VulkanBufferData& bdata = m_GraphicsDevice.GetBufferData(buffer);
 
@@ -235,9 +577,10 @@ namespace Engine::RHI::Vulkan
                     VkBuffer stagingBuffer;
                     VmaAllocation stagingAllocation;
                     vmaCreateBuffer(m_GraphicsDevice.GetContext().GetAllocator(), &stagingBufferInfo, &allocInfo, &stagingBuffer, &stagingAllocation, &resultInfo);
+                    m_GraphicsDevice.GetContext().TrackAllocation(VulkanMemoryCategory::Staging, stagingAllocation);
 
                     // Copy data to staging buffer
-                    std::memcpy(resultInfo.pMappedData, data, size);
+                    VulkanCommon::CopyToMapped(resultInfo.pMappedData, data, size);
 
                     // Copy command from staging buffer to static buffer
                     vk::BufferCopy copyRegion{};
@@ -246,6 +589,18 @@ namespace Engine::RHI::Vulkan
                     copyRegion.size = size;
                     m_CommandBuffer.copyBuffer(stagingBuffer, bdata.buffer, { copyRegion });
 
+                    // Indirect arguments are read by the draw indirect stage, which the copy doesn't cover
+                    if (bdata.desc.type == BufferType::Indirect)
+                    {
+                        vk::BufferMemoryBarrier2 barrier(
+                            vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite,
+                            vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead,
+                            VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                            bdata.buffer, offset, size
+                        );
+                        m_CommandBuffer.pipelineBarrier2(vk::DependencyInfo({}, {}, barrier));
+                    }
+
                     // Add to staging buffer allocations
                     m_StagingBufferAllocations.emplace_back(stagingBuffer, stagingAllocation);
                     break;
@@ -253,25 +608,76 @@ namespace Engine::RHI::Vulkan
 
                 case BufferUsage::Dynamic:
                 {
-                    VulkanDynamicBufferAllocator* alloc = nullptr;
-                    switch(bdata.desc.type)
-                    {
-                        case BufferType::Vertex:  alloc = &m_GraphicsDevice.GetCurrentFrame()->GetVertexDynamicBufferAllocator(); break;
-                        case BufferType::Index:   alloc = &m_GraphicsDevice.GetCurrentFrame()->GetIndexDynamicBufferAllocator(); break;
-                        case BufferType::Uniform: alloc = &m_GraphicsDevice.GetCurrentFrame()->GetUniformDynamicBufferAllocator(); break;
-                    }
-
-                    bdata.dynamicOffsets[m_GraphicsDevice.GetFrameIndex()] = alloc->AllocateAndCopy(data, size);
+                    VulkanDynamicBufferAllocator& alloc = m_GraphicsDevice.GetCurrentFrame()->GetDynamicBufferAllocator(bdata.desc.type);
+                    bdata.dynamicAllocations[m_GraphicsDevice.GetFrameIndex()] = alloc.AllocateAndCopy(data, size);
                     break;
                 }
             }
         }
 
-        void VulkanCommandBuffer::UploadTexture(TextureHandle texture, void* data)
+        void* VulkanCommandBuffer::MapDynamic(BufferHandle buffer, size_t size)
         {
+            ENGINE_CORE_ASSERT(m_Bundle == nullptr, "VulkanCommandBuffer: MapDynamic(): not valid in a bundle!");
+            m_Counters.uploads++;
+            m_Counters.uploadBytes += size;
+
             // Get data
+            VulkanBufferData& bdata = m_GraphicsDevice.GetBufferData(buffer);
+
+            ENGINE_CORE_ASSERT(bdata.desc.usage == BufferUsage::Dynamic, "VulkanCommandBuffer: MapDynamic(): buffer is not dynamic!");
+
+            void* mapped = nullptr;
+            VulkanDynamicBufferAllocator& alloc = m_GraphicsDevice.GetCurrentFrame()->GetDynamicBufferAllocator(bdata.desc.type);
+            bdata.dynamicAllocations[m_GraphicsDevice.GetFrameIndex()] = alloc.Allocate(size, mapped);
+            return mapped;
+        }
+
+        void VulkanCommandBuffer::UploadTexture(TextureHandle texture, void* data)
+        {
+            ENGINE_CORE_ASSERT(m_Bundle == nullptr, "VulkanCommandBuffer: UploadTexture(): not valid in a bundle!");
+
             VulkanTextureData& tdata = m_GraphicsDevice.GetTextureData(texture);
-            size_t size = tdata.desc.width * tdata.desc.height * VulkanCommon::GetPixelSize(tdata.desc.format);
+            ENGINE_CORE_ASSERT(tdata.desc.mipLevels == 1 || !VulkanCommon::IsCompressed(tdata.desc.format), "VulkanCommandBuffer: UploadTexture(): compressed mips can't be generated, use UploadTextureMips()!");
+            UploadTextureLevels(tdata, { data });
+            if (tdata.desc.mipLevels > 1)
+                GenerateMips(tdata);
+            TransitionToShaderRead(tdata, tdata.desc.mipLevels > 1);
+        }
+
+        void VulkanCommandBuffer::UploadTextureMips(TextureHandle texture, const std::vector<void*>& levels)
+        {
+            ENGINE_CORE_ASSERT(m_Bundle == nullptr, "VulkanCommandBuffer: UploadTextureMips(): not valid in a bundle!");
+
+            VulkanTextureData& tdata = m_GraphicsDevice.GetTextureData(texture);
+            ENGINE_CORE_ASSERT(levels.size() == tdata.desc.mipLevels, "VulkanCommandBuffer: UploadTextureMips(): need one level per mip!");
+
+            UploadTextureLevels(tdata, levels);
+            TransitionToShaderRead(tdata, false);
+        }
+
+        void VulkanCommandBuffer::UploadTextureLevels(VulkanTextureData& tdata, const std::vector<void*>& levels)
+        {
+            ENGINE_CORE_ASSERT(!tdata.desc.usage.Has(TextureUsage::DepthStencil), "VulkanCommandBuffer: UploadTexture(): depth textures can't be uploaded!");
+            m_Counters.uploads++;
+
+            // All levels share one staging buffer
+            std::vector<vk::BufferImageCopy> regions;
+            size_t size = 0;
+            for (uint32_t level = 0; level < levels.size(); level++)
+            {
+                vk::BufferImageCopy region{};
+                region.bufferOffset = size;
+                region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+                region.imageSubresource.mipLevel = level;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = vk::Offset3D{0, 0, 0};
+                region.imageExtent = vk::Extent3D{ std::max(tdata.desc.width >> level, 1u), std::max(tdata.desc.height >> level, 1u), 1 };
+                regions.push_back(region);
+
+                size += VulkanCommon::GetMipSize(tdata.desc, level);
+            }
+            m_Counters.uploadBytes += size;
 
             // Create staging buffer
             VkBufferCreateInfo stagingBufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
@@ -288,11 +694,16 @@ namespace Engine::RHI::Vulkan
             VkBuffer stagingBuffer;
             VmaAllocation stagingAllocation;
             vmaCreateBuffer(m_GraphicsDevice.GetContext().GetAllocator(), &stagingBufferInfo, &allocInfo, &stagingBuffer, &stagingAllocation, &resultInfo);
+            m_GraphicsDevice.GetContext().TrackAllocation(VulkanMemoryCategory::Staging, stagingAllocation);
 
             // Copy data to staging buffer
-            std::memcpy(resultInfo.pMappedData, data, size);
+            for (uint32_t level = 0; level < levels.size(); level++)
+            {
+                char* dst = static_cast<char*>(resultInfo.pMappedData) + regions[level].bufferOffset;
+                VulkanCommon::CopyToMapped(dst, levels[level], VulkanCommon::GetMipSize(tdata.desc, level));
+            }
 
-            // Transition image layout eUndefined->eTransferDstOptimal
+            // Transition every level eUndefined->eTransferDstOptimal
             VulkanCommon::TransitionImageLayout(
                 m_CommandBuffer,
                 tdata.image, 
@@ -306,156 +717,453 @@ namespace Engine::RHI::Vulkan
             );
 
             // Copy command from staging buffer to image
-            vk::BufferImageCopy region{};
-            region.bufferOffset = 0;
-            region.bufferRowLength = 0;
-            region.bufferImageHeight = 0;
-            region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-            region.imageSubresource.mipLevel = 0;
-            region.imageSubresource.baseArrayLayer = 0;
-            region.imageSubresource.layerCount = 1;
-            region.imageOffset = vk::Offset3D{0, 0, 0};
-            region.imageExtent = vk::Extent3D{ tdata.desc.width, tdata.desc.height, 1 };
-
-            vk::BufferCopy copyRegion{};
-            copyRegion.srcOffset = 0;
-            copyRegion.dstOffset = 0;
-            copyRegion.size = size;
-
             m_CommandBuffer.copyBufferToImage(
                 stagingBuffer,
                 tdata.image,
                 vk::ImageLayout::eTransferDstOptimal,
-                region
+                regions
             );
 
-            // eTransferDstOptimal -> eShaderReadOnlyOptimal
-            VulkanCommon::TransitionImageLayout(
-                m_CommandBuffer,
-                tdata.image, 
-                vk::ImageLayout::eTransferDstOptimal, 
-                vk::ImageLayout::eShaderReadOnlyOptimal,
+            // Add to staging buffer allocations
+            m_StagingBufferAllocations.emplace_back(stagingBuffer, stagingAllocation);
+        }
+
+        void VulkanCommandBuffer::GenerateMips(VulkanTextureData& tdata)
+        {
+            // Linear filtering isn't supported for blits from every format
+            vk::FormatProperties formatProperties = m_GraphicsDevice.GetContext().GetPhysicalDevice().getFormatProperties(tdata.format);
+            vk::Filter filter = (formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)
+                ? vk::Filter::eLinear
+                : vk::Filter::eNearest;
+
+            // Each level is blitted from the one above, which moves to eTransferSrcOptimal first
+            for (uint32_t level = 1; level < tdata.desc.mipLevels; level++)
+            {
+                vk::ImageMemoryBarrier2 barrier = VulkanCommon::GetImageBarrier(
+                    tdata.image,
+                    vk::ImageLayout::eTransferDstOptimal,
+                    vk::ImageLayout::eTransferSrcOptimal,
+                    vk::AccessFlagBits2::eTransferWrite,
+                    vk::AccessFlagBits2::eTransferRead,
+                    vk::PipelineStageFlagBits2::eTransfer,
+                    vk::PipelineStageFlagBits2::eTransfer,
+                    vk::ImageAspectFlagBits::eColor
+                );
+                barrier.subresourceRange.baseMipLevel = level - 1;
+                barrier.subresourceRange.levelCount   = 1;
+
+                vk::DependencyInfo dependencyInfo;
+                dependencyInfo.imageMemoryBarrierCount = 1;
+                dependencyInfo.pImageMemoryBarriers    = &barrier;
+                m_CommandBuffer.pipelineBarrier2(dependencyInfo);
+
+                vk::ImageBlit blit{};
+                blit.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - 1, 0, 1);
+                blit.srcOffsets[1]  = vk::Offset3D{
+                    static_cast<int32_t>(std::max(tdata.desc.width >> (level - 1), 1u)),
+                    static_cast<int32_t>(std::max(tdata.desc.height >> (level - 1), 1u)),
+                    1
+                };
+                blit.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, 1);
+                blit.dstOffsets[1]  = vk::Offset3D{
+                    static_cast<int32_t>(std::max(tdata.desc.width >> level, 1u)),
+                    static_cast<int32_t>(std::max(tdata.desc.height >> level, 1u)),
+                    1
+                };
+
+                m_CommandBuffer.blitImage(
+                    tdata.image, vk::ImageLayout::eTransferSrcOptimal,
+                    tdata.image, vk::ImageLayout::eTransferDstOptimal,
+                    blit, filter
+                );
+            }
+        }
+
+        void VulkanCommandBuffer::TransitionToShaderRead(VulkanTextureData& tdata, bool generatedMips)
+        {
+            // eTransferDstOptimal -> eShaderReadOnlyOptimal (eGeneral for storage textures). After mip generation every
+            // level but the last was a blit source
+            vk::ImageLayout readLayout = VulkanCommon::GetShaderReadLayout(tdata.desc.usage);
+            uint32_t lastLevel = tdata.desc.mipLevels - 1;
+
+            std::vector<vk::ImageMemoryBarrier2> barriers;
+            barriers.push_back(VulkanCommon::GetImageBarrier(
+                tdata.image,
+                vk::ImageLayout::eTransferDstOptimal,
+                readLayout,
                 vk::AccessFlagBits2::eTransferWrite,
                 vk::AccessFlagBits2::eShaderRead,
                 vk::PipelineStageFlagBits2::eTransfer,
-                vk::PipelineStageFlagBits2::eFragmentShader,
+                vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
                 vk::ImageAspectFlagBits::eColor
-            );
+            ));
 
-            // Add to staging buffer allocations
-            m_StagingBufferAllocations.emplace_back(stagingBuffer, stagingAllocation);
+            if (generatedMips)
+            {
+                barriers[0].subresourceRange.baseMipLevel = lastLevel;
+
+                barriers.push_back(VulkanCommon::GetImageBarrier(
+                    tdata.image,
+                    vk::ImageLayout::eTransferSrcOptimal,
+                    readLayout,
+                    vk::AccessFlagBits2::eTransferRead,
+                    vk::AccessFlagBits2::eShaderRead,
+                    vk::PipelineStageFlagBits2::eTransfer,
+                    vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+                    vk::ImageAspectFlagBits::eColor
+                ));
+                barriers[1].subresourceRange.levelCount = lastLevel;
+            }
+
+            vk::DependencyInfo dependencyInfo;
+            dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+            dependencyInfo.pImageMemoryBarriers    = barriers.data();
+            m_CommandBuffer.pipelineBarrier2(dependencyInfo);
+
+            SetTextureLayout(tdata, readLayout);
+        }
+
+        vk::ImageLayout VulkanCommandBuffer::AcquireTextureLayout(VulkanTextureData& tdata, vk::ImageLayout expected, bool restore)
+        {
+            auto [it, inserted] = m_TextureLayouts.try_emplace(&tdata, TextureLayoutState{ expected, expected, restore });
+            return it->second.current;
+        }
+
+        void VulkanCommandBuffer::SetTextureLayout(VulkanTextureData& tdata, vk::ImageLayout layout)
+        {
+            m_TextureLayouts[&tdata].current = layout;
+        }
+
+        void VulkanCommandBuffer::AddTextureBarriers(const std::vector<TextureBarrier>& barriers, std::vector<vk::ImageMemoryBarrier2>& imageBarriers)
+        {
+            for (const TextureBarrier& barrier : barriers)
+            {
+                VulkanTextureData& tdata = m_GraphicsDevice.GetTextureData(barrier.texture);
+                VulkanCommon::ResourceStateInfo src = VulkanCommon::GetResourceStateInfo(barrier.before, tdata.desc.usage);
+                VulkanCommon::ResourceStateInfo dst = VulkanCommon::GetResourceStateInfo(barrier.after, tdata.desc.usage);
+
+                imageBarriers.push_back(VulkanCommon::GetImageBarrier(
+                    tdata.image,
+                    src.layout,
+                    dst.layout,
+                    src.access,
+                    dst.access,
+                    src.stages,
+                    dst.stages,
+                    VulkanCommon::GetImageAspect(tdata.desc.usage)
+                ));
+                SetTextureLayout(tdata, dst.layout);
+            }
         }
 
         // Begin/End* for Vulkan classes
-        void VulkanCommandBuffer::BeginRendering(VulkanTextureData* renderTarget, Vec4 clearColor, VulkanTextureData* depthBuffer)
+        void VulkanCommandBuffer::BeginRendering(
+            std::vector<VulkanRenderAttachment> colorAttachments,
+            const VulkanRenderAttachment& depthAttachment,
+            const std::vector<TextureBarrier>& barriers,
+            const std::string& name)
         {
-            ENGINE_CORE_ASSERT(m_CurrentRenderTarget == nullptr, "Vulkan: VulkanCommandBuffer: BeginRendering(): Already in a render pass!");
-            ENGINE_CORE_ASSERT(renderTarget != nullptr, "Vulkan: VulkanCommandBuffer: BeginRendering(): renderTarget is nullptr!");
+            ENGINE_CORE_ASSERT(!m_InRenderPass, "Vulkan: VulkanCommandBuffer: BeginRendering(): Already in a render pass!");
+            ENGINE_CORE_ASSERT(!colorAttachments.empty() || depthAttachment.texture != nullptr, "Vulkan: VulkanCommandBuffer: BeginRendering(): pass has no attachments!");
 
-            m_CurrentRenderTarget = renderTarget;
-            uint32_t width = m_CurrentRenderTarget->desc.width;
-            uint32_t height = m_CurrentRenderTarget->desc.height;
+            m_InRenderPass     = true;
+            m_ColorAttachments = std::move(colorAttachments);
+            m_DepthAttachment  = depthAttachment;
 
-            // We assume that the texture passed to us has TextureUsage::RenderTarget.
+            // We assume that textures passed to us have TextureUsage::RenderTarget or TextureUsage::DepthStencil.
+            VulkanTextureData* first = !m_ColorAttachments.empty() ? m_ColorAttachments.front().texture : m_DepthAttachment.texture;
+            m_RenderExtent = vk::Extent2D(first->desc.width, first->desc.height);
 
             m_CommandBuffer.begin({});
+            BeginPassScope(name);
+
+            // Declared barriers and attachment transitions go out as one batch
+            std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+            AddTextureBarriers(barriers, imageBarriers);
+
+            // Attachments without a declared barrier are transitioned from their tracked layout. Contents that
+            // aren't loaded are discarded. Loaded attachments first used here are expected in their attachment layout.
+            auto transitionAttachment = [&](const VulkanRenderAttachment& attachment, ResourceState state) {
+                VulkanTextureData* tdata = attachment.texture;
+                if (!attachment.swapChain && std::ranges::any_of(barriers, [&](const TextureBarrier& barrier) {
+                        return &m_GraphicsDevice.GetTextureData(barrier.texture) == tdata;
+                    }))
+                    return;
+
+                VulkanCommon::ResourceStateInfo src = VulkanCommon::GetResourceStateInfo(ResourceState::Undefined, tdata->desc.usage);
+                VulkanCommon::ResourceStateInfo dst = VulkanCommon::GetResourceStateInfo(state, tdata->desc.usage);
+                vk::ImageLayout oldLayout = attachment.loadOp == vk::AttachmentLoadOp::eLoad ? AcquireTextureLayout(*tdata, dst.layout) : vk::ImageLayout::eUndefined;
+
+                imageBarriers.push_back(VulkanCommon::GetImageBarrier(
+                    tdata->image,
+                    oldLayout,
+                    dst.layout,
+                    src.access,
+                    dst.access,
+                    src.stages,
+                    dst.stages,
+                    VulkanCommon::GetImageAspect(tdata->desc.usage)
+                ));
+                SetTextureLayout(*tdata, dst.layout);
+            };
+
+            for (const VulkanRenderAttachment& attachment : m_ColorAttachments)
+                transitionAttachment(attachment, ResourceState::RenderTarget);
+
+            if (m_DepthAttachment.texture != nullptr)
+                transitionAttachment(m_DepthAttachment, ResourceState::DepthWrite);
+
+            if (!imageBarriers.empty())
+                m_CommandBuffer.pipelineBarrier2(vk::DependencyInfo({}, {}, {}, imageBarriers));
+
+            BeginRenderingInstance(false, {});
+        }
 
-            // Transition current image for color attachment
-            VulkanCommon::TransitionImageLayout(
-                *m_CommandBuffer,
-                m_CurrentRenderTarget->image,
-                vk::ImageLayout::eUndefined,
-                vk::ImageLayout::eColorAttachmentOptimal,
-                {},
-                vk::AccessFlagBits2::eColorAttachmentWrite,
-                vk::PipelineStageFlagBits2::eColorAttachmentOutput,
-                vk::PipelineStageFlagBits2::eColorAttachmentOutput,
-                vk::ImageAspectFlagBits::eColor
-            );
+        void VulkanCommandBuffer::BeginRenderingInstance(bool resume, vk::RenderingFlags flags)
+        {
+            // Color attachments
+            std::vector<vk::RenderingAttachmentInfo> colorInfos;
+            colorInfos.reserve(m_ColorAttachments.size());
+            for (const VulkanRenderAttachment& attachment : m_ColorAttachments)
+            {
+                colorInfos.emplace_back(
+                    *attachment.texture->imageView,
+                    vk::ImageLayout::eColorAttachmentOptimal,
+                    vk::ResolveModeFlagBits::eNone,
+                    nullptr,
+                    vk::ImageLayout::eUndefined,
+                    resume ? vk::AttachmentLoadOp::eLoad : attachment.loadOp,
+                    vk::AttachmentStoreOp::eStore,
+                    attachment.clearValue
+                );
+            }
 
             // Rendering info
-            vk::ClearValue clr = vk::ClearColorValue(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
-            vk::RenderingAttachmentInfo attachmentInfo(
-                m_CurrentRenderTarget->imageView,
-                vk::ImageLayout::eColorAttachmentOptimal,
-                vk::ResolveModeFlagBits::eNone,
-                {},
-                vk::ImageLayout::eUndefined,
-                vk::AttachmentLoadOp::eClear,
-                vk::AttachmentStoreOp::eStore,
-                clr
-            );
-
             vk::RenderingInfo renderingInfo(
-                {},
-                {
-                    {0, 0},
-                    {width, height}
-                },
+                flags,
+                vk::Rect2D({0, 0}, m_RenderExtent),
                 1,
                 0,
-                1, &attachmentInfo
+                colorInfos
             );
 
             // Depth buffer
-            if (depthBuffer != nullptr)
+            vk::RenderingAttachmentInfo depthInfo;
+            if (m_DepthAttachment.texture != nullptr)
             {
-                // Transition depth image
-                VulkanCommon::TransitionImageLayout(
-                    *m_CommandBuffer,
-                    depthBuffer->image,
-                    vk::ImageLayout::eUndefined,
-                    vk::ImageLayout::eDepthStencilAttachmentOptimal,
-                    {},
-                    vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
-                    vk::PipelineStageFlagBits2::eEarlyFragmentTests,
-                    vk::PipelineStageFlagBits2::eEarlyFragmentTests,
-                    vk::ImageAspectFlagBits::eDepth
-                );
-
-                vk::ClearValue depthClear;
-                depthClear.depthStencil = vk::ClearDepthStencilValue(1.0f, 0);
-
-                vk::RenderingAttachmentInfo depthAttachment(
-                    *depthBuffer->imageView,
+                depthInfo = vk::RenderingAttachmentInfo(
+                    *m_DepthAttachment.texture->imageView,
                     vk::ImageLayout::eDepthStencilAttachmentOptimal,
                     vk::ResolveModeFlagBits::eNone,
-                    {},
+                    nullptr,
                     vk::ImageLayout::eUndefined,
-                    vk::AttachmentLoadOp::eClear,
+                    resume ? vk::AttachmentLoadOp::eLoad : m_DepthAttachment.loadOp,
                     vk::AttachmentStoreOp::eStore,
-                    depthClear
+                    m_DepthAttachment.clearValue
                 );
 
-                renderingInfo.pDepthAttachment = &depthAttachment;
+                renderingInfo.pDepthAttachment = &depthInfo;
             }
 
-            // Begin rendering & viewport
+            // Begin rendering & viewport. Secondary command buffers set their own
             m_CommandBuffer.beginRendering(renderingInfo);
-            m_CommandBuffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f));
-            m_CommandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), vk::Extent2D(width, height)));
+            if (!(flags & vk::RenderingFlagBits::eContentsSecondaryCommandBuffers))
+            {
+                m_CommandBuffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(m_RenderExtent.width), static_cast<float>(m_RenderExtent.height), 0.0f, 1.0f));
+                m_CommandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), m_RenderExtent));
+            }
         }
 
         void VulkanCommandBuffer::EndRendering()
         {
-            ENGINE_CORE_ASSERT(m_CurrentRenderTarget != nullptr, "Vulkan: VulkanCommandBuffer: BeginRendering(): Not in a render pass!");
+            ENGINE_CORE_ASSERT(m_InRenderPass, "Vulkan: VulkanCommandBuffer: EndRendering(): Not in a render pass!");
 
             m_CommandBuffer.endRendering();
 
-            VulkanCommon::TransitionImageLayout(
-                *m_CommandBuffer,
-                m_CurrentRenderTarget->image,
-                vk::ImageLayout::eColorAttachmentOptimal,
-                vk::ImageLayout::ePresentSrcKHR,
-                vk::AccessFlagBits2::eColorAttachmentWrite,
+            // Swapchain images are presented, offscreen ones are left to be copied out. Textures stay in their
+            // attachment layout until the next barrier
+            for (const VulkanRenderAttachment& attachment : m_ColorAttachments)
+            {
+                if (!attachment.swapChain)
+                    continue;
+
+                vk::ImageLayout layout = attachment.offscreen ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR;
+                VulkanCommon::TransitionImageLayout(
+                    *m_CommandBuffer,
+                    attachment.texture->image,
+                    vk::ImageLayout::eColorAttachmentOptimal,
+                    layout,
+                    vk::AccessFlagBits2::eColorAttachmentWrite,
+                    attachment.offscreen ? vk::AccessFlagBits2::eTransferRead : vk::AccessFlags2{},
+                    vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                    attachment.offscreen ? vk::PipelineStageFlagBits2::eAllTransfer : vk::PipelineStageFlagBits2::eBottomOfPipe,
+                    vk::ImageAspectFlagBits::eColor
+                );
+                SetTextureLayout(*attachment.texture, layout);
+            }
+
+            EndPassScope();
+            m_CommandBuffer.end();
+            m_InRenderPass = false;
+            m_ColorAttachments.clear();
+            m_DepthAttachment = {};
+        }
+
+        void VulkanCommandBuffer::BeginBundle(VulkanCommandBundle* bundle)
+        {
+            m_Bundle = bundle;
+
+            // Formats must match the rendering instance the bundle is executed in
+            vk::Format colorFormat = bundle->GetColorFormat();
+            vk::CommandBufferInheritanceRenderingInfo renderingInfo(
                 {},
-                vk::PipelineStageFlagBits2::eColorAttachmentOutput,
-                vk::PipelineStageFlagBits2::eBottomOfPipe,
-                vk::ImageAspectFlagBits::eColor
+                0,
+                colorFormat,
+                bundle->GetDepthFormat(),
+                vk::Format::eUndefined,
+                vk::SampleCountFlagBits::e1
+            );
+
+            vk::CommandBufferInheritanceInfo inheritanceInfo;
+            inheritanceInfo.pNext = &renderingInfo;
+
+            // Passes may execute the bundle inside their statistics query
+            if (m_GraphicsDevice.GetCapabilities().pipelineStatisticsQueries)
+                inheritanceInfo.pipelineStatistics = VulkanFrameProfiler::k_PipelineStatistics;
+
+            // Executed by every frame in flight at once
+            vk::CommandBufferBeginInfo beginInfo(
+                vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eSimultaneousUse,
+                &inheritanceInfo
             );
+            m_CommandBuffer.begin(beginInfo);
 
+            // Viewport and scissor are not inherited
+            vk::Extent2D extent = bundle->m_Extent;
+            m_CommandBuffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f));
+            m_CommandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
+        }
+
+        void VulkanCommandBuffer::EndBundle()
+        {
             m_CommandBuffer.end();
-            m_CurrentRenderTarget = nullptr;
+            m_Bundle = nullptr;
+        }
+
+        void VulkanCommandBuffer::BeginCompute(const std::vector<TextureBarrier>& barriers, const std::string& name)
+        {
+            m_CommandBuffer.begin({});
+            m_InComputePass = true;
+            BeginPassScope(name);
+
+            // Earlier passes may still read what this pass writes, or have written what it reads
+            vk::MemoryBarrier2 barrier(
+                vk::PipelineStageFlagBits2::eAllGraphics | vk::PipelineStageFlagBits2::eComputeShader,
+                vk::AccessFlagBits2::eMemoryWrite,
+                vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect,
+                vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite | vk::AccessFlagBits2::eIndirectCommandRead
+            );
+
+            std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+            AddTextureBarriers(barriers, imageBarriers);
+
+            m_CommandBuffer.pipelineBarrier2(vk::DependencyInfo({}, barrier, {}, imageBarriers));
+        }
+
+        void VulkanCommandBuffer::EndCompute()
+        {
+            ENGINE_CORE_ASSERT(m_InComputePass, "Vulkan: VulkanCommandBuffer: EndCompute(): Not in a compute pass!");
+
+            // Make storage writes visible to everything submitted after this pass: indirect args, vertex/index input and shader reads
+            vk::MemoryBarrier2 barrier(
+                vk::PipelineStageFlagBits2::eComputeShader,
+                vk::AccessFlagBits2::eShaderStorageWrite,
+                vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eVertexInput |
+                vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eFragmentShader |
+                vk::PipelineStageFlagBits2::eComputeShader,
+                vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eVertexAttributeRead |
+                vk::AccessFlagBits2::eIndexRead | vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eUniformRead
+            );
+            m_CommandBuffer.pipelineBarrier2(vk::DependencyInfo({}, barrier));
+
+            EndPassScope();
+            m_CommandBuffer.end();
+            m_InComputePass = false;
+        }
+
+        void VulkanCommandBuffer::BeginTransfer(const std::string& name)
+        {
+            m_CommandBuffer.begin({});
+            BeginPassScope(name);
+        }
+
+        void VulkanCommandBuffer::EndTransfer()
+        {
+            EndPassScope();
+            m_CommandBuffer.end();
+        }
+
+        void VulkanCommandBuffer::CopyTextureToReadback(VulkanTextureData& tdata, const vk::BufferImageCopy& region, vk::Buffer readback)
+        {
+            // Readbacks are recorded on their own, so the device moves the texture to eTransferSrcOptimal before the
+            // copy and back after it. Offscreen swapchain images are already there, made available by their pass
+            vk::ImageLayout layout = AcquireTextureLayout(tdata, vk::ImageLayout::eTransferSrcOptimal, true);
+            vk::ImageAspectFlags aspect = region.imageSubresource.aspectMask;
+            if (layout != vk::ImageLayout::eTransferSrcOptimal)
+            {
+                VulkanCommon::TransitionImageLayout(
+                    *m_CommandBuffer,
+                    tdata.image,
+                    layout,
+                    vk::ImageLayout::eTransferSrcOptimal,
+                    vk::AccessFlagBits2::eMemoryWrite,
+                    vk::AccessFlagBits2::eTransferRead,
+                    vk::PipelineStageFlagBits2::eAllCommands,
+                    vk::PipelineStageFlagBits2::eAllTransfer,
+                    aspect
+                );
+            }
+
+            m_CommandBuffer.copyImageToBuffer(tdata.image, vk::ImageLayout::eTransferSrcOptimal, readback, region);
+
+            // Later passes expect the layout the texture was tracked in
+            if (layout != vk::ImageLayout::eTransferSrcOptimal)
+            {
+                VulkanCommon::TransitionImageLayout(
+                    *m_CommandBuffer,
+                    tdata.image,
+                    vk::ImageLayout::eTransferSrcOptimal,
+                    layout,
+                    {},
+                    vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+                    vk::PipelineStageFlagBits2::eAllTransfer,
+                    vk::PipelineStageFlagBits2::eAllCommands,
+                    aspect
+                );
+            }
+
+            vk::MemoryBarrier2 hostBarrier(
+                vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite,
+                vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead
+            );
+            m_CommandBuffer.pipelineBarrier2(vk::DependencyInfo({}, hostBarrier));
+        }
+
+        void VulkanCommandBuffer::CopyBufferToReadback(vk::Buffer buffer, size_t offset, size_t size, vk::Buffer readback)
+        {
+            vk::MemoryBarrier2 barrier(
+                vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryWrite,
+                vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferRead
+            );
+            m_CommandBuffer.pipelineBarrier2(vk::DependencyInfo({}, barrier));
+
+            m_CommandBuffer.copyBuffer(buffer, readback, vk::BufferCopy(offset, 0, size));
+
+            vk::MemoryBarrier2 hostBarrier(
+                vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite,
+                vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead
+            );
+            m_CommandBuffer.pipelineBarrier2(vk::DependencyInfo({}, hostBarrier));
         }
 
         void VulkanCommandBuffer::BeginImmediate()
@@ -468,15 +1176,79 @@ namespace Engine::RHI::Vulkan
             m_CommandBuffer.end();
         }
 
+        // Profiling
+        void VulkanCommandBuffer::BeginPassScope(const std::string& name)
+        {
+            if constexpr (k_EnableValidationLayers)
+                m_CommandBuffer.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT(name.c_str()));
+
+            m_Profiler = m_GraphicsDevice.GetCurrentFrame()->GetProfiler();
+            if (m_Profiler)
+                m_PassScope = m_Profiler->BeginScope(*m_CommandBuffer, name, VulkanFrameProfiler::k_InvalidScope, m_SubmissionIndex, true);
+        }
+
+        void VulkanCommandBuffer::EndPassScope()
+        {
+            ENGINE_CORE_ASSERT(m_MarkerScopes.empty(), "Vulkan: VulkanCommandBuffer: pass ended with open markers!");
+
+            if (m_Profiler)
+                m_Profiler->EndScope(*m_CommandBuffer, m_PassScope);
+
+            if constexpr (k_EnableValidationLayers)
+                m_CommandBuffer.endDebugUtilsLabelEXT();
+
+            m_Profiler  = nullptr;
+            m_PassScope = ~0u;
+        }
+
+        void VulkanCommandBuffer::BeginMarker(const char* name)
+        {
+            if constexpr (k_EnableValidationLayers)
+                m_CommandBuffer.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT(name));
+
+            // Bundles are replayed in many frames, so they can't hold this frame's queries. Markers under an untimed
+            // scope aren't timed either
+            uint32_t scope = VulkanFrameProfiler::k_InvalidScope;
+            uint32_t parent = m_MarkerScopes.empty() ? m_PassScope : m_MarkerScopes.back();
+            if (m_Profiler && m_Bundle == nullptr && parent != VulkanFrameProfiler::k_InvalidScope)
+                scope = m_Profiler->BeginScope(*m_CommandBuffer, name, parent, m_SubmissionIndex, false);
+
+            m_MarkerScopes.push_back(scope);
+        }
+
+        void VulkanCommandBuffer::EndMarker()
+        {
+            ENGINE_CORE_ASSERT(!m_MarkerScopes.empty(), "Vulkan: VulkanCommandBuffer: EndMarker(): no open marker!");
+
+            if (m_Profiler)
+                m_Profiler->EndScope(*m_CommandBuffer, m_MarkerScopes.back());
+            m_MarkerScopes.pop_back();
+
+            if constexpr (k_EnableValidationLayers)
+                m_CommandBuffer.endDebugUtilsLabelEXT();
+        }
+
         // Resetter for Vulkan classes
         void VulkanCommandBuffer::Reset()
         {
-            m_CurrentRenderTarget = nullptr;
-            m_BoundPipelineHandle = PipelineHandle{.id = 0};
+            m_InRenderPass = false;
+            m_ColorAttachments.clear();
+            m_DepthAttachment = {};
+            m_Bundle = nullptr;
+            m_InComputePass = false;
+            m_SubmissionIndex = 0;
+            m_SwapChain = SwapChainHandle{.id = 0};
+            m_Profiler = nullptr;
+            m_PassScope = ~0u;
+            m_MarkerScopes.clear();
+            m_Counters = {};
+            m_TextureLayouts.clear();
+            ResetBoundState();
         
             // Clear staging buffer allocations
             for(StagingBufferAllocation& alloc : m_StagingBufferAllocations)
             {
+                m_GraphicsDevice.GetContext().UntrackAllocation(VulkanMemoryCategory::Staging, alloc.allocation);
                 vmaDestroyBuffer(m_GraphicsDevice.GetContext().GetAllocator(), alloc.buffer, alloc.allocation);
             }
             m_StagingBufferAllocations.clear();
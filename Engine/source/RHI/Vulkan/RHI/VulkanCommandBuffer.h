@@ -5,6 +5,14 @@
 
 #include "Engine/Math/Vector.h"
 
+#include "RHI/Vulkan/VulkanConstants.h"
+#include "RHI/Vulkan/VulkanDescriptorSetAllocator.h"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
 #include <vulkan/vulkan_raii.hpp>
 #include <vk_mem_alloc.h>
 
@@ -13,6 +21,17 @@ namespace Engine::RHI::Vulkan
     // Forward
     class VulkanGraphicsDevice;
     class VulkanTextureData;
+    class VulkanCommandBundle;
+    class VulkanFrameProfiler;
+
+    // Attachment of a render pass, resolved by the device
+    struct VulkanRenderAttachment {
+        VulkanTextureData*   texture   = nullptr;
+        vk::AttachmentLoadOp loadOp    = vk::AttachmentLoadOp::eClear;
+        vk::ClearValue       clearValue;
+        bool                 swapChain = false; // Acquired swapchain image, presented after the pass
+        bool                 offscreen = false; // Swapchain image of an offscreen swapchain, left ready to be copied
+    };
 
     class ENGINE_EXPORT VulkanCommandBuffer : public ICommandBuffer
     {
@@ -22,10 +41,79 @@ namespace Engine::RHI::Vulkan
         // Vulkan
         VulkanGraphicsDevice& m_GraphicsDevice;
         vk::raii::CommandBuffer m_CommandBuffer = nullptr;
+        VulkanDescriptorSetAllocator& m_DescriptorSetAllocator; // Owned by the recording thread's pool
 
         // State
-        VulkanTextureData*  m_CurrentRenderTarget = nullptr;
+        bool                                m_InRenderPass = false;
+        std::vector<VulkanRenderAttachment> m_ColorAttachments;
+        VulkanRenderAttachment              m_DepthAttachment; // texture is nullptr without depth
+        vk::Extent2D                        m_RenderExtent;
         PipelineHandle      m_BoundPipelineHandle;
+        bool                m_InComputePass = false;
+
+        // Pass bookkeeping, set by the device in BeginPass()
+        uint32_t            m_SubmissionIndex = 0;  // Slot in the frame's submit order
+        SwapChainHandle     m_SwapChain;            // Presented swapchain, if any
+
+        // Bundle being recorded. Referenced resources are reported to it so it can be invalidated
+        VulkanCommandBundle* m_Bundle = nullptr;
+
+        // GPU timing scopes of the pass and its open markers. Null profiler outside of frame passes
+        VulkanFrameProfiler*  m_Profiler  = nullptr;
+        uint32_t              m_PassScope = ~0u;
+        std::vector<uint32_t> m_MarkerScopes;
+
+        // Merged into the frame's counters when the pass ends
+        CommandCounters m_Counters;
+
+        void BeginPassScope(const std::string& name);
+        void EndPassScope();
+
+        // Descriptor state. Bindings are collected here and resolved to a descriptor set at the next draw,
+        // so each draw keeps the resources that were bound when it was recorded.
+        VulkanDescriptorSetKey                           m_DescriptorKey;
+        std::array<VulkanDescriptorWrite, k_MaxBindings> m_DescriptorWrites = {};
+        std::array<uint32_t, k_MaxBindings>              m_DynamicOffsets   = {}; // Indexed by binding
+        bool                                             m_DescriptorsDirty = false;
+
+        void ResetDescriptorState(uint32_t layoutId);
+        void FlushDescriptors();
+
+        // Shadow of what is bound in m_CommandBuffer, so binding the same state again records nothing.
+        // Static buffers are matched by handle, dynamic ones by the allocation they resolve to.
+        struct BoundBuffer {
+            uint32_t   id       = 0;
+            bool       isStatic = false;
+            vk::Buffer buffer   = nullptr;
+            size_t     offset   = 0;
+        };
+        BoundBuffer                         m_BoundVertexBuffer;
+        BoundBuffer                         m_BoundIndexBuffer;
+        vk::DescriptorSet                   m_BoundDescriptorSet = nullptr; // Cleared with the descriptor state
+        std::array<uint32_t, k_MaxBindings> m_BoundDynamicOffsets = {};     // In binding order
+
+        // Forgets the shadow where Vulkan leaves bound state undefined
+        void ResetBoundState();
+
+        // Layouts of the textures this command buffer uses. Passes are recorded in parallel and submitted later, so the
+        // shared VulkanTextureData::layout is never read here. The first use that depends on a texture's layout records
+        // the layout it expects instead, and the device puts the texture there when it resolves submissions in order.
+        struct TextureLayoutState {
+            vk::ImageLayout expected = vk::ImageLayout::eUndefined; // Needed before this command buffer runs, eUndefined if any will do
+            vk::ImageLayout current  = vk::ImageLayout::eUndefined; // Left by this command buffer
+            bool            restore  = false;                       // Hand the texture back in the layout it came in
+        };
+        std::unordered_map<VulkanTextureData*, TextureLayoutState> m_TextureLayouts;
+
+        // Layout of tdata at this point of the recording. The first use expects it in expected
+        vk::ImageLayout AcquireTextureLayout(VulkanTextureData& tdata, vk::ImageLayout expected, bool restore = false);
+        void SetTextureLayout(VulkanTextureData& tdata, vk::ImageLayout layout);
+
+        // Appends barriers for declared transitions and updates the tracked layouts
+        void AddTextureBarriers(const std::vector<TextureBarrier>& barriers, std::vector<vk::ImageMemoryBarrier2>& imageBarriers);
+
+        // Buffer and offset that indirect arguments are read from
+        vk::Buffer GetIndirectBuffer(BufferHandle buffer, size_t& offset);
 
         // Staging buffer
         struct StagingBufferAllocation {
@@ -34,14 +122,40 @@ namespace Engine::RHI::Vulkan
         };
         std::vector<StagingBufferAllocation> m_StagingBufferAllocations;
 
+        // Texture uploads. Levels are left in eTransferDstOptimal, blit sources in eTransferSrcOptimal
+        void UploadTextureLevels(VulkanTextureData& tdata, const std::vector<void*>& levels);
+        void GenerateMips(VulkanTextureData& tdata);
+        void TransitionToShaderRead(VulkanTextureData& tdata, bool generatedMips);
+
+        // Readbacks. Copies wait for all earlier writes and are made visible to the host. Textures keep their layout
+        void CopyTextureToReadback(VulkanTextureData& tdata, const vk::BufferImageCopy& region, vk::Buffer readback);
+        void CopyBufferToReadback(vk::Buffer buffer, size_t offset, size_t size, vk::Buffer readback);
+
         // Begin/End* for Vulkan classes
-        void BeginRendering(VulkanTextureData* renderTarget, Vec4 clearColor, VulkanTextureData* depthBuffer);
+        void BeginRendering(
+            std::vector<VulkanRenderAttachment> colorAttachments,
+            const VulkanRenderAttachment& depthAttachment,
+            const std::vector<TextureBarrier>& barriers,
+            const std::string& name
+        );
         void EndRendering();
+        void BeginRenderingInstance(bool resume, vk::RenderingFlags flags); // resume loads every attachment
+        void BeginCompute(const std::vector<TextureBarrier>& barriers, const std::string& name);
+        void BeginBundle(VulkanCommandBundle* bundle);
+        void EndBundle();
+        void EndCompute();
+        void BeginTransfer(const std::string& name);
+        void EndTransfer();
         void BeginImmediate();
         void EndImmediate();
 
     public:
-        VulkanCommandBuffer(VulkanGraphicsDevice& graphicsDevice, vk::CommandPool commandPool);
+        VulkanCommandBuffer(
+            VulkanGraphicsDevice& graphicsDevice,
+            vk::CommandPool commandPool,
+            VulkanDescriptorSetAllocator& descriptorSetAllocator,
+            vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary
+        );
         ~VulkanCommandBuffer() override = default;
 
         // Graphics
@@ -50,15 +164,38 @@ namespace Engine::RHI::Vulkan
         void BindIndexBuffer(BufferHandle buffer) override;
         void BindUniformBuffer(BufferHandle buffer, uint32_t binding) override;
         void BindTexture(TextureHandle texture, uint32_t binding) override;
+        void PushConstants(ShaderStage stage, uint32_t offset, uint32_t size, const void* data) override;
+        void BindStorageBuffer(BufferHandle buffer, uint32_t binding) override;
+        void BindStorageTexture(TextureHandle texture, uint32_t binding) override;
         void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) override;
         void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t indexOffset = 0, uint32_t firstInstance = 0) override;
+
+        void DrawIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride = sizeof(DrawIndirectCommand)) override;
+        void DrawIndexedIndirect(BufferHandle buffer, size_t offset, uint32_t drawCount, uint32_t stride = sizeof(DrawIndexedIndirectCommand)) override;
+        void DrawIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride = sizeof(DrawIndirectCommand)) override;
+        void DrawIndexedIndirectCount(BufferHandle buffer, size_t offset, BufferHandle countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride = sizeof(DrawIndexedIndirectCommand)) override;
+
+        void ExecuteBundle(ICommandBundle* bundle) override;
+
+        // Markers
+        void BeginMarker(const char* name) override;
+        void EndMarker() override;
+
+        // Compute
+        void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) override;
+        void DispatchIndirect(BufferHandle buffer, size_t offset = 0) override;
+        void ComputeBarrier() override;
    
         // Data
         void UploadBuffer(BufferHandle buffer, void* data, size_t size, size_t offset) override;
+        void* MapDynamic(BufferHandle buffer, size_t size) override;
         void UploadTexture(TextureHandle texture, void* data) override;
+        void UploadTextureMips(TextureHandle texture, const std::vector<void*>& levels) override;
 
         // Public getters for Vulkan classes
         vk::raii::CommandBuffer& GetCommandBuffer() { return m_CommandBuffer; }
+        bool IsComputePass() const { return m_InComputePass; }
+        const CommandCounters& GetCounters() const { return m_Counters; }
 
         // Resetter for Vulkan classes
         void Reset();
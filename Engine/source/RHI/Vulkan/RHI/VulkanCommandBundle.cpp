@@ -0,0 +1,120 @@
+#include "RHI/Vulkan/RHI/VulkanCommandBundle.h"
+#include "RHI/Vulkan/RHI/VulkanCommandBuffer.h"
+#include "RHI/Vulkan/RHI/VulkanGraphicsDevice.h"
+#include "RHI/Vulkan/VulkanDescriptorSetAllocator.h"
+#include "Engine/Core/Assert.h"
+
+namespace Engine::RHI::Vulkan
+{
+    VulkanCommandBundle::VulkanCommandBundle(VulkanGraphicsDevice& graphicsDevice, uint32_t id, const CommandBundleDesc& desc)
+        : m_GraphicsDevice(graphicsDevice), m_ID(id), m_Desc(desc)
+    {
+        ENGINE_CORE_ASSERT(desc.swapChain.IsValid(), "Vulkan: VulkanCommandBundle: swapChain is invalid!");
+    }
+
+    VulkanCommandBundle::~VulkanCommandBundle() = default;
+
+    Scope<VulkanCommandBundle::Recording> VulkanCommandBundle::CreateRecording()
+    {
+        VulkanContext& context = m_GraphicsDevice.GetContext();
+
+        Scope<Recording> recording = CreateScope<Recording>();
+
+        vk::CommandPoolCreateInfo poolInfo({}, context.GetGraphicsQueue().familyIndex);
+        recording->commandPool = vk::raii::CommandPool(context.GetDevice(), poolInfo);
+        recording->descriptorSetAllocator = CreateScope<VulkanDescriptorSetAllocator>(context);
+        recording->commandBuffer = CreateScope<VulkanCommandBuffer>(
+            m_GraphicsDevice,
+            *recording->commandPool,
+            *recording->descriptorSetAllocator,
+            vk::CommandBufferLevel::eSecondary
+        );
+
+        return recording;
+    }
+
+    ICommandBuffer* VulkanCommandBundle::Begin()
+    {
+        ENGINE_CORE_ASSERT(!m_IsRecording, "Vulkan: VulkanCommandBundle: Begin(): already recording!");
+
+        // Free retired recordings the GPU is done with
+        uint64_t completed = m_GraphicsDevice.GetCompletedTimelineValue();
+        std::erase_if(m_RetiredRecordings, [completed](const Scope<Recording>& recording) {
+            return recording->lastUse <= completed;
+        });
+
+        // The current recording may still be executing, retire it instead of resetting under the GPU
+        uint64_t lastUse = m_LastUse.load(std::memory_order_relaxed);
+        if (m_Recording && lastUse > completed)
+        {
+            m_Recording->lastUse = lastUse;
+            m_RetiredRecordings.push_back(std::move(m_Recording));
+        }
+
+        if (m_Recording)
+        {
+            m_Recording->commandPool.reset();
+            m_Recording->descriptorSetAllocator->Reset();
+        }
+        else
+        {
+            m_Recording = CreateRecording();
+        }
+
+        // Snapshot the target
+        VulkanSwapChainData& sc = m_GraphicsDevice.GetSwapChainData(m_Desc.swapChain);
+        m_Extent      = sc.extent;
+        m_ColorFormat = sc.surfaceFormat.format;
+        m_DepthFormat = vk::Format::eUndefined;
+
+        {
+            std::lock_guard<std::mutex> lock(m_TrackingMutex);
+            m_Buffers.clear();
+            m_Textures.clear();
+            m_Pipelines.clear();
+            m_Invalidated = false;
+        }
+
+        if (m_Desc.depthBuffer.IsValid())
+        {
+            m_DepthFormat = m_GraphicsDevice.GetTextureData(m_Desc.depthBuffer).format;
+            TrackTexture(m_Desc.depthBuffer.id);
+        }
+
+        m_LastUse.store(0, std::memory_order_relaxed);
+        m_IsRecording = true;
+        m_Recorded    = false;
+
+        VulkanCommandBuffer* cmd = m_Recording->commandBuffer.get();
+        cmd->Reset();
+        cmd->BeginBundle(this);
+        return cmd;
+    }
+
+    void VulkanCommandBundle::End()
+    {
+        ENGINE_CORE_ASSERT(m_IsRecording, "Vulkan: VulkanCommandBundle: End(): not recording!");
+
+        m_Recording->commandBuffer->EndBundle();
+        m_IsRecording = false;
+        m_Recorded    = true;
+    }
+
+    bool VulkanCommandBundle::IsValid() const
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_TrackingMutex);
+            if (!m_Recorded || m_Invalidated)
+                return false;
+        }
+
+        // A rebuilt swapchain may have a new size or format
+        VulkanSwapChainData& sc = m_GraphicsDevice.GetSwapChainData(m_Desc.swapChain);
+        return sc.extent == m_Extent && sc.surfaceFormat.format == m_ColorFormat;
+    }
+
+    vk::CommandBuffer VulkanCommandBundle::GetCommandBuffer() const
+    {
+        return *m_Recording->commandBuffer->GetCommandBuffer();
+    }
+} // namespace Engine::RHI::Vulkan
@@ -0,0 +1,99 @@
+#ifndef RHI_VULKAN_RHI_VULKANCOMMANDBUNDLE
+#define RHI_VULKAN_RHI_VULKANCOMMANDBUNDLE
+
+#include "engine_export.h"
+
+#include "Engine/Core/Base.h"
+
+#include "Engine/RHI/ICommandBundle.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <unordered_set>
+
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Engine::RHI::Vulkan
+{
+    // Forward
+    class VulkanGraphicsDevice;
+    class VulkanCommandBuffer;
+    class VulkanDescriptorSetAllocator;
+
+    // Secondary command buffer recorded against a swapchain's formats with dynamic rendering inheritance.
+    // Owns its command pool and descriptor sets, so it lives across frames and can be recorded on any thread.
+    class ENGINE_EXPORT VulkanCommandBundle : public ICommandBundle
+    {
+    private:
+        friend class VulkanGraphicsDevice;
+        friend class VulkanCommandBuffer;
+
+        VulkanGraphicsDevice& m_GraphicsDevice;
+        uint32_t              m_ID;
+        CommandBundleDesc     m_Desc;
+
+        // Everything a recording needs. Re-recording while the GPU may still execute the previous one retires it
+        // until the frame timeline passes its last use.
+        struct Recording {
+            vk::raii::CommandPool               commandPool = nullptr;
+            Scope<VulkanDescriptorSetAllocator> descriptorSetAllocator;
+            Scope<VulkanCommandBuffer>          commandBuffer;
+            uint64_t                            lastUse = 0; // Frame timeline value, set when retired
+        };
+        Scope<Recording>              m_Recording;
+        std::vector<Scope<Recording>> m_RetiredRecordings;
+
+        // Last frame timeline value that executes the current recording. Passes may execute the bundle in parallel
+        std::atomic<uint64_t> m_LastUse = 0;
+
+        // State
+        bool m_IsRecording = false;
+        bool m_Recorded    = false;
+        bool m_Invalidated = false;
+
+        // Target the recording was made for
+        vk::Extent2D m_Extent;
+        vk::Format   m_ColorFormat = vk::Format::eUndefined;
+        vk::Format   m_DepthFormat = vk::Format::eUndefined;
+
+        // Resources referenced by the current recording. The recording thread inserts while the device's Destroy*()
+        // may look them up from another, so they and m_Invalidated are guarded by m_TrackingMutex
+        std::unordered_set<uint32_t> m_Buffers;
+        std::unordered_set<uint32_t> m_Textures;
+        std::unordered_set<uint32_t> m_Pipelines;
+        mutable std::mutex           m_TrackingMutex;
+
+        Scope<Recording> CreateRecording();
+
+    public:
+        VulkanCommandBundle(VulkanGraphicsDevice& graphicsDevice, uint32_t id, const CommandBundleDesc& desc);
+        ~VulkanCommandBundle() override;
+
+        ICommandBuffer* Begin() override;
+        void End() override;
+        bool IsValid() const override;
+
+        // Tracking for Vulkan classes
+        void TrackBuffer(uint32_t id)   { std::lock_guard<std::mutex> lock(m_TrackingMutex); m_Buffers.insert(id); }
+        void TrackTexture(uint32_t id)  { std::lock_guard<std::mutex> lock(m_TrackingMutex); m_Textures.insert(id); }
+        void TrackPipeline(uint32_t id) { std::lock_guard<std::mutex> lock(m_TrackingMutex); m_Pipelines.insert(id); }
+        void MarkUsed(uint64_t timelineValue) { m_LastUse.store(timelineValue, std::memory_order_relaxed); }
+
+        // Called by the device when a resource is destroyed
+        void OnBufferDestroyed(uint32_t id)    { std::lock_guard<std::mutex> lock(m_TrackingMutex); if (m_Buffers.contains(id)) m_Invalidated = true; }
+        void OnTextureDestroyed(uint32_t id)   { std::lock_guard<std::mutex> lock(m_TrackingMutex); if (m_Textures.contains(id)) m_Invalidated = true; }
+        void OnPipelineDestroyed(uint32_t id)  { std::lock_guard<std::mutex> lock(m_TrackingMutex); if (m_Pipelines.contains(id)) m_Invalidated = true; }
+        void OnSwapChainDestroyed(uint32_t id) { std::lock_guard<std::mutex> lock(m_TrackingMutex); if (m_Desc.swapChain.id == id) m_Invalidated = true; }
+
+        // Getters for Vulkan classes
+        uint32_t GetID() const { return m_ID; }
+        const CommandBundleDesc& GetDesc() const { return m_Desc; }
+        vk::Format GetColorFormat() const { return m_ColorFormat; }
+        vk::Format GetDepthFormat() const { return m_DepthFormat; }
+        vk::CommandBuffer GetCommandBuffer() const;
+    };
+} // namespace Engine::RHI::Vulkan
+
+#endif // RHI_VULKAN_RHI_VULKANCOMMANDBUNDLE
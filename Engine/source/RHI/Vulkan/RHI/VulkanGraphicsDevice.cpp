@@ -3,41 +3,97 @@
 #include "RHI/Vulkan/IVulkanGraphicsBridge.h"
 #include "RHI/Vulkan/VulkanCommon.h"
 #include "RHI/Vulkan/VulkanFrame.h"
+#include "RHI/Vulkan/VulkanDescriptorSetAllocator.h"
+#include "RHI/Vulkan/VulkanReadbackRing.h"
 #include "RHI/Vulkan/RHI/VulkanCommandBuffer.h"
+#include "RHI/Vulkan/RHI/VulkanCommandBundle.h"
 #include "Engine/Platform/IWindow.h"
 #include "Engine/Core/Assert.h"
 #include "Engine/Core/Log.h"
+#include "Engine/Core/Hash.h"
+
+#include <bit>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <format>
 
 namespace Engine::RHI::Vulkan
 {
-    VulkanGraphicsDevice::VulkanGraphicsDevice(Scope<IVulkanGraphicsBridge> bridge)
+    VulkanGraphicsDevice::VulkanGraphicsDevice(Scope<IVulkanGraphicsBridge> bridge, const GraphicsDeviceDesc& desc)
         : m_Bridge(std::move(bridge)),
-          m_Context(m_Bridge.get()),
+          m_Context(m_Bridge.get(), desc.pipelineCachePath),
+          m_Desc(desc),
           m_FrameIndex(0)
     {
+        // Validate config
+        if(m_Desc.framesInFlight < 1 || m_Desc.framesInFlight > k_MaxFramesInFlight)
+        {
+            LOG_CORE_WARN("Vulkan: VulkanGraphicsDevice: framesInFlight must be between 1 and {0}, got {1}. Clamping.", k_MaxFramesInFlight, m_Desc.framesInFlight);
+            m_Desc.framesInFlight = std::clamp<uint32_t>(m_Desc.framesInFlight, 1, k_MaxFramesInFlight);
+        }
+
+        // GPU timings
+        const DeviceCapabilities& capabilities = m_Context.GetCapabilities();
+        bool profiling = m_Desc.gpuProfiling && capabilities.timestampQueries;
+        bool pipelineStatistics = profiling && m_Desc.pipelineStatistics && capabilities.pipelineStatisticsQueries;
+        if (m_Desc.gpuProfiling && !profiling)
+            LOG_CORE_WARN("Vulkan: VulkanGraphicsDevice: gpuProfiling requested but timestamp queries are not supported");
+        if (m_Desc.pipelineStatistics && !pipelineStatistics)
+            LOG_CORE_WARN("Vulkan: VulkanGraphicsDevice: pipelineStatistics requested but not available");
+
         // Create frames
-        for(uint32_t i = 0; i < k_MaxFramesInFlight; i++)
+        for(uint32_t i = 0; i < m_Desc.framesInFlight; i++)
         {
-            m_Frames.push_back(CreateScope<VulkanFrame>(m_Context));
+            m_Frames.push_back(CreateScope<VulkanFrame>(m_Context, profiling, pipelineStatistics));
         }
 
+        // Frame timeline semaphore
+        vk::SemaphoreTypeCreateInfo timelineInfo(vk::SemaphoreType::eTimeline, 0);
+        vk::SemaphoreCreateInfo semaphoreInfo;
+        semaphoreInfo.pNext = &timelineInfo;
+        m_FrameTimeline = vk::raii::Semaphore(m_Context.GetDevice(), semaphoreInfo);
+
         // Immediate commands
         vk::CommandPoolCreateInfo poolInfo(
             vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
             m_Context.GetGraphicsQueue().familyIndex
         );
         m_ImmediatePool = vk::raii::CommandPool(m_Context.GetDevice(), poolInfo);
-        m_ImmediateCommandBuffer = CreateScope<VulkanCommandBuffer>(*this, *m_ImmediatePool);
+        m_ImmediateDescriptorSetAllocator = CreateScope<VulkanDescriptorSetAllocator>(m_Context);
+        m_ImmediateCommandBuffer = CreateScope<VulkanCommandBuffer>(*this, *m_ImmediatePool, *m_ImmediateDescriptorSetAllocator);
 
         // Immediate fence
         vk::FenceCreateInfo fenceInfo{};
         m_ImmediateFence = vk::raii::Fence(m_Context.GetDevice(), fenceInfo);
+
+        // Readbacks
+        m_ReadbackRing = CreateScope<VulkanReadbackRing>(m_Context);
+
+        // Deferred frees
+        m_ResourceReleaser = CreateScope<VulkanResourceReleaser>(m_Context, m_Desc.backgroundFrees);
+
+        // Pipeline compilation
+        m_PipelineCompiler = CreateScope<VulkanPipelineCompiler>(m_Context, m_Desc.pipelineCompileThreads);
+        if(!m_Desc.pipelineManifestPath.empty() && m_PipelineManifest.Load(m_Desc.pipelineManifestPath))
+        {
+            LOG_CORE_INFO("Vulkan: VulkanGraphicsDevice: Loaded pipeline manifest with {0} entries", m_PipelineManifest.GetSize());
+        }
     }
 
     VulkanGraphicsDevice::~VulkanGraphicsDevice()
     {
         m_Context.GetDevice().waitIdle();
 
+        // Finish outstanding compiles before anything they reference is destroyed
+        m_PipelineCompiler.reset();
+
+        // Bundles hold command pools and descriptor pools of their own
+        m_CommandBundles.clear();
+
+        m_ReadbackRing.reset();
+
         // Destroy all buffers and textures because they are non-raii
         for(auto const& [id, data] : m_Buffers)
         {
@@ -49,12 +105,19 @@ namespace Engine::RHI::Vulkan
             EnqueueDeletion(QueuedDestruction::Type::Texture, id);
         }
 
+        // Heaps after textures, so placed textures are gone first
+        for(auto const& [id, data] : m_Heaps)
+        {
+            EnqueueDeletion(QueuedDestruction::Type::Heap, id);
+        }
+
         for(auto const& [id, data] : m_SwapChains)
         {
             EnqueueDeletion(QueuedDestruction::Type::SwapChain, id);
         }
 
         FlushDeletionQueue(true);
+        m_ResourceReleaser.reset(); // Waits for the worker
 
         m_Frames.clear();
     };
@@ -62,29 +125,63 @@ namespace Engine::RHI::Vulkan
     // Deletion queue
     void VulkanGraphicsDevice::FlushDeletionQueue(bool forceNow)
     {
-        for (auto it = m_DeletionQueue.begin(); it != m_DeletionQueue.end(); )
+        uint64_t completed = GetCompletedTimelineValue();
+
+        VulkanReleaseBatch batch;
+        std::vector<QueuedDestruction> inUse;
+        while (!m_DeletionQueue.empty() && (forceNow || m_DeletionQueue.front().timelineValue <= completed))
         {
-            it->framesRemaining--;
-            if (it->framesRemaining == 0 || forceNow)
-            {
-                ImmediateDestroy(it->type, it->id);
-                it = m_DeletionQueue.erase(it);
-            }
-            else
+            for (const QueuedDestruction& destruction : m_DeletionQueue.front().destructions)
             {
-                ++it;
+                // Shader modules must outlive background compiles that read them
+                if (destruction.type == QueuedDestruction::Type::Shader && !forceNow)
+                {
+                    auto shader = m_Shaders.find(destruction.id);
+                    if (shader != m_Shaders.end() && shader->second.pendingCompiles > 0)
+                    {
+                        inUse.push_back(destruction);
+                        continue;
+                    }
+                }
+
+                ImmediateDestroy(destruction.type, destruction.id, batch);
             }
+            m_DeletionQueue.pop_front();
+        }
+
+        for (const QueuedDestruction& destruction : inUse)
+            EnqueueDeletion(destruction.type, destruction.id);
+
+        if (!batch.IsEmpty())
+            m_ResourceReleaser->Release(std::move(batch));
+
+        for (auto& [id, swapChain] : m_SwapChains)
+        {
+            std::erase_if(swapChain.retired, [&](VulkanSwapChainData::Retired& retired) {
+                if (retired.framesRemaining > 0)
+                    retired.framesRemaining--;
+                if (retired.framesRemaining > 0 && !forceNow)
+                    return false;
+
+                DestroySwapChainTextures(retired.textures);
+                return true;
+            });
         }
     }
 
 
     void VulkanGraphicsDevice::EnqueueDeletion(QueuedDestruction::Type type, uint32_t id)
     {
-        m_DeletionQueue.push_back({type, id, k_MaxFramesInFlight});
+        // The frame being recorded, or the next one between frames, may still reference it
+        uint64_t timelineValue = m_FrameTimelineValue + 1;
+        if (m_DeletionQueue.empty() || m_DeletionQueue.back().timelineValue != timelineValue)
+            m_DeletionQueue.push_back(DeletionBucket{ .timelineValue = timelineValue });
+
+        m_DeletionQueue.back().destructions.push_back({type, id});
     }
 
     // Destroy
-    void VulkanGraphicsDevice::ImmediateDestroy(QueuedDestruction::Type type, uint32_t id)
+    void VulkanGraphicsDevice::ImmediateDestroy(QueuedDestruction::Type type, uint32_t id, VulkanReleaseBatch& batch)
     {
         switch (type)
         {
@@ -94,7 +191,11 @@ namespace Engine::RHI::Vulkan
                 if (it == m_Buffers.end()) return;
                 VulkanBufferData& data = it->second;
                 if (data.desc.usage == BufferUsage::Static && data.buffer)
-                    vmaDestroyBuffer(m_Context.GetAllocator(), data.buffer, data.allocation);
+                {
+                    m_Context.UntrackAllocation(VulkanMemoryCategory::Buffer, data.allocation);
+                    batch.buffers.push_back(data.buffer);
+                    batch.allocations.push_back(data.allocation);
+                }
                 m_Buffers.erase(it);
                 break;
             }
@@ -104,8 +205,23 @@ namespace Engine::RHI::Vulkan
                 if (it == m_Textures.end()) return;
                 VulkanTextureData& data = it->second;
                 if (data.ownsImage && data.image && data.allocation)
-                    vmaDestroyImage(m_Context.GetAllocator(), data.image, data.allocation);
-                m_Textures.erase(it);
+                {
+                    m_Context.UntrackAllocation(VulkanMemoryCategory::Texture, data.allocation);
+                    batch.images.push_back(data.image);
+                    batch.allocations.push_back(data.allocation);
+                }
+                else if (data.ownsImage && data.image && data.heapId != 0)
+                    batch.images.push_back(data.image); // Heap keeps the memory
+                m_Textures.erase(it); // Views are destroyed here, before the batch destroys the image
+                break;
+            }
+            case QueuedDestruction::Type::Heap:
+            {
+                auto it = m_Heaps.find(id);
+                if (it == m_Heaps.end()) return;
+                m_Context.UntrackAllocation(VulkanMemoryCategory::Texture, it->second.allocation);
+                batch.allocations.push_back(it->second.allocation);
+                m_Heaps.erase(it);
                 break;
             }
             case QueuedDestruction::Type::Shader:
@@ -119,18 +235,24 @@ namespace Engine::RHI::Vulkan
             {
                 auto it = m_Pipelines.find(id);
                 if (it == m_Pipelines.end()) return;
+                ResolvePendingPipeline(id, it->second, true);
+                uint32_t layoutId = it->second.layoutId;
                 m_Pipelines.erase(it);
+                ReleasePipelineLayout(layoutId);
+                break;
+            }
+            case QueuedDestruction::Type::CommandBundle:
+            {
+                m_CommandBundles.erase(id);
                 break;
             }
             case QueuedDestruction::Type::SwapChain:
             {
                 auto it = m_SwapChains.find(id);
                 if (it == m_SwapChains.end()) return;
-                for (auto& texData : it->second.textures)
-                {
-                    if (texData.ownsImage && texData.image && texData.allocation)
-                        vmaDestroyImage(m_Context.GetAllocator(), texData.image, texData.allocation);
-                }
+                DestroySwapChainTextures(it->second.textures);
+                for (auto& retired : it->second.retired)
+                    DestroySwapChainTextures(retired.textures);
                 m_SwapChains.erase(it);
                 break;
             }
@@ -144,15 +266,18 @@ namespace Engine::RHI::Vulkan
         uint32_t id = BufferHandle::AllocateID();
         VulkanBufferData& data = m_Buffers[id];
         data.desc = desc;
+
+        ENGINE_CORE_ASSERT(desc.type != BufferType::Storage || desc.usage == BufferUsage::Static, "Vulkan: VulkanGraphicsDevice: CreateBuffer(): storage buffers must be static!");
         
         // Dynamic buffers are allocated on the fly via VulkanDynamicBufferAllocator.
-        // data.dynamicOffsets is already sized to k_MaxFramesInFlight.
+        // data.dynamicAllocations is already sized to k_MaxFramesInFlight, which bounds m_Desc.framesInFlight.
         if(data.desc.usage == BufferUsage::Static)
         {
             // Buffer info
             vk::BufferCreateInfo bufferInfo;
             bufferInfo.size = data.desc.size;
-            bufferInfo.usage = VulkanCommon::GetBufferUsageFlags(data.desc.type) | vk::BufferUsageFlagBits::eTransferDst;
+            bufferInfo.usage = VulkanCommon::GetBufferUsageFlags(data.desc.type) | vk::BufferUsageFlagBits::eTransferDst |
+                               vk::BufferUsageFlagBits::eTransferSrc; // Readbacks copy from it
 
             // Alloc info: map to GPU memory
             VmaAllocationCreateInfo allocInfo{};
@@ -163,31 +288,79 @@ namespace Engine::RHI::Vulkan
             VkBuffer buffer;
             vmaCreateBuffer(m_Context.GetAllocator(), bufferInfo, &allocInfo, &buffer, &data.allocation, &resultInfo);
             data.buffer = buffer;
+            m_Context.TrackAllocation(VulkanMemoryCategory::Buffer, data.allocation);
         }
 
         return BufferHandle{ .id = id };
     }
 
-    TextureHandle VulkanGraphicsDevice::CreateTexture(const TextureDesc& desc)
+    VkImageCreateInfo VulkanGraphicsDevice::GetImageCreateInfo(const TextureDesc& desc)
     {
-        // Get data
-        uint32_t id = TextureHandle::AllocateID();
-        VulkanTextureData& data = m_Textures[id];
-        data.desc = desc;
-
-        // Create image
         VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
-        imageInfo.extent.width = data.desc.width;
-        imageInfo.extent.height = data.desc.height;
+        imageInfo.extent.width = desc.width;
+        imageInfo.extent.height = desc.height;
         imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = 1;
+        imageInfo.mipLevels = VulkanCommon::GetMipLevelCount(desc);
         imageInfo.arrayLayers = 1;
-        imageInfo.format = static_cast<VkFormat>(VulkanCommon::GetPixelFormat(data.desc.format));
+        imageInfo.format = static_cast<VkFormat>(VulkanCommon::GetPixelFormat(desc.format));
         imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageInfo.usage = static_cast<VkImageUsageFlags>(VulkanCommon::GetImageUsageFlags(data.desc.usage));
+        imageInfo.usage = static_cast<VkImageUsageFlags>(VulkanCommon::GetImageUsageFlags(desc.usage));
+        if (!VulkanCommon::IsCompressed(desc.format))
+            imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT; // Mips are blitted from the level above, readbacks copy from it
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        return imageInfo;
+    }
+
+    void VulkanGraphicsDevice::CreateTextureViews(VulkanTextureData& textureData)
+    {
+        CreateImageView(textureData);
+
+        if(textureData.desc.usage.Has(TextureUsage::Sampled))
+        {
+            textureData.sampler = GetOrCreateSampler(textureData.desc.sampler);
+        }
+    }
+
+    void VulkanGraphicsDevice::InitializeStorageLayout(VulkanTextureData& textureData)
+    {
+        if(!textureData.desc.usage.Has(TextureUsage::Storage))
+            return;
+
+        ENGINE_CORE_ASSERT(!m_InImmediatePass, "Vulkan: VulkanGraphicsDevice: CreateTexture(): storage textures can't be created inside an immediate pass!");
+
+        // Storage images live in eGeneral, which sampling also accepts, so binds never transition them.
+        // Done on the immediate command buffer so no recording thread ever sees another layout.
+        VulkanCommandBuffer* cmd = static_cast<VulkanCommandBuffer*>(BeginImmediate());
+        VulkanCommon::TransitionImageLayout(
+            *cmd->GetCommandBuffer(),
+            textureData.image,
+            vk::ImageLayout::eUndefined,
+            vk::ImageLayout::eGeneral,
+            vk::AccessFlagBits2::eNone,
+            vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+            vk::PipelineStageFlagBits2::eTopOfPipe,
+            vk::PipelineStageFlagBits2::eAllCommands,
+            VulkanCommon::GetImageAspect(textureData.desc.usage)
+        );
+        EndImmediate(cmd);
+
+        textureData.layout = vk::ImageLayout::eGeneral;
+    }
+
+    TextureHandle VulkanGraphicsDevice::CreateTexture(const TextureDesc& desc)
+    {
+        // Get data
+        uint32_t id = TextureHandle::AllocateID();
+        VulkanTextureData& data = m_Textures[id];
+        data.desc = desc;
+        data.desc.mipLevels = VulkanCommon::GetMipLevelCount(desc);
+        ENGINE_CORE_ASSERT(data.desc.mipLevels == 1 || data.desc.usage == TextureUsageFlags(TextureUsage::Sampled), "Vulkan: VulkanGraphicsDevice: mipmapped textures can only be sampled!");
+        ENGINE_CORE_ASSERT(!VulkanCommon::IsCompressed(desc.format) || data.desc.usage == TextureUsageFlags(TextureUsage::Sampled), "Vulkan: VulkanGraphicsDevice: compressed textures can only be sampled!");
+
+        // Create image
+        VkImageCreateInfo imageInfo = GetImageCreateInfo(data.desc);
 
         VmaAllocationCreateInfo allocInfo = {};
         allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
@@ -206,14 +379,81 @@ namespace Engine::RHI::Vulkan
         data.image = image;
         data.format = VulkanCommon::GetPixelFormat(data.desc.format);
         data.ownsImage = true;
+        m_Context.TrackAllocation(VulkanMemoryCategory::Texture, data.allocation);
+
+        CreateTextureViews(data);
+        InitializeStorageLayout(data);
+
+        return TextureHandle{ .id = id };
+    }
+
+    MemoryRequirements VulkanGraphicsDevice::GetTextureMemoryRequirements(const TextureDesc& desc)
+    {
+        // Vulkan 1.2 can only query requirements of an existing image
+        VkImageCreateInfo imageInfo = GetImageCreateInfo(desc);
+        vk::raii::Image image(m_Context.GetDevice(), vk::ImageCreateInfo(imageInfo));
+        vk::MemoryRequirements requirements = image.getMemoryRequirements();
+
+        return MemoryRequirements{
+            .size           = requirements.size,
+            .alignment      = requirements.alignment,
+            .memoryTypeBits = requirements.memoryTypeBits
+        };
+    }
+
+    HeapHandle VulkanGraphicsDevice::CreateHeap(const HeapDesc& desc)
+    {
+        uint32_t id = HeapHandle::AllocateID();
+        VulkanHeapData& data = m_Heaps[id];
+        data.desc = desc;
+
+        VkMemoryRequirements requirements = {};
+        requirements.size           = desc.size;
+        requirements.alignment      = desc.alignment;
+        requirements.memoryTypeBits = desc.memoryTypeBits;
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        if(vmaAllocateMemory(m_Context.GetAllocator(), &requirements, &allocInfo, &data.allocation, nullptr) != VK_SUCCESS)
+        {
+            m_Heaps.erase(id);
+            throw std::runtime_error("Vulkan: VulkanGraphicsDevice: CreateHeap(): Failed to allocate heap memory!");
+        }
+        m_Context.TrackAllocation(VulkanMemoryCategory::Texture, data.allocation);
+
+        return HeapHandle{ .id = id };
+    }
+
+    TextureHandle VulkanGraphicsDevice::CreatePlacedTexture(const TextureDesc& desc, HeapHandle heap, size_t offset)
+    {
+        VulkanHeapData& heapData = GetHeapData(heap);
 
-        CreateImageView(data);
+        // Get data
+        uint32_t id = TextureHandle::AllocateID();
+        VulkanTextureData& data = m_Textures[id];
+        data.desc = desc;
+        data.desc.mipLevels = VulkanCommon::GetMipLevelCount(desc);
+        ENGINE_CORE_ASSERT(data.desc.mipLevels == 1 || data.desc.usage == TextureUsageFlags(TextureUsage::Sampled), "Vulkan: VulkanGraphicsDevice: mipmapped textures can only be sampled!");
+        ENGINE_CORE_ASSERT(!VulkanCommon::IsCompressed(desc.format) || data.desc.usage == TextureUsageFlags(TextureUsage::Sampled), "Vulkan: VulkanGraphicsDevice: compressed textures can only be sampled!");
 
-        if(data.desc.usage.Has(TextureUsage::Sampled))
+        // Create image and bind it into the heap
+        VkImageCreateInfo imageInfo = GetImageCreateInfo(data.desc);
+        data.image = (*m_Context.GetDevice()).createImage(vk::ImageCreateInfo(imageInfo));
+        data.format = VulkanCommon::GetPixelFormat(data.desc.format);
+        data.ownsImage = true;
+        data.heapId = heap.id;
+
+        if(vmaBindImageMemory2(m_Context.GetAllocator(), heapData.allocation, offset, data.image, nullptr) != VK_SUCCESS)
         {
-            CreateSampler(data);
+            (*m_Context.GetDevice()).destroyImage(data.image);
+            m_Textures.erase(id);
+            throw std::runtime_error("Vulkan: VulkanGraphicsDevice: CreatePlacedTexture(): Failed to bind image to heap!");
         }
 
+        CreateTextureViews(data);
+        InitializeStorageLayout(data);
+
         return TextureHandle{ .id = id };
     }
 
@@ -222,6 +462,7 @@ namespace Engine::RHI::Vulkan
         // Get data
         uint32_t id = ShaderHandle::AllocateID();
         VulkanShaderData& data = m_Shaders[id]; 
+        size_t contentHash = 0;
 
         // Loop through all shader modules
         for (const ShaderModule& mod : desc.modules) {
@@ -234,6 +475,22 @@ namespace Engine::RHI::Vulkan
             // Loop through stages and map stage to module index
             for(auto const &[stage, entryPoint] : mod.entryPoints) {
                 data.stages[stage] = { moduleIndex, entryPoint };
+                HashCombine(contentHash, Hash64(entryPoint));
+                HashCombine(contentHash, static_cast<uint64_t>(stage));
+            }
+
+            std::string_view bytes(reinterpret_cast<const char*>(mod.spirv.data()), mod.spirv.size() * sizeof(uint32_t));
+            HashCombine(contentHash, Hash64(bytes));
+        }
+        data.contentHash = contentHash;
+
+        // Warm up pipelines recorded with this shader in a previous session. They are held with no references
+        // until a matching CreatePipeline() claims them.
+        for(const PipelineDesc& pipelineDesc : m_PipelineManifest.GetDescsForShader(data.contentHash, ShaderHandle{ .id = id }))
+        {
+            if(!m_PipelineLookup.contains(pipelineDesc))
+            {
+                CreatePipelineInternal(pipelineDesc, true, 0);
             }
         }
 
@@ -242,30 +499,69 @@ namespace Engine::RHI::Vulkan
 
     PipelineHandle VulkanGraphicsDevice::CreatePipeline(const PipelineDesc& desc)
     {
-        // Get data
-        uint32_t id = PipelineHandle::AllocateID();
-        VulkanPipelineData& data = m_Pipelines[id]; 
+        return CreatePipelineInternal(desc, false, 1);
+    }
+
+    PipelineHandle VulkanGraphicsDevice::CreatePipelineAsync(const PipelineDesc& desc)
+    {
+        return CreatePipelineInternal(desc, true, 1);
+    }
+
+    PipelineHandle VulkanGraphicsDevice::CreatePipelineInternal(const PipelineDesc& desc, bool async, uint32_t refCount)
+    {
+        // List topologies would need primitiveTopologyListRestart
+        ENGINE_CORE_ASSERT(!desc.primitiveRestart || desc.topology == PrimitiveTopology::LineStrip || desc.topology == PrimitiveTopology::TriangleStrip, "Vulkan: VulkanGraphicsDevice: CreatePipeline(): primitiveRestart needs a strip topology!");
 
         // Get shader data
         VulkanShaderData& shaderData = GetShaderData(desc.shader);
 
-        // Get shader stage create infos
-        std::vector<vk::PipelineShaderStageCreateInfo> shaderStageInfos;
+        // Record for warm-up on next launch. Warm-up compiles (no references) are not requests and
+        // only survive into the next manifest if a CreatePipeline() claims them.
+        if(refCount > 0)
+        {
+            m_PipelineManifest.Record(shaderData.contentHash, desc);
+        }
+
+        // Return existing pipeline if an identical one was already created.
+        // If it is still compiling, BindPipeline() waits for it.
+        auto existing = m_PipelineLookup.find(desc);
+        if(existing != m_PipelineLookup.end())
+        {
+            m_Pipelines.at(existing->second).refCount += refCount;
+            return PipelineHandle{ .id = existing->second };
+        }
+
+        // Get data
+        uint32_t id = PipelineHandle::AllocateID();
+        VulkanPipelineData& data = m_Pipelines[id]; 
+        data.desc = desc;
+        data.refCount = refCount;
+
+        // Descriptor set & pipeline layout (shared)
+        data.layoutId = GetOrCreatePipelineLayout(VulkanPipelineLayoutKey{
+            .uniformBindings    = desc.uniformBindings,
+            .pushConstantRanges = desc.pushConstantRanges
+        });
+        VulkanPipelineLayoutData& layoutData = m_PipelineLayouts.at(data.layoutId);
+        data.descriptorSetLayout = *layoutData.descriptorSetLayout;
+        data.pipelineLayout = *layoutData.pipelineLayout;
+        data.updateTemplate = *layoutData.updateTemplate;
+
+        // Resolve everything the compiler needs up front
+        VulkanPipelineBuildState state;
+
+        // Shader stages
         for(auto const& [stage, info] : shaderData.stages)
         {
-            vk::PipelineShaderStageCreateInfo stageInfo;
-            stageInfo.stage = VulkanCommon::GetShaderStage(stage);
-            stageInfo.module = shaderData.modules[info.moduleIndex];
-            stageInfo.pName = info.entryPoint.c_str();
-            stageInfo.pSpecializationInfo = nullptr;
-            shaderStageInfos.push_back(stageInfo);
+            state.stages.push_back({
+                VulkanCommon::GetShaderStage(stage),
+                *shaderData.modules[info.moduleIndex],
+                info.entryPoint
+            });
         }
 
         // Vertex attributes
-
-        // Get vertex input attribute description
-        std::vector<vk::VertexInputAttributeDescription> attributeDescriptions{};
-        vk::VertexInputBindingDescription bindingDescription = { 0, desc.vertexLayout.GetStride(), vk::VertexInputRate::eVertex };
+        state.vertexStride = desc.vertexLayout.GetStride();
         const std::vector<VertexElement>& elements = desc.vertexLayout.GetElements();
         for(int i = 0; i < elements.size(); i++) {
             vk::VertexInputAttributeDescription vdesc;
@@ -273,87 +569,158 @@ namespace Engine::RHI::Vulkan
             vdesc.binding = 0;
             vdesc.format = VulkanCommon::GetVertexElementFormat(elements[i].GetType());
             vdesc.offset = elements[i].GetOffset();
-            attributeDescriptions.push_back(vdesc);
+            state.attributes.push_back(vdesc);
         }
 
-        // Get vertex input info
-        vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+        // Fixed function state
+        state.topology    = VulkanCommon::GetPrimitiveTopology(desc.topology);
+        state.primitiveRestart = desc.primitiveRestart;
+        state.polygonMode = VulkanCommon::GetPolygonMode(desc.polygonMode);
+        state.cullMode    = VulkanCommon::GetCullMode(desc.cullMode);
+        state.frontFace   = VulkanCommon::GetFrontFace(desc.frontFace);
+        state.blending    = desc.blending;
+        state.depthTest   = desc.depthTest;
+        state.depthWrite  = desc.depthWrite;
 
-        // Topology
-        vk::PipelineInputAssemblyStateCreateInfo inputAssembly(
-            {},
-            VulkanCommon::GetPrimitiveTopology(desc.topology),
-            vk::False
-        );
+        // Get color attachment formats
+        for(const PixelFormat& format : desc.colorAttachmentFormats)
+        {
+            state.colorAttachmentFormats.push_back(VulkanCommon::GetPixelFormat(format));
+        }
 
-        // Viewport & Scissor dynamic states
-        std::vector dynamicStates = {
-            vk::DynamicState::eViewport,
-		    vk::DynamicState::eScissor
-        };
-		vk::PipelineDynamicStateCreateInfo dynamicState{};
-        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-        dynamicState.pDynamicStates = dynamicStates.data();
-
-        // Blank VP and Scissor state
-        vk::PipelineViewportStateCreateInfo viewportState{};
-        viewportState.viewportCount = 1;
-        viewportState.pViewports = nullptr;
-        viewportState.scissorCount = 1;
-        viewportState.pScissors = nullptr;
-        
-        // Rasterizer
-        vk::PipelineRasterizationStateCreateInfo rasterizer;
-        rasterizer.depthClampEnable = vk::False;
-        rasterizer.rasterizerDiscardEnable = vk::False;
-        rasterizer.polygonMode = VulkanCommon::GetPolygonMode(desc.polygonMode);
-        rasterizer.cullMode = VulkanCommon::GetCullMode(desc.cullMode);
-        rasterizer.frontFace = VulkanCommon::GetFrontFace(desc.frontFace);
-        rasterizer.depthBiasEnable = vk::False;
-        rasterizer.lineWidth = 1.0f;
-
-        // Multisampling
-        vk::PipelineMultisampleStateCreateInfo multisampling;
-        multisampling.rasterizationSamples = vk::SampleCountFlagBits::e1;
-        multisampling.sampleShadingEnable = vk::False;
-        
-        // Blending
-        vk::PipelineColorBlendAttachmentState colorBlendAttachment;
-        colorBlendAttachment.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
-        if(desc.blending)
-        {
-            colorBlendAttachment.blendEnable = vk::True;
-            colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
-            colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
-            colorBlendAttachment.colorBlendOp = vk::BlendOp::eAdd;
-            colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
-            colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eZero;
-            colorBlendAttachment.alphaBlendOp = vk::BlendOp::eAdd;
+        // Get depth format
+        state.depthFormat = desc.depthTest 
+            ? VulkanCommon::GetPixelFormat(desc.depthFormat) 
+            : vk::Format::eUndefined;
+
+        state.layout = data.pipelineLayout;
+
+        // Compile
+        if(async)
+        {
+            data.ready = false;
+            data.pendingPipeline = m_PipelineCompiler->CompileAsync(std::move(state));
+            shaderData.pendingCompiles++;
+            m_PendingPipelines.push_back(id);
         }
         else
         {
-            colorBlendAttachment.blendEnable = vk::False;
+            data.pipeline = m_PipelineCompiler->Compile(state);
+            data.ready = true;
+        }
+
+        m_PipelineLookup[desc] = id;
+
+        return PipelineHandle{ .id = id };
+    }
+
+    PipelineHandle VulkanGraphicsDevice::CreateComputePipeline(const ComputePipelineDesc& desc)
+    {
+        // Return existing pipeline if an identical one was already created
+        auto existing = m_ComputePipelineLookup.find(desc);
+        if(existing != m_ComputePipelineLookup.end())
+        {
+            m_Pipelines.at(existing->second).refCount++;
+            return PipelineHandle{ .id = existing->second };
+        }
+
+        // Get shader data
+        VulkanShaderData& shaderData = GetShaderData(desc.shader);
+        auto stage = shaderData.stages.find(ShaderStage::Compute);
+        ENGINE_CORE_ASSERT(stage != shaderData.stages.end(), "Vulkan: VulkanGraphicsDevice: CreateComputePipeline(): shader has no compute entry point!");
+
+        // Get data
+        uint32_t id = PipelineHandle::AllocateID();
+        VulkanPipelineData& data = m_Pipelines[id];
+        data.computeDesc = desc;
+        data.bindPoint = vk::PipelineBindPoint::eCompute;
+        data.refCount = 1;
+
+        // Descriptor set & pipeline layout (shared with graphics pipelines of the same signature)
+        data.layoutId = GetOrCreatePipelineLayout(VulkanPipelineLayoutKey{
+            .uniformBindings    = desc.uniformBindings,
+            .pushConstantRanges = desc.pushConstantRanges
+        });
+        VulkanPipelineLayoutData& layoutData = m_PipelineLayouts.at(data.layoutId);
+        data.descriptorSetLayout = *layoutData.descriptorSetLayout;
+        data.pipelineLayout = *layoutData.pipelineLayout;
+        data.updateTemplate = *layoutData.updateTemplate;
+
+        // Compile
+        data.pipeline = m_PipelineCompiler->CompileCompute(
+            *shaderData.modules[stage->second.moduleIndex],
+            stage->second.entryPoint,
+            data.pipelineLayout
+        );
+
+        m_ComputePipelineLookup[desc] = id;
+
+        return PipelineHandle{ .id = id };
+    }
+
+    bool VulkanGraphicsDevice::IsPipelineReady(PipelineHandle pipeline)
+    {
+        return ResolvePendingPipeline(pipeline.id, GetPipelineData(pipeline), false);
+    }
+
+    void VulkanGraphicsDevice::WaitForPipeline(PipelineHandle pipeline)
+    {
+        ResolvePendingPipeline(pipeline.id, GetPipelineData(pipeline), true);
+    }
+
+    bool VulkanGraphicsDevice::ResolvePendingPipeline(uint32_t id, VulkanPipelineData& data, bool wait)
+    {
+        if(data.ready)
+            return true;
+
+        std::lock_guard<std::mutex> lock(m_PipelineMutex);
+        if(data.ready)
+            return true; // Resolved by another thread while we waited for the lock
+
+        if(!wait && data.pendingPipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+
+        // Shader modules are no longer needed by the compiler
+        auto shader = m_Shaders.find(data.desc.shader.id);
+        if(shader != m_Shaders.end())
+        {
+            shader->second.pendingCompiles--;
         }
 
-        vk::PipelineColorBlendStateCreateInfo colorBlending;
-        colorBlending.logicOpEnable = vk::False;
-        colorBlending.logicOp = vk::LogicOp::eCopy;
-        colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
+        // Publish the pipeline before the flag, recording threads read it as soon as ready is set
+        data.pipeline = data.pendingPipeline.get(); // Rethrows compilation errors
+        data.ready = true;
+        return true;
+    }
+
+    void VulkanGraphicsDevice::PollPendingPipelines()
+    {
+        std::erase_if(m_PendingPipelines, [this](uint32_t id) {
+            auto it = m_Pipelines.find(id);
+            if(it == m_Pipelines.end())
+                return true; // Destroyed
+            return ResolvePendingPipeline(id, it->second, false);
+        });
+    }
+
+    uint32_t VulkanGraphicsDevice::GetOrCreatePipelineLayout(const VulkanPipelineLayoutKey& key)
+    {
+        // Check cache
+        auto existing = m_PipelineLayoutLookup.find(key);
+        if(existing != m_PipelineLayoutLookup.end())
+        {
+            m_PipelineLayouts.at(existing->second).refCount++;
+            return existing->second;
+        }
 
-        // Depth testing
-        vk::PipelineDepthStencilStateCreateInfo depthStencil;
-        depthStencil.depthTestEnable  = desc.depthTest ? vk::True : vk::False;
-        depthStencil.depthWriteEnable = desc.depthWrite ? vk::True : vk::False;
-        depthStencil.depthCompareOp   = vk::CompareOp::eLess;
+        uint32_t id = m_NextPipelineLayoutID++;
+        VulkanPipelineLayoutData& data = m_PipelineLayouts[id];
+        data.key = key;
+        data.refCount = 1;
 
         // Uniform bindings
         std::vector<vk::DescriptorSetLayoutBinding> layoutBindings;
-        for(auto const& ub : desc.uniformBindings)
+        for(auto const& ub : key.uniformBindings)
         {
             vk::DescriptorSetLayoutBinding binding;
             binding.binding = ub.binding;
@@ -369,67 +736,118 @@ namespace Engine::RHI::Vulkan
         layoutInfo.pBindings = layoutBindings.data();
         data.descriptorSetLayout = vk::raii::DescriptorSetLayout(m_Context.GetDevice(), layoutInfo);
 
+        // Push constant ranges. Vulkan allows each stage in only one range, so ranges of the same stage are merged
+        uint32_t maxPushConstantsSize = m_Context.GetPhysicalDeviceProperties().limits.maxPushConstantsSize;
+        for(auto const& pc : key.pushConstantRanges)
+        {
+            ENGINE_CORE_ASSERT(pc.size > 0 && pc.offset % 4 == 0 && pc.size % 4 == 0, "Vulkan: VulkanGraphicsDevice: push constant offset and size must be non-zero multiples of 4!");
+            ENGINE_CORE_ASSERT(pc.offset + pc.size <= maxPushConstantsSize, "Vulkan: VulkanGraphicsDevice: push constant range exceeds maxPushConstantsSize!");
+
+            vk::ShaderStageFlags stage = VulkanCommon::GetShaderStage(pc.stage);
+            auto merged = std::find_if(data.pushConstantRanges.begin(), data.pushConstantRanges.end(), [&](const vk::PushConstantRange& r) {
+                return r.stageFlags == stage;
+            });
+
+            if(merged == data.pushConstantRanges.end())
+            {
+                data.pushConstantRanges.push_back(vk::PushConstantRange(stage, pc.offset, pc.size));
+            }
+            else
+            {
+                uint32_t end = std::max(merged->offset + merged->size, pc.offset + pc.size);
+                merged->offset = std::min(merged->offset, pc.offset);
+                merged->size = end - merged->offset;
+            }
+        }
+
         // Pipeline layout
         vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
         pipelineLayoutInfo.setLayoutCount         = 1;
         pipelineLayoutInfo.pSetLayouts            = &(*data.descriptorSetLayout);
-        pipelineLayoutInfo.pushConstantRangeCount = 0;
+        pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(data.pushConstantRanges.size());
+        pipelineLayoutInfo.pPushConstantRanges    = data.pushConstantRanges.data();
         data.pipelineLayout = vk::raii::PipelineLayout(m_Context.GetDevice(), pipelineLayoutInfo);
-        
-        vk::GraphicsPipelineCreateInfo gfxPipeInfo;
-        gfxPipeInfo.stageCount          = shaderStageInfos.size();
-        gfxPipeInfo.pStages             = shaderStageInfos.data();
-        gfxPipeInfo.pVertexInputState   = &vertexInputInfo;
-        gfxPipeInfo.pInputAssemblyState = &inputAssembly;
-        gfxPipeInfo.pViewportState      = &viewportState;
-        gfxPipeInfo.pRasterizationState = &rasterizer;
-        gfxPipeInfo.pMultisampleState   = &multisampling;
-        gfxPipeInfo.pColorBlendState    = &colorBlending;
-        gfxPipeInfo.pDepthStencilState  = &depthStencil;
-        gfxPipeInfo.pDynamicState       = &dynamicState;
-        gfxPipeInfo.layout              = data.pipelineLayout;
-        gfxPipeInfo.renderPass          = nullptr;
 
-        // Get color attachment formats
-        std::vector<vk::Format> colorAttachmentFormats;
-        for(const PixelFormat& format : desc.colorAttachmentFormats)
+        // Descriptor update template. Bindings are written from an array of VulkanDescriptorWrite indexed by binding
+        if(!key.uniformBindings.empty())
         {
-            colorAttachmentFormats.push_back(VulkanCommon::GetPixelFormat(format));
+            std::vector<vk::DescriptorUpdateTemplateEntry> entries;
+            for(auto const& ub : key.uniformBindings)
+            {
+                ENGINE_CORE_ASSERT(ub.binding < k_MaxBindings, "Vulkan: VulkanGraphicsDevice: uniform binding exceeds k_MaxBindings!");
+
+                vk::DescriptorUpdateTemplateEntry entry;
+                entry.dstBinding      = ub.binding;
+                entry.dstArrayElement = 0;
+                entry.descriptorCount = 1;
+                entry.descriptorType  = VulkanCommon::GetUniformDescriptorType(ub.type);
+                bool isImage          = ub.type == UniformType::Texture || ub.type == UniformType::StorageTexture;
+                entry.offset          = ub.binding * sizeof(VulkanDescriptorWrite) + (isImage
+                    ? offsetof(VulkanDescriptorWrite, image)
+                    : offsetof(VulkanDescriptorWrite, buffer));
+                entry.stride          = sizeof(VulkanDescriptorWrite);
+                entries.push_back(entry);
+
+                if(ub.type == UniformType::UniformBuffer)
+                {
+                    data.dynamicBindings.push_back(ub.binding);
+                }
+            }
+            std::sort(data.dynamicBindings.begin(), data.dynamicBindings.end());
+
+            vk::DescriptorUpdateTemplateCreateInfo templateInfo;
+            templateInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+            templateInfo.pDescriptorUpdateEntries   = entries.data();
+            templateInfo.templateType               = vk::DescriptorUpdateTemplateType::eDescriptorSet;
+            templateInfo.descriptorSetLayout        = *data.descriptorSetLayout;
+            data.updateTemplate = vk::raii::DescriptorUpdateTemplate(m_Context.GetDevice(), templateInfo);
         }
 
-        // Get depth format
-        vk::Format depthFmt = desc.depthTest 
-            ? VulkanCommon::GetPixelFormat(desc.depthFormat) 
-            : vk::Format::eUndefined;
-
-        vk::PipelineRenderingCreateInfo pipeRenderInfo;
-        pipeRenderInfo.colorAttachmentCount    = colorAttachmentFormats.size();
-        pipeRenderInfo.pColorAttachmentFormats = colorAttachmentFormats.data();
-        pipeRenderInfo.depthAttachmentFormat   = depthFmt;
-
-        vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::PipelineRenderingCreateInfo> pipelineCreateInfoChain(
-            gfxPipeInfo,
-            pipeRenderInfo
-        );
+        m_PipelineLayoutLookup[key] = id;
+        return id;
+    }
 
-        data.pipeline = vk::raii::Pipeline(m_Context.GetDevice(), nullptr, pipelineCreateInfoChain.get<vk::GraphicsPipelineCreateInfo>());
+    void VulkanGraphicsDevice::ReleasePipelineLayout(uint32_t layoutId)
+    {
+        auto it = m_PipelineLayouts.find(layoutId);
+        if (it == m_PipelineLayouts.end()) return;
 
-        return PipelineHandle{ .id = id };
+        if(--it->second.refCount == 0)
+        {
+            m_PipelineLayoutLookup.erase(it->second.key);
+            m_PipelineLayouts.erase(it);
+        }
     }
 
     SwapChainHandle VulkanGraphicsDevice::CreateSwapChain(const SwapChainDesc& desc)
     {
-        ENGINE_CORE_ASSERT(desc.window != nullptr, "Vulkan: VulkanGraphicsDevice: CreateSwapChain(): desc.window is nullptr!");
-
         // Get data
         uint32_t id = SwapChainHandle::AllocateID();
         VulkanSwapChainData& data = m_SwapChains[id]; 
 
+        // Offscreen
+        if (desc.window == nullptr)
+        {
+            ENGINE_CORE_ASSERT(desc.width > 0 && desc.height > 0, "Vulkan: VulkanGraphicsDevice: CreateSwapChain(): offscreen swapchains need a size!");
+
+            data.offscreen = true;
+            data.format = desc.format;
+            data.presentMode = desc.presentation;
+            data.width = desc.width;
+            data.height = desc.height;
+
+            RebuildOffscreenSwapchain(data);
+
+            return SwapChainHandle{ .id = id };
+        }
+
+        ENGINE_CORE_ASSERT(!m_Context.IsHeadless(), "Vulkan: VulkanGraphicsDevice: CreateSwapChain(): headless devices can't present to a window!");
+
         // Create surface
         vk::SurfaceKHR surface = m_Bridge->CreateSurface(
             m_Context.GetInstance(),
             m_Context.GetPhysicalDevice(),
-            m_Context.GetGraphicsQueue().familyIndex,
+            m_Context.GetPresentQueue().familyIndex,
             desc.window
         );
         data.surface = vk::raii::SurfaceKHR(m_Context.GetInstance(), surface);
@@ -446,10 +864,31 @@ namespace Engine::RHI::Vulkan
     }
 
     // Resource destruction
+    ICommandBundle* VulkanGraphicsDevice::CreateCommandBundle(const CommandBundleDesc& desc)
+    {
+        uint32_t id = m_NextCommandBundleID++;
+        Scope<VulkanCommandBundle>& bundle = m_CommandBundles[id];
+        bundle = CreateScope<VulkanCommandBundle>(*this, id, desc);
+        return bundle.get();
+    }
+
+    void VulkanGraphicsDevice::DestroyCommandBundle(ICommandBundle*& bundle)
+    {
+        if(bundle != nullptr)
+        {
+            // Frames in flight may still execute it
+            EnqueueDeletion(QueuedDestruction::Type::CommandBundle, static_cast<VulkanCommandBundle*>(bundle)->GetID());
+        }
+        bundle = nullptr;
+    }
+
     void VulkanGraphicsDevice::DestroyBuffer(BufferHandle& buffer)
     {
         if(buffer.IsValid())
         {
+            for(auto& [id, bundle] : m_CommandBundles)
+                bundle->OnBufferDestroyed(buffer.id);
+
             EnqueueDeletion(QueuedDestruction::Type::Buffer, buffer.id);
         }
         buffer.id = 0;
@@ -459,6 +898,9 @@ namespace Engine::RHI::Vulkan
     {
         if(texture.IsValid())
         {
+            for(auto& [id, bundle] : m_CommandBundles)
+                bundle->OnTextureDestroyed(texture.id);
+
             EnqueueDeletion(QueuedDestruction::Type::Texture, texture.id);
         }
         texture.id = 0;
@@ -468,6 +910,15 @@ namespace Engine::RHI::Vulkan
     {
         if(shader.IsValid())
         {
+            // Release warmed up pipelines that were never claimed
+            for(auto& [id, data] : m_Pipelines)
+            {
+                if(data.refCount == 0 && data.desc.shader == shader && m_PipelineLookup.erase(data.desc))
+                {
+                    EnqueueDeletion(QueuedDestruction::Type::Pipeline, id);
+                }
+            }
+
             EnqueueDeletion(QueuedDestruction::Type::Shader, shader.id);
         }
         shader.id = 0;
@@ -477,71 +928,397 @@ namespace Engine::RHI::Vulkan
     {
         if(pipeline.IsValid())
         {
-            EnqueueDeletion(QueuedDestruction::Type::Pipeline, pipeline.id);
+            // Pipelines are shared between identical descs, only destroy once the last user is gone
+            VulkanPipelineData& data = GetPipelineData(pipeline);
+            if(--data.refCount == 0)
+            {
+                if(data.bindPoint == vk::PipelineBindPoint::eCompute)
+                    m_ComputePipelineLookup.erase(data.computeDesc);
+                else
+                    m_PipelineLookup.erase(data.desc);
+
+                for(auto& [id, bundle] : m_CommandBundles)
+                    bundle->OnPipelineDestroyed(pipeline.id);
+
+                EnqueueDeletion(QueuedDestruction::Type::Pipeline, pipeline.id);
+            }
         }
         pipeline.id = 0;
     }
 
+    void VulkanGraphicsDevice::DestroyHeap(HeapHandle& heap)
+    {
+        if(heap.IsValid())
+        {
+            EnqueueDeletion(QueuedDestruction::Type::Heap, heap.id);
+        }
+        heap.id = 0;
+    }
+
     void VulkanGraphicsDevice::DestroySwapChain(SwapChainHandle& swapchain)
     {
         if(swapchain.IsValid())
         {
+            for(auto& [id, bundle] : m_CommandBundles)
+                bundle->OnSwapChainDestroyed(swapchain.id);
+
             EnqueueDeletion(QueuedDestruction::Type::SwapChain, swapchain.id);
         }
         swapchain.id = 0;
     }
 
-    // Frame pacing
-    void VulkanGraphicsDevice::BeginFrame()
+    BufferHandle VulkanGraphicsDevice::GetQuadIndexBuffer(uint32_t quadCount)
     {
-        // Wait for fence
-        m_Context.GetDevice().waitForFences(*m_Frames[m_FrameIndex]->GetFence(), VK_TRUE, UINT64_MAX);
-        m_Context.GetDevice().resetFences(*m_Frames[m_FrameIndex]->GetFence());
-        m_Frames[m_FrameIndex]->Reset();
+        if(m_QuadIndexBuffer.IsValid() && quadCount <= m_QuadIndexCapacity)
+            return m_QuadIndexBuffer;
 
-        // Clear previous submission info
-        m_FrameSubmits.clear();
-        m_FrameCommandBuffers.clear();
-        m_FrameWaitSemaphores.clear();
-        m_FrameSignalSemaphores.clear();
-        m_FrameStageFlags.clear();
-        m_FrameSwapChainPresentations.clear();
+        ENGINE_CORE_ASSERT(!m_InImmediatePass, "Vulkan: VulkanGraphicsDevice: GetQuadIndexBuffer(): can't grow inside an immediate pass!");
+        ENGINE_CORE_ASSERT(quadCount <= k_MaxQuadIndexCapacity, "Vulkan: VulkanGraphicsDevice: GetQuadIndexBuffer(): quadCount exceeds k_MaxQuadIndexCapacity!");
 
-        FlushDeletionQueue();
-    }
+        // Powers of two, so a batch that keeps growing rebuilds it only a few times
+        uint32_t capacity = std::bit_ceil(std::max(quadCount, k_MinQuadIndexCapacity));
 
-    void VulkanGraphicsDevice::EndFrame()
-    {
-        // Submit everything
-        m_Context.GetGraphicsQueue().queue.submit(
-            m_FrameSubmits,
-            *m_Frames[m_FrameIndex]->GetFence()
-        );
+        std::vector<uint32_t> indices(static_cast<size_t>(capacity) * 6);
+        for(uint32_t quad = 0; quad < capacity; quad++)
+        {
+            uint32_t vertex = quad * 4;
+            uint32_t* index = &indices[static_cast<size_t>(quad) * 6];
+            index[0] = vertex;
+            index[1] = vertex + 1;
+            index[2] = vertex + 2;
+            index[3] = vertex + 2;
+            index[4] = vertex + 3;
+            index[5] = vertex;
+        }
+
+        BufferDesc desc{
+            .size        = indices.size() * sizeof(uint32_t),
+            .type        = BufferType::Index,
+            .usage       = BufferUsage::Static,
+            .indexFormat = IndexFormat::Uint32
+        };
+        BufferHandle buffer = CreateBuffer(desc);
+
+        ICommandBuffer* cmd = BeginImmediate();
+        cmd->UploadBuffer(buffer, indices.data(), desc.size, 0);
+        EndImmediate(cmd);
+
+        // Frames in flight may still draw with the smaller one
+        DestroyBuffer(m_QuadIndexBuffer);
+        m_QuadIndexBuffer   = buffer;
+        m_QuadIndexCapacity = capacity;
+        return buffer;
+    }
+
+    // Frame pacing
+    void VulkanGraphicsDevice::BeginFrame()
+    {
+        // Wait until the GPU has finished the last frame that used this slot
+        WaitForTimelineValue(m_Frames[m_FrameIndex]->GetTimelineValue());
+
+        // The slot's previous frame is done, so its queries are available without stalling
+        if (VulkanFrameProfiler* profiler = m_Frames[m_FrameIndex]->GetProfiler())
+        {
+            GpuFrameTimings timings;
+            timings.frame = m_Frames[m_FrameIndex]->GetTimelineValue();
+            if (profiler->Resolve(timings))
+                m_GpuTimings = std::move(timings);
+        }
+
+        m_Frames[m_FrameIndex]->Reset();
+
+        // Clear previous submission info
+        m_FrameSubmissions.clear();
+        m_FrameSwapChainPresentations.clear();
+
+        PollPendingPipelines();
+        FlushDeletionQueue();
+        m_ReadbackRing->Update(GetCompletedTimelineValue());
+
+        // Budgets are refreshed once per frame index
+        vmaSetCurrentFrameIndex(m_Context.GetAllocator(), static_cast<uint32_t>(m_FrameTimelineValue));
+        CheckMemoryBudget();
+    }
+
+    bool VulkanGraphicsDevice::IsFormatSupported(PixelFormat format, TextureUsageFlags usage)
+    {
+        // Compressed formats also need their device feature, which was enabled if supported
+        const DeviceCapabilities& capabilities = m_Context.GetCapabilities();
+        switch (format)
+        {
+            case PixelFormat::BC1: case PixelFormat::BC1Unorm: case PixelFormat::BC3: case PixelFormat::BC3Unorm:
+            case PixelFormat::BC4: case PixelFormat::BC5: case PixelFormat::BC7: case PixelFormat::BC7Unorm:
+                if (!capabilities.textureCompressionBC) return false;
+                break;
+            case PixelFormat::ETC2RGB8: case PixelFormat::ETC2RGBA8:
+                if (!capabilities.textureCompressionETC2) return false;
+                break;
+            case PixelFormat::ASTC4x4:
+                if (!capabilities.textureCompressionASTC) return false;
+                break;
+            default:
+                break;
+        }
+
+        vk::FormatFeatureFlags required = VulkanCommon::GetFormatFeatures(usage);
+        vk::FormatProperties properties = m_Context.GetPhysicalDevice().getFormatProperties(VulkanCommon::GetPixelFormat(format));
+        return (properties.optimalTilingFeatures & required) == required;
+    }
+
+    MemoryStats VulkanGraphicsDevice::GetMemoryStats()
+    {
+        MemoryStats stats;
 
-        // Present all swapchains that were rendered to
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(m_Context.GetAllocator(), &memoryProperties);
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets;
+        vmaGetHeapBudgets(m_Context.GetAllocator(), budgets.data());
+
+        stats.heaps.resize(memoryProperties->memoryHeapCount);
+        for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++)
+        {
+            stats.heaps[i].budget      = budgets[i].budget;
+            stats.heaps[i].usage       = budgets[i].usage;
+            stats.heaps[i].deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        }
+
+        stats.buffers        = m_Context.GetAllocatedBytes(VulkanMemoryCategory::Buffer);
+        stats.textures       = m_Context.GetAllocatedBytes(VulkanMemoryCategory::Texture);
+        stats.dynamicBuffers = m_Context.GetAllocatedBytes(VulkanMemoryCategory::Dynamic);
+        stats.staging        = m_Context.GetAllocatedBytes(VulkanMemoryCategory::Staging);
+
+        return stats;
+    }
+
+    void VulkanGraphicsDevice::SetMemoryBudgetCallback(std::function<void(const MemoryStats&)> callback)
+    {
+        m_MemoryBudgetCallback = std::move(callback);
+        m_OverMemoryBudget = false;
+    }
+
+    void VulkanGraphicsDevice::CheckMemoryBudget()
+    {
+        if (!m_MemoryBudgetCallback)
+            return;
+
+        MemoryStats stats = GetMemoryStats();
+        bool overBudget = std::ranges::any_of(stats.heaps, [&](const MemoryHeapStats& heap) {
+            return heap.deviceLocal && heap.usage > static_cast<size_t>(heap.budget * m_Desc.memoryBudgetThreshold);
+        });
+
+        if (overBudget && !m_OverMemoryBudget)
+        {
+            LOG_CORE_WARN("Vulkan: Device memory usage crossed {0}% of the budget", static_cast<uint32_t>(m_Desc.memoryBudgetThreshold * 100.0f));
+            m_MemoryBudgetCallback(stats);
+        }
+        m_OverMemoryBudget = overBudget;
+    }
+
+    void VulkanGraphicsDevice::EndFrame()
+    {
+        // Trailing submit signals the frame timeline. Semaphore signals cover all work earlier in submission order,
+        // so this is only reached once every pass of this frame has completed.
+        uint64_t signalValue = ++m_FrameTimelineValue;
+        vk::TimelineSemaphoreSubmitInfo timelineSubmitInfo;
+        timelineSubmitInfo.signalSemaphoreValueCount = 1;
+        timelineSubmitInfo.pSignalSemaphoreValues    = &signalValue;
+
+        // One submit per pass, in the order the passes were begun. Fixups need stable storage as submits point into it
+        std::vector<vk::SubmitInfo> submits;
+        submits.reserve(m_FrameSubmissions.size() * 2 + 2);
+        std::vector<vk::CommandBuffer> fixups;
+        fixups.reserve(m_FrameSubmissions.size() + 1);
+        std::vector<vk::ImageMemoryBarrier2> transitions;
+        std::vector<vk::ImageMemoryBarrier2> restores;     // Left by the previous submission
+        std::vector<vk::ImageMemoryBarrier2> nextRestores; // Left by this one
+
+        auto submitFixups = [&]() {
+            if (restores.empty() && transitions.empty())
+                return;
+
+            fixups.push_back(RecordLayoutFixups(restores, transitions));
+            vk::SubmitInfo submitInfo;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers    = &fixups.back();
+            submits.push_back(submitInfo);
+        };
+
+        for (const FrameSubmission& submission : m_FrameSubmissions)
+        {
+            ENGINE_CORE_ASSERT(submission.commandBuffer, "Vulkan: VulkanGraphicsDevice: EndFrame(): a pass was begun but never ended!");
+
+            transitions.clear();
+            ResolveTextureLayouts(*submission.recording, transitions, nextRestores);
+            submitFixups();
+            restores.swap(nextRestores);
+            nextRestores.clear();
+
+            vk::SubmitInfo submitInfo;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers    = &submission.commandBuffer;
+            if (submission.waitSemaphore)
+            {
+                submitInfo.waitSemaphoreCount = 1;
+                submitInfo.pWaitSemaphores    = &submission.waitSemaphore;
+                submitInfo.pWaitDstStageMask  = &submission.waitStage;
+            }
+            if (submission.signalSemaphore)
+            {
+                submitInfo.signalSemaphoreCount = 1;
+                submitInfo.pSignalSemaphores    = &submission.signalSemaphore;
+            }
+            submits.push_back(submitInfo);
+        }
+
+        // Readbacks at the end of the frame still hand their textures back
+        transitions.clear();
+        submitFixups();
+
+        vk::SubmitInfo timelineSubmit;
+        timelineSubmit.pNext                = &timelineSubmitInfo;
+        timelineSubmit.signalSemaphoreCount = 1;
+        timelineSubmit.pSignalSemaphores    = &*m_FrameTimeline;
+        submits.push_back(timelineSubmit);
+
+        // Submit everything
+        m_Context.GetGraphicsQueue().queue.submit(submits);
+        m_Frames[m_FrameIndex]->SetTimelineValue(signalValue);
+
+        // Present all swapchains that were rendered to with a single call
+        m_PresentSwapChains.clear();
+        m_PresentWaitSemaphores.clear();
+        m_PresentSwapChainHandles.clear();
+        m_PresentImageIndices.clear();
         for (SwapChainHandle handle : m_FrameSwapChainPresentations)
         {
             VulkanSwapChainData& sc = GetSwapChainData(handle);
 
+            // Offscreen images were left in TransferSrc by the pass, there is nothing to hand over
+            if (sc.offscreen)
+                continue;
+
+            m_PresentSwapChains.push_back(&sc);
+            m_PresentWaitSemaphores.push_back(*sc.renderFinishedSemaphores[sc.acquiredImageIndex]);
+            m_PresentSwapChainHandles.push_back(*sc.swapchain);
+            m_PresentImageIndices.push_back(sc.acquiredImageIndex);
+        }
+
+        if (!m_PresentSwapChains.empty())
+        {
+            // A failed call may leave the results untouched, those swapchains are rebuilt too
+            m_PresentResults.assign(m_PresentSwapChains.size(), vk::Result::eErrorOutOfDateKHR);
+
             vk::PresentInfoKHR presentInfo;
-            presentInfo.waitSemaphoreCount = 1;
-            presentInfo.pWaitSemaphores    = &*sc.renderFinishedSemaphores[sc.acquiredImageIndex];
-            presentInfo.swapchainCount     = 1;
-            presentInfo.pSwapchains        = &*sc.swapchain;
-            presentInfo.pImageIndices      = &sc.acquiredImageIndex;
+            presentInfo.waitSemaphoreCount = static_cast<uint32_t>(m_PresentWaitSemaphores.size());
+            presentInfo.pWaitSemaphores    = m_PresentWaitSemaphores.data();
+            presentInfo.swapchainCount     = static_cast<uint32_t>(m_PresentSwapChainHandles.size());
+            presentInfo.pSwapchains        = m_PresentSwapChainHandles.data();
+            presentInfo.pImageIndices      = m_PresentImageIndices.data();
+            presentInfo.pResults           = m_PresentResults.data();
 
             try
             {
-                m_Context.GetGraphicsQueue().queue.presentKHR(presentInfo);
+                m_Context.GetPresentQueue().queue.presentKHR(presentInfo);
             }
             catch (const vk::OutOfDateKHRError&)
             {
-                sc.needsRebuild = true;
+                // Reported per swapchain below
+            }
+
+            for (size_t i = 0; i < m_PresentSwapChains.size(); i++)
+            {
+                if (m_PresentResults[i] == vk::Result::eSuboptimalKHR || m_PresentResults[i] == vk::Result::eErrorOutOfDateKHR)
+                    m_PresentSwapChains[i]->needsRebuild = true;
             }
         }
 
+        // Publish counters
+        m_CommandCounters = m_FrameCounters;
+        m_FrameCounters   = {};
+
         // Advance frame
-        m_FrameIndex = (m_FrameIndex + 1) % k_MaxFramesInFlight;
+        m_FrameIndex = (m_FrameIndex + 1) % m_Desc.framesInFlight;
+    }
+
+    void VulkanGraphicsDevice::ResolveTextureLayouts(const VulkanCommandBuffer& cmd, std::vector<vk::ImageMemoryBarrier2>& transitions, std::vector<vk::ImageMemoryBarrier2>& restores)
+    {
+        for (const auto& [tdata, state] : cmd.m_TextureLayouts)
+        {
+            vk::ImageLayout before = tdata->layout;
+            vk::ImageAspectFlags aspect = VulkanCommon::GetImageAspect(tdata->desc.usage);
+
+            if (state.expected != vk::ImageLayout::eUndefined && before != state.expected)
+            {
+                transitions.push_back(VulkanCommon::GetImageBarrier(
+                    tdata->image,
+                    before,
+                    state.expected,
+                    vk::AccessFlagBits2::eMemoryWrite,
+                    vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+                    vk::PipelineStageFlagBits2::eAllCommands,
+                    vk::PipelineStageFlagBits2::eAllCommands,
+                    aspect
+                ));
+            }
+
+            // Contents that were never written have no layout to go back to
+            bool restore = state.restore && before != vk::ImageLayout::eUndefined;
+            if (restore && before != state.current)
+            {
+                restores.push_back(VulkanCommon::GetImageBarrier(
+                    tdata->image,
+                    state.current,
+                    before,
+                    {},
+                    vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+                    vk::PipelineStageFlagBits2::eAllCommands,
+                    vk::PipelineStageFlagBits2::eAllCommands,
+                    aspect
+                ));
+            }
+
+            tdata->layout = restore ? before : state.current;
+        }
+    }
+
+    vk::CommandBuffer VulkanGraphicsDevice::RecordLayoutFixups(const std::vector<vk::ImageMemoryBarrier2>& restores, const std::vector<vk::ImageMemoryBarrier2>& transitions)
+    {
+        VulkanCommandBuffer* cmd = m_Frames[m_FrameIndex]->GetCommandBufferAllocator().GetOrAllocate(*this);
+        vk::raii::CommandBuffer& commandBuffer = cmd->GetCommandBuffer();
+        commandBuffer.begin({});
+
+        // Restores go first, transitions start from the layouts they restore
+        if (!restores.empty())
+            commandBuffer.pipelineBarrier2(vk::DependencyInfo({}, {}, {}, restores));
+        if (!transitions.empty())
+            commandBuffer.pipelineBarrier2(vk::DependencyInfo({}, {}, {}, transitions));
+
+        commandBuffer.end();
+        return *commandBuffer;
+    }
+
+    void VulkanGraphicsDevice::WaitForFrameLatency()
+    {
+        if(!m_Desc.lowLatency)
+            return;
+
+        // Wait for frame N-1 so input sampled after this returns is as fresh as possible
+        WaitForTimelineValue(m_FrameTimelineValue);
+    }
+
+    void VulkanGraphicsDevice::WaitForTimelineValue(uint64_t value)
+    {
+        if(value == 0)
+            return; // Nothing submitted yet
+
+        vk::SemaphoreWaitInfo waitInfo;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores    = &*m_FrameTimeline;
+        waitInfo.pValues        = &value;
+
+        vk::Result result = m_Context.GetDevice().waitSemaphores(waitInfo, UINT64_MAX);
+        ENGINE_CORE_ASSERT(result == vk::Result::eSuccess, "Vulkan: VulkanGraphicsDevice: WaitForTimelineValue(): wait failed!");
     }
 
     // Render passes
@@ -550,40 +1327,140 @@ namespace Engine::RHI::Vulkan
     
     //}
 
+    uint32_t VulkanGraphicsDevice::ReserveSubmission(const FrameSubmission& submission)
+    {
+        // Caller holds m_PassMutex
+        m_FrameSubmissions.push_back(submission);
+        return static_cast<uint32_t>(m_FrameSubmissions.size() - 1);
+    }
+
     ICommandBuffer* VulkanGraphicsDevice::BeginPass(SwapChainHandle renderTarget, Vec4 clearColor, TextureHandle depthBuffer)
     {
-        // Get swapchain
-        VulkanSwapChainData& sc = GetSwapChainData(renderTarget);
-        
-        // Rebuild
-        if(sc.needsRebuild)
+        RenderPassDesc desc;
+        desc.colorAttachments.push_back({ .swapChain = renderTarget, .clearColor = clearColor });
+        desc.depthAttachment.texture = depthBuffer;
+        return BeginPass(desc);
+    }
+
+    ICommandBuffer* VulkanGraphicsDevice::BeginPass(const RenderPassDesc& desc)
+    {
+        // Resolve attachments
+        std::vector<VulkanRenderAttachment> colorAttachments;
+        colorAttachments.reserve(desc.colorAttachments.size());
+        SwapChainHandle swapChain;
+
+        for(const ColorAttachment& attachment : desc.colorAttachments)
         {
-            RebuildSwapchain(sc);
+            VulkanRenderAttachment& vattachment = colorAttachments.emplace_back();
+            vattachment.loadOp     = VulkanCommon::GetLoadOp(attachment.loadOp);
+            vattachment.clearValue = vk::ClearColorValue(attachment.clearColor.r, attachment.clearColor.g, attachment.clearColor.b, attachment.clearColor.a);
+
+            if(attachment.swapChain.IsValid())
+            {
+                ENGINE_CORE_ASSERT(!swapChain.IsValid(), "Vulkan: VulkanGraphicsDevice: BeginPass(): a pass can only render to one swapchain!");
+                swapChain = attachment.swapChain;
+                vattachment.swapChain = true;
+            }
+            else
+            {
+                vattachment.texture = &GetTextureData(attachment.texture);
+            }
         }
 
-        // If we still need to rebuild, then we return nullptr
-        if(sc.needsRebuild)
+        VulkanRenderAttachment depthAttachment;
+        if(desc.depthAttachment.texture.IsValid())
         {
-            return nullptr;
+            depthAttachment.texture    = &GetTextureData(desc.depthAttachment.texture);
+            depthAttachment.loadOp     = VulkanCommon::GetLoadOp(desc.depthAttachment.loadOp);
+            depthAttachment.clearValue = vk::ClearDepthStencilValue(desc.depthAttachment.clearDepth, 0);
         }
 
-        // Acquire next image
-        sc.acquiredImageIndex = sc.swapchain.acquireNextImage(
-            UINT64_MAX,
-            sc.presentCompleteSemaphores[m_FrameIndex],
-            nullptr
-        ).value;
-
-        VulkanTextureData* depthBufferData = nullptr;
-        if(depthBuffer.IsValid())
+        uint32_t submissionIndex = 0;
         {
-            depthBufferData = &GetTextureData(depthBuffer);
+            std::lock_guard<std::mutex> lock(m_PassMutex);
+
+            if(swapChain.IsValid())
+            {
+                // Get swapchain
+                VulkanSwapChainData& sc = GetSwapChainData(swapChain);
+
+                // Rebuild. Resizes only flag the swapchain, so any number of them lead to one rebuild per frame
+                uint64_t frame = m_FrameTimelineValue + 1;
+                if(sc.needsRebuild && sc.rebuildFrame != frame)
+                {
+                    RebuildSwapchain(sc);
+                    sc.rebuildFrame = frame;
+                }
+
+                // If we still need to rebuild, then we return nullptr
+                if(sc.needsRebuild)
+                {
+                    return nullptr;
+                }
+
+                // Offscreen swapchains render to this frame's image, which the frame's fence already guards.
+                // Windowed ones acquire the next image. Suboptimal images can still be presented, the swapchain is
+                // rebuilt next frame
+                if(sc.offscreen)
+                {
+                    sc.acquiredImageIndex = m_FrameIndex;
+                }
+                else
+                {
+                    try
+                    {
+                        auto acquired = sc.swapchain.acquireNextImage(
+                            UINT64_MAX,
+                            sc.presentCompleteSemaphores[m_FrameIndex],
+                            nullptr
+                        );
+                        sc.acquiredImageIndex = acquired.value;
+                        if(acquired.result == vk::Result::eSuboptimalKHR)
+                            sc.needsRebuild = true;
+                    }
+                    catch (const vk::OutOfDateKHRError&)
+                    {
+                        sc.needsRebuild = true;
+                        return nullptr;
+                    }
+                }
+
+                for(VulkanRenderAttachment& attachment : colorAttachments)
+                {
+                    if(attachment.swapChain)
+                    {
+                        attachment.texture   = &sc.textures[sc.acquiredImageIndex];
+                        attachment.offscreen = sc.offscreen;
+                    }
+                }
+
+                // Reserve our place in the submit order
+                if(sc.offscreen)
+                {
+                    submissionIndex = ReserveSubmission({});
+                }
+                else
+                {
+                    submissionIndex = ReserveSubmission({
+                        .waitSemaphore   = *sc.presentCompleteSemaphores[m_FrameIndex],
+                        .waitStage       = vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                        .signalSemaphore = *sc.renderFinishedSemaphores[sc.acquiredImageIndex]
+                    });
+                }
+                m_FrameSwapChainPresentations.push_back(swapChain);
+            }
+            else
+            {
+                submissionIndex = ReserveSubmission({});
+            }
         }
 
-        // Get command buffer and begin rendering
+        // Get command buffer from this thread's pool and begin rendering
         VulkanCommandBuffer* cmd = m_Frames[m_FrameIndex]->GetCommandBufferAllocator().GetOrAllocate(*this);
-        cmd->BeginRendering(&sc.textures[sc.acquiredImageIndex], clearColor, depthBufferData);
-        m_FrameSwapChainPresentations.push_back(renderTarget);
+        cmd->m_SubmissionIndex = submissionIndex;
+        cmd->m_SwapChain = swapChain;
+        cmd->BeginRendering(std::move(colorAttachments), depthAttachment, desc.barriers,
+            desc.name.empty() ? std::format("Pass {0}", submissionIndex) : desc.name);
 
         return cmd;
     }
@@ -592,34 +1469,146 @@ namespace Engine::RHI::Vulkan
     {
         ENGINE_ASSERT(cmd != nullptr, "Vulkan: VulkanGraphicsDevice: EndPass(): cmd is nullptr!");
 
-        // End command buffer
         VulkanCommandBuffer* vcmd = static_cast<VulkanCommandBuffer*>(cmd);
-        vcmd->EndRendering();
 
-        // Swapchain data
-        SwapChainHandle sc = m_FrameSwapChainPresentations.back();
-        VulkanSwapChainData& scData = GetSwapChainData(sc);
+        // End command buffer. Compute passes don't touch a swapchain
+        if(vcmd->IsComputePass())
+        {
+            vcmd->EndCompute();
+        }
+        else
+        {
+            vcmd->EndRendering();
+        }
 
-        // Semaphores
-        vk::Semaphore presentComplete = *scData.presentCompleteSemaphores[m_FrameIndex];
-        vk::Semaphore renderFinished  = *scData.renderFinishedSemaphores[scData.acquiredImageIndex];
+        // Fill the slot reserved in Begin*Pass()
+        std::lock_guard<std::mutex> lock(m_PassMutex);
+        m_FrameSubmissions[vcmd->m_SubmissionIndex].commandBuffer = *vcmd->GetCommandBuffer();
+        m_FrameSubmissions[vcmd->m_SubmissionIndex].recording     = vcmd;
+        m_FrameCounters += vcmd->GetCounters();
+        m_FrameCounters.passes++;
+    }
 
-        // Submit info
-        m_FrameCommandBuffers.push_back(*vcmd->GetCommandBuffer());
-        m_FrameWaitSemaphores.push_back(presentComplete);
-        m_FrameSignalSemaphores.push_back(renderFinished);
-        m_FrameStageFlags.push_back(vk::PipelineStageFlagBits::eColorAttachmentOutput);
+    ICommandBuffer* VulkanGraphicsDevice::BeginComputePass(const std::vector<TextureBarrier>& barriers, const std::string& name)
+    {
+        uint32_t submissionIndex = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_PassMutex);
+            submissionIndex = ReserveSubmission({});
+        }
 
-        vk::SubmitInfo submitInfo;
-        submitInfo.waitSemaphoreCount   = 1;
-        submitInfo.pWaitSemaphores      = &m_FrameWaitSemaphores.back();
-        submitInfo.pWaitDstStageMask    = &m_FrameStageFlags.back();
-        submitInfo.commandBufferCount   = 1;
-        submitInfo.pCommandBuffers      = &m_FrameCommandBuffers.back();
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores    = &m_FrameSignalSemaphores.back();
+        VulkanCommandBuffer* cmd = m_Frames[m_FrameIndex]->GetCommandBufferAllocator().GetOrAllocate(*this);
+        cmd->m_SubmissionIndex = submissionIndex;
+        cmd->BeginCompute(barriers, name.empty() ? std::format("Compute Pass {0}", submissionIndex) : name);
+        return cmd;
+    }
+
+    // Readback
+    ReadbackTicket VulkanGraphicsDevice::RequestReadback(TextureHandle texture, const TextureRegion& region)
+    {
+        return RequestTextureReadback(GetTextureData(texture), region);
+    }
+
+    ReadbackTicket VulkanGraphicsDevice::RequestReadback(SwapChainHandle swapChain, const TextureRegion& region)
+    {
+        VulkanSwapChainData& sc = GetSwapChainData(swapChain);
+        ENGINE_CORE_ASSERT(sc.offscreen, "Vulkan: VulkanGraphicsDevice: RequestReadback(): only offscreen swapchains can be read back!");
+        ENGINE_CORE_ASSERT(!sc.textures.empty(), "Vulkan: VulkanGraphicsDevice: RequestReadback(): swapchain has no images!");
+
+        // Latest image rendered to. Its frame index doesn't come around again before this frame's copy
+        return RequestTextureReadback(sc.textures[sc.acquiredImageIndex], region);
+    }
 
-        m_FrameSubmits.push_back(submitInfo);
+    ReadbackTicket VulkanGraphicsDevice::RequestReadback(BufferHandle buffer, const BufferRegion& region)
+    {
+        VulkanBufferData& bdata = GetBufferData(buffer);
+        ENGINE_CORE_ASSERT(bdata.desc.usage == BufferUsage::Static, "Vulkan: VulkanGraphicsDevice: RequestReadback(): only static buffers can be read back!");
+
+        ENGINE_CORE_ASSERT(region.offset < bdata.desc.size, "Vulkan: VulkanGraphicsDevice: RequestReadback(): region is out of bounds!");
+        size_t size = region.size != 0 ? region.size : bdata.desc.size - region.offset;
+        ENGINE_CORE_ASSERT(size <= bdata.desc.size - region.offset, "Vulkan: VulkanGraphicsDevice: RequestReadback(): region is out of bounds!");
+
+        ReadbackTicket ticket{ .id = ReadbackTicket::AllocateID() };
+        vk::Buffer readback = m_ReadbackRing->Request(ticket.id, size, m_FrameTimelineValue + 1);
+
+        VulkanCommandBuffer* cmd = BeginReadback(ticket);
+        cmd->CopyBufferToReadback(bdata.buffer, region.offset, size, readback);
+        EndReadback(cmd);
+
+        return ticket;
+    }
+
+    ReadbackTicket VulkanGraphicsDevice::RequestTextureReadback(VulkanTextureData& tdata, const TextureRegion& region)
+    {
+        ENGINE_CORE_ASSERT(!VulkanCommon::IsCompressed(tdata.desc.format), "Vulkan: VulkanGraphicsDevice: RequestReadback(): compressed textures can't be read back!");
+        ENGINE_CORE_ASSERT(region.mipLevel < tdata.desc.mipLevels, "Vulkan: VulkanGraphicsDevice: RequestReadback(): mip level is out of range!");
+
+        uint32_t levelWidth  = std::max(1u, tdata.desc.width >> region.mipLevel);
+        uint32_t levelHeight = std::max(1u, tdata.desc.height >> region.mipLevel);
+        ENGINE_CORE_ASSERT(region.x < levelWidth && region.y < levelHeight, "Vulkan: VulkanGraphicsDevice: RequestReadback(): region is out of bounds!");
+        uint32_t width  = region.width  != 0 ? region.width  : levelWidth - region.x;
+        uint32_t height = region.height != 0 ? region.height : levelHeight - region.y;
+        ENGINE_CORE_ASSERT(width <= levelWidth - region.x && height <= levelHeight - region.y, "Vulkan: VulkanGraphicsDevice: RequestReadback(): region is out of bounds!");
+
+        // Depth formats only copy their depth aspect, 4 bytes per texel for both Depth32 and Depth24Stencil8
+        vk::BufferImageCopy copy(
+            0, 0, 0,
+            vk::ImageSubresourceLayers(VulkanCommon::GetImageAspect(tdata.desc.usage), region.mipLevel, 0, 1),
+            vk::Offset3D(static_cast<int32_t>(region.x), static_cast<int32_t>(region.y), 0),
+            vk::Extent3D(width, height, 1)
+        );
+        size_t size = static_cast<size_t>(width) * height * VulkanCommon::GetPixelSize(tdata.desc.format);
+
+        ReadbackTicket ticket{ .id = ReadbackTicket::AllocateID() };
+        vk::Buffer readback = m_ReadbackRing->Request(ticket.id, size, m_FrameTimelineValue + 1);
+
+        VulkanCommandBuffer* cmd = BeginReadback(ticket);
+        cmd->CopyTextureToReadback(tdata, copy, readback);
+        EndReadback(cmd);
+
+        return ticket;
+    }
+
+    VulkanCommandBuffer* VulkanGraphicsDevice::BeginReadback(ReadbackTicket ticket)
+    {
+        uint32_t submissionIndex = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_PassMutex);
+            submissionIndex = ReserveSubmission({});
+        }
+
+        VulkanCommandBuffer* cmd = m_Frames[m_FrameIndex]->GetCommandBufferAllocator().GetOrAllocate(*this);
+        cmd->m_SubmissionIndex = submissionIndex;
+        cmd->BeginTransfer(std::format("Readback {0}", ticket.id));
+        return cmd;
+    }
+
+    void VulkanGraphicsDevice::EndReadback(VulkanCommandBuffer* cmd)
+    {
+        cmd->EndTransfer();
+
+        std::lock_guard<std::mutex> lock(m_PassMutex);
+        m_FrameSubmissions[cmd->m_SubmissionIndex].commandBuffer = *cmd->GetCommandBuffer();
+        m_FrameSubmissions[cmd->m_SubmissionIndex].recording     = cmd;
+        m_FrameCounters.readbacks++;
+    }
+
+    bool VulkanGraphicsDevice::PollReadback(ReadbackTicket& ticket, std::vector<char>& data)
+    {
+        ENGINE_CORE_ASSERT(ticket.IsValid(), "Vulkan: VulkanGraphicsDevice: PollReadback(): ticket is invalid!");
+
+        if (!m_ReadbackRing->Poll(ticket.id, GetCompletedTimelineValue(), data))
+            return false;
+
+        ticket.id = 0;
+        return true;
+    }
+
+    void VulkanGraphicsDevice::CancelReadback(ReadbackTicket& ticket)
+    {
+        if (ticket.IsValid())
+            m_ReadbackRing->Cancel(ticket.id);
+        ticket.id = 0;
     }
 
     // Immediate command buffer
@@ -640,6 +1629,17 @@ namespace Engine::RHI::Vulkan
         ENGINE_CORE_ASSERT(m_InImmediatePass != false, "Vulkan: VulkanGraphicsDevice: EndImmediate(): not in immediate pass!");
 
         m_ImmediateCommandBuffer->EndImmediate();
+        {
+            std::lock_guard<std::mutex> lock(m_PassMutex);
+            m_FrameCounters += m_ImmediateCommandBuffer->GetCounters();
+        }
+
+        // Submitted ahead of every pass still being recorded, so its layouts apply right away
+        for (const auto& [tdata, state] : m_ImmediateCommandBuffer->m_TextureLayouts)
+        {
+            ENGINE_CORE_ASSERT(state.expected == vk::ImageLayout::eUndefined, "Vulkan: VulkanGraphicsDevice: EndImmediate(): immediate command buffers can't depend on a tracked layout!");
+            tdata->layout = state.current;
+        }
 
         vk::SubmitInfo submitInfo;
         submitInfo.commandBufferCount = 1;
@@ -651,6 +1651,7 @@ namespace Engine::RHI::Vulkan
         m_Context.GetDevice().resetFences(*m_ImmediateFence);
 
         m_ImmediateCommandBuffer->Reset();
+        m_ImmediateDescriptorSetAllocator->Reset();
         m_InImmediatePass = false;
     }
 
@@ -685,12 +1686,22 @@ namespace Engine::RHI::Vulkan
     void VulkanGraphicsDevice::OnDestroy()
     {
         m_Context.GetDevice().waitIdle();
+        m_Context.SavePipelineCache();
+
+        if(!m_Desc.pipelineManifestPath.empty())
+        {
+            m_PipelineManifest.Save(m_Desc.pipelineManifestPath);
+        }
     }
 
     // Swapchains
     void VulkanGraphicsDevice::RebuildSwapchain(VulkanSwapChainData& swapChainData)
     {
-        m_Context.GetDevice().waitIdle();
+        if (swapChainData.offscreen)
+        {
+            RebuildOffscreenSwapchain(swapChainData);
+            return;
+        }
 
         vk::SurfaceCapabilitiesKHR capabilities = m_Context.GetPhysicalDevice().getSurfaceCapabilitiesKHR(*swapChainData.surface);
 
@@ -705,12 +1716,6 @@ namespace Engine::RHI::Vulkan
         if (swapChainData.extent.width == 0 || swapChainData.extent.height == 0)
             return;
 
-        // Clear
-        swapChainData.renderFinishedSemaphores.clear();
-        swapChainData.presentCompleteSemaphores.clear();
-        swapChainData.textures.clear();
-        swapChainData.images.clear();
-
         // Format
         swapChainData.surfaceFormat = VulkanCommon::ChooseSurfaceFormat(
             m_Context.GetPhysicalDevice().getSurfaceFormatsKHR(*swapChainData.surface),
@@ -731,7 +1736,11 @@ namespace Engine::RHI::Vulkan
         }
 
         // Min images
-        uint32_t minImages = VulkanCommon::GetSurfaceMinImageCount(capabilities);
+        uint32_t minImages = VulkanCommon::GetSurfaceMinImageCount(capabilities, m_Desc.framesInFlight);
+
+        // Images rendered on one family and presented on another are shared instead of transferred each frame
+        std::array<uint32_t, 2> queueFamilies = { m_Context.GetGraphicsQueue().familyIndex, m_Context.GetPresentQueue().familyIndex };
+        bool shared = m_Context.HasSeparatePresentQueue();
 
         // Swapchain
         vk::SwapchainCreateInfoKHR swapChainCreateInfo(
@@ -743,8 +1752,9 @@ namespace Engine::RHI::Vulkan
             swapChainData.extent,
             1,
             vk::ImageUsageFlagBits::eColorAttachment,
-            vk::SharingMode::eExclusive,
-            0, nullptr,
+            shared ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+            shared ? static_cast<uint32_t>(queueFamilies.size()) : 0,
+            shared ? queueFamilies.data() : nullptr,
             capabilities.currentTransform,
             vk::CompositeAlphaFlagBitsKHR::eOpaque,
             swapChainData.vkPresentMode,
@@ -752,7 +1762,26 @@ namespace Engine::RHI::Vulkan
             *swapChainData.swapchain
         );
         
-        swapChainData.swapchain = vk::raii::SwapchainKHR(m_Context.GetDevice(), swapChainCreateInfo);
+        vk::raii::SwapchainKHR swapchain(m_Context.GetDevice(), swapChainCreateInfo);
+
+        // Creating the new swapchain retired the old one. Frames in flight may still render to or present its images,
+        // so it is destroyed after framesInFlight frames, like queued resource destruction
+        if(*swapChainData.swapchain)
+        {
+            VulkanSwapChainData::Retired& retired = swapChainData.retired.emplace_back();
+            retired.swapchain = std::move(swapChainData.swapchain);
+            retired.textures  = std::move(swapChainData.textures);
+            for(auto& semaphore : swapChainData.renderFinishedSemaphores)
+                retired.semaphores.push_back(std::move(semaphore));
+            for(auto& semaphore : swapChainData.presentCompleteSemaphores)
+                retired.semaphores.push_back(std::move(semaphore));
+            retired.framesRemaining = m_Desc.framesInFlight;
+        }
+        swapChainData.renderFinishedSemaphores.clear();
+        swapChainData.presentCompleteSemaphores.clear();
+        swapChainData.textures.clear();
+
+        swapChainData.swapchain = std::move(swapchain);
         swapChainData.images = swapChainData.swapchain.getImages();
 
         // Textures
@@ -784,7 +1813,7 @@ namespace Engine::RHI::Vulkan
         }
 
         // PresentCompleteSemaphores: per global frame
-        for(int i = 0; i < k_MaxFramesInFlight; i++)
+        for(uint32_t i = 0; i < m_Desc.framesInFlight; i++)
         {
             swapChainData.presentCompleteSemaphores.emplace_back(m_Context.GetDevice(), semaphoreCreateInfo);
         }
@@ -792,6 +1821,72 @@ namespace Engine::RHI::Vulkan
         swapChainData.needsRebuild = false;
     }
 
+    void VulkanGraphicsDevice::RebuildOffscreenSwapchain(VulkanSwapChainData& swapChainData)
+    {
+        swapChainData.extent = vk::Extent2D(swapChainData.width, swapChainData.height);
+
+        // Skip if width or height is 0
+        if (swapChainData.extent.width == 0 || swapChainData.extent.height == 0)
+            return;
+
+        // Any render target format works without a surface
+        swapChainData.surfaceFormat = vk::SurfaceFormatKHR(VulkanCommon::GetPixelFormat(swapChainData.format), vk::ColorSpaceKHR::eSrgbNonlinear);
+
+        // Old images may still be rendered to by frames in flight
+        if (!swapChainData.textures.empty())
+        {
+            VulkanSwapChainData::Retired& retired = swapChainData.retired.emplace_back();
+            retired.textures = std::move(swapChainData.textures);
+            retired.framesRemaining = m_Desc.framesInFlight;
+        }
+        swapChainData.textures.clear();
+        swapChainData.images.clear();
+
+        TextureDesc texDesc{
+            .width = swapChainData.extent.width,
+            .height = swapChainData.extent.height,
+            .format = swapChainData.format,
+            .usage = TextureUsage::RenderTarget
+        };
+
+        VkImageCreateInfo imageInfo = GetImageCreateInfo(texDesc); // Finished frames are copied out instead of presented
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+        // One image per frame in flight, so a frame never renders over one that is still being read
+        for (uint32_t i = 0; i < m_Desc.framesInFlight; i++)
+        {
+            VulkanTextureData& texData = swapChainData.textures.emplace_back();
+            texData.desc = texDesc;
+            texData.format = swapChainData.surfaceFormat.format;
+            texData.ownsImage = true;
+
+            VkImage image = nullptr;
+            vmaCreateImage(m_Context.GetAllocator(), &imageInfo, &allocInfo, &image, &texData.allocation, nullptr);
+            texData.image = image;
+            m_Context.TrackAllocation(VulkanMemoryCategory::Texture, texData.allocation);
+
+            CreateImageView(texData);
+            swapChainData.images.push_back(texData.image);
+        }
+
+        swapChainData.needsRebuild = false;
+    }
+
+    void VulkanGraphicsDevice::DestroySwapChainTextures(std::vector<VulkanTextureData>& textures)
+    {
+        for (auto& texData : textures)
+        {
+            if (texData.ownsImage && texData.image && texData.allocation)
+            {
+                m_Context.UntrackAllocation(VulkanMemoryCategory::Texture, texData.allocation);
+                vmaDestroyImage(m_Context.GetAllocator(), texData.image, texData.allocation);
+            }
+        }
+        textures.clear();
+    }
+
     void VulkanGraphicsDevice::CreateImageView(VulkanTextureData& textureData)
     {
         vk::ImageAspectFlags aspect = textureData.desc.usage.Has(TextureUsage::DepthStencil)
@@ -804,30 +1899,39 @@ namespace Engine::RHI::Vulkan
             vk::ImageViewType::e2D,
             textureData.format,
             {},
-            { aspect, 0, 1, 0, 1 }
+            { aspect, 0, textureData.desc.mipLevels, 0, 1 }
         );
 
         textureData.imageView = vk::raii::ImageView(m_Context.GetDevice(), imageViewCreateInfo);
     }
 
-    void VulkanGraphicsDevice::CreateSampler(VulkanTextureData& textureData)
+    vk::Sampler VulkanGraphicsDevice::GetOrCreateSampler(const SamplerDesc& desc)
     {
-        // Create sampler
-        // TODO: Vulkan: Texture sampling options
-        // Hardcoded: linear sampling, repeat
+        auto it = m_Samplers.find(desc);
+        if (it != m_Samplers.end())
+            return *it->second;
+
         vk::SamplerCreateInfo samplerInfo{};
-        samplerInfo.magFilter = vk::Filter::eLinear;
-        samplerInfo.minFilter = vk::Filter::eLinear;
-        samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
-        samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
-        samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-        samplerInfo.anisotropyEnable = vk::False;
-        samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+        samplerInfo.magFilter = VulkanCommon::GetFilter(desc.magFilter);
+        samplerInfo.minFilter = VulkanCommon::GetFilter(desc.minFilter);
+        samplerInfo.mipmapMode = VulkanCommon::GetMipmapMode(desc.mipFilter);
+        samplerInfo.addressModeU = VulkanCommon::GetAddressMode(desc.addressU);
+        samplerInfo.addressModeV = VulkanCommon::GetAddressMode(desc.addressV);
+        samplerInfo.addressModeW = VulkanCommon::GetAddressMode(desc.addressU);
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+        samplerInfo.borderColor = vk::BorderColor::eFloatOpaqueBlack;
         samplerInfo.unnormalizedCoordinates = vk::False;
         samplerInfo.compareEnable = vk::False;
-        samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
 
-        textureData.sampler = vk::raii::Sampler(m_Context.GetDevice(), samplerInfo);
+        if (desc.maxAnisotropy > 1.0f && m_Context.GetCapabilities().samplerAnisotropy)
+        {
+            samplerInfo.anisotropyEnable = vk::True;
+            samplerInfo.maxAnisotropy = std::min(desc.maxAnisotropy, m_Context.GetPhysicalDeviceProperties().limits.maxSamplerAnisotropy);
+        }
+
+        auto [inserted, _] = m_Samplers.emplace(desc, vk::raii::Sampler(m_Context.GetDevice(), samplerInfo));
+        return *inserted->second;
     }
 
     // Public getters for Vulkan classes
@@ -841,6 +1945,16 @@ namespace Engine::RHI::Vulkan
         return it->second;
     }
 
+    VulkanHeapData& VulkanGraphicsDevice::GetHeapData(HeapHandle heap)
+    {
+        ENGINE_CORE_ASSERT(heap.IsValid(), "Vulkan: VulkanGraphicsDevice: GetHeapData: heap is invalid!");
+    
+        auto it = m_Heaps.find(heap.id);
+        ENGINE_ASSERT(it != m_Heaps.end(), "Vulkan: VulkanGraphicsDevice: GetHeapData: heap is not found!");
+        
+        return it->second;
+    }
+
     VulkanTextureData& VulkanGraphicsDevice::GetTextureData(TextureHandle texture)
     {
         ENGINE_CORE_ASSERT(texture.IsValid(), "Vulkan: VulkanGraphicsDevice: GetTextureData: texture is invalid!");
@@ -861,6 +1975,14 @@ namespace Engine::RHI::Vulkan
         return it->second;
     }
 
+    VulkanPipelineLayoutData& VulkanGraphicsDevice::GetPipelineLayoutData(uint32_t layoutId)
+    {
+        auto it = m_PipelineLayouts.find(layoutId);
+        ENGINE_ASSERT(it != m_PipelineLayouts.end(), "Vulkan: VulkanGraphicsDevice: GetPipelineLayoutData: layout is not found!");
+
+        return it->second;
+    }
+
     VulkanPipelineData& VulkanGraphicsDevice::GetPipelineData(PipelineHandle pipeline)
     {
         ENGINE_CORE_ASSERT(pipeline.IsValid(), "Vulkan: VulkanGraphicsDevice: GetPipelineData: pipeline is invalid!");
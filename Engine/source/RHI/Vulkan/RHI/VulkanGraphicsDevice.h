@@ -10,9 +10,15 @@
 #include "RHI/Vulkan/VulkanContext.h"
 #include "RHI/Vulkan/VulkanResourceData.h"
 #include "RHI/Vulkan/VulkanCommandBufferAllocator.h"
+#include "RHI/Vulkan/VulkanPipelineCompiler.h"
+#include "RHI/Vulkan/VulkanResourceReleaser.h"
+#include "RHI/PipelineManifest.h"
 
 #include <vector>
 #include <array>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <unordered_map>
 
 #include <vulkan/vulkan_raii.hpp>
@@ -23,6 +29,9 @@ namespace Engine::RHI::Vulkan
     class IVulkanGraphicsBridge;
     class VulkanFrame;
     class VulkanCommandBuffer;
+    class VulkanCommandBundle;
+    class VulkanDescriptorSetAllocator;
+    class VulkanReadbackRing;
 
     class ENGINE_EXPORT VulkanGraphicsDevice: public IGraphicsDevice
     {
@@ -31,22 +40,72 @@ namespace Engine::RHI::Vulkan
         Scope<IVulkanGraphicsBridge> m_Bridge;
         VulkanContext m_Context;
 
+        // Config
+        GraphicsDeviceDesc m_Desc;
+
         // Frame pacing
         std::vector<Scope<VulkanFrame>> m_Frames;
         uint32_t m_FrameIndex;
 
-        // Global frame submission info
-        std::vector<vk::SubmitInfo> m_FrameSubmits;
-        std::vector<vk::CommandBuffer> m_FrameCommandBuffers;
-        std::vector<vk::Semaphore> m_FrameWaitSemaphores;
-        std::vector<vk::Semaphore> m_FrameSignalSemaphores;
-        std::vector<vk::PipelineStageFlags> m_FrameStageFlags;
+        // CPU/GPU sync: a single timeline semaphore, signalled with an increasing value at the end of each frame
+        vk::raii::Semaphore m_FrameTimeline = nullptr;
+        uint64_t            m_FrameTimelineValue = 0; // Last value submitted for signalling
+
+        // Latest resolved GPU timings
+        GpuFrameTimings m_GpuTimings;
+
+        // Command counters of the frame being recorded (guarded by m_PassMutex) and of the last ended frame
+        CommandCounters m_FrameCounters;
+        CommandCounters m_CommandCounters;
+
+        // Memory budget
+        std::function<void(const MemoryStats&)> m_MemoryBudgetCallback;
+        bool                                    m_OverMemoryBudget = false; // Callback fires on the rising edge
+
+        void CheckMemoryBudget();
+
+        void WaitForTimelineValue(uint64_t value);
+
+        // Global frame submission info. BeginPass() reserves a slot, so passes are submitted in the order they were begun
+        // no matter which thread ends them first. vk::SubmitInfos are only built in EndFrame() so nothing points into a
+        // vector that may still grow.
+        struct FrameSubmission {
+            vk::CommandBuffer      commandBuffer   = nullptr; // Set by EndPass()
+            VulkanCommandBuffer*   recording       = nullptr; // Set with commandBuffer, holds the layouts it expects and leaves
+            vk::Semaphore          waitSemaphore   = nullptr; // Swapchain image acquired, graphics passes only
+            vk::PipelineStageFlags waitStage;
+            vk::Semaphore          signalSemaphore = nullptr; // Rendering finished, graphics passes only
+        };
+        std::vector<FrameSubmission> m_FrameSubmissions;
         std::vector<SwapChainHandle> m_FrameSwapChainPresentations;
+        std::mutex                   m_PassMutex; // Guards the two vectors above and swapchain acquisition
+
+        // Scratch for the single present call in EndFrame(), one entry per presented swapchain
+        std::vector<VulkanSwapChainData*> m_PresentSwapChains;
+        std::vector<vk::Semaphore>        m_PresentWaitSemaphores;
+        std::vector<vk::SwapchainKHR>     m_PresentSwapChainHandles;
+        std::vector<uint32_t>             m_PresentImageIndices;
+        std::vector<vk::Result>           m_PresentResults;
+
+        uint32_t ReserveSubmission(const FrameSubmission& submission);
+
+        // Texture layouts are resolved in submission order in EndFrame(). Each pass expects its textures in some layout
+        // and leaves them in another; where the previous submission disagrees, a fixup command buffer goes in between.
+        void ResolveTextureLayouts(const VulkanCommandBuffer& cmd, std::vector<vk::ImageMemoryBarrier2>& transitions, std::vector<vk::ImageMemoryBarrier2>& restores);
+        vk::CommandBuffer RecordLayoutFixups(const std::vector<vk::ImageMemoryBarrier2>& restores, const std::vector<vk::ImageMemoryBarrier2>& transitions);
+
+        // Readbacks are recorded as transfer-only submissions in the pass order
+        Scope<VulkanReadbackRing> m_ReadbackRing;
+
+        ReadbackTicket RequestTextureReadback(VulkanTextureData& tdata, const TextureRegion& region);
+        VulkanCommandBuffer* BeginReadback(ReadbackTicket ticket);
+        void EndReadback(VulkanCommandBuffer* cmd);
 
         // Immediate command buffers
         bool                       m_InImmediatePass        = false;
         vk::raii::CommandPool      m_ImmediatePool          = nullptr;
         Scope<VulkanCommandBuffer> m_ImmediateCommandBuffer;
+        Scope<VulkanDescriptorSetAllocator> m_ImmediateDescriptorSetAllocator;
         vk::raii::Fence            m_ImmediateFence         = nullptr;
 
         // TODO: Vulkan: VulkanResourceManager: Wrap resource creation, destruction, & destruction queue
@@ -54,34 +113,76 @@ namespace Engine::RHI::Vulkan
         std::unordered_map<uint32_t, VulkanBufferData> m_Buffers;
         std::unordered_map<uint32_t, VulkanTextureData> m_Textures;
         std::unordered_map<uint32_t, VulkanShaderData> m_Shaders;
+        std::unordered_map<uint32_t, VulkanPipelineLayoutData> m_PipelineLayouts;
         std::unordered_map<uint32_t, VulkanPipelineData> m_Pipelines;
         std::unordered_map<uint32_t, VulkanSwapChainData> m_SwapChains;
-
-        // Deletion queue
+        std::unordered_map<uint32_t, VulkanHeapData> m_Heaps;
+        std::unordered_map<uint32_t, Scope<VulkanCommandBundle>> m_CommandBundles;
+        uint32_t m_NextCommandBundleID = 1;
+
+        // Deduplication: identical pipeline descs share a pipeline, identical binding signatures share a layout
+        std::unordered_map<PipelineDesc, uint32_t> m_PipelineLookup;
+        std::unordered_map<ComputePipelineDesc, uint32_t> m_ComputePipelineLookup;
+        std::unordered_map<VulkanPipelineLayoutKey, uint32_t, VulkanPipelineLayoutKeyHash> m_PipelineLayoutLookup;
+        uint32_t m_NextPipelineLayoutID = 1;
+
+        uint32_t GetOrCreatePipelineLayout(const VulkanPipelineLayoutKey& key);
+        void ReleasePipelineLayout(uint32_t layoutId);
+
+        // Pipeline compilation. Async pipelines are polled each frame and resolved once their future is ready
+        Scope<VulkanPipelineCompiler> m_PipelineCompiler;
+        std::vector<uint32_t>         m_PendingPipelines;
+        PipelineManifest              m_PipelineManifest;
+        std::mutex                    m_PipelineMutex; // Resolving a pending pipeline may race with recording threads
+
+        PipelineHandle CreatePipelineInternal(const PipelineDesc& desc, bool async, uint32_t refCount);
+        bool ResolvePendingPipeline(uint32_t id, VulkanPipelineData& data, bool wait);
+        void PollPendingPipelines();
+
+        // Shared quad index buffer, grown in powers of two and uploaded with the immediate command buffer
+        BufferHandle m_QuadIndexBuffer;
+        uint32_t     m_QuadIndexCapacity = 0;
+
+        // Deletion queue. Destructions are bucketed by the frame timeline value that must complete before they run,
+        // so a flush pops whole buckets off the front instead of walking every queued resource
         struct QueuedDestruction {
-            enum class Type { Buffer, Texture, Shader, Pipeline, SwapChain };
+            enum class Type { Buffer, Texture, Shader, Pipeline, SwapChain, CommandBundle, Heap };
             Type     type;
             uint32_t id;
-            uint32_t framesRemaining;
         };
 
-        std::vector<QueuedDestruction> m_DeletionQueue;
+        struct DeletionBucket {
+            uint64_t                       timelineValue = 0;
+            std::vector<QueuedDestruction> destructions;
+        };
+
+        std::deque<DeletionBucket>    m_DeletionQueue; // Ascending timeline values
+        Scope<VulkanResourceReleaser> m_ResourceReleaser;
 
         void FlushDeletionQueue(bool forceNow = false);
         void EnqueueDeletion(QueuedDestruction::Type type, uint32_t id);
 
-        // Destroy
-        void ImmediateDestroy(QueuedDestruction::Type type, uint32_t id);
+        // Destroy. Vulkan objects and memory go to the batch and are released together once the flush is done
+        void ImmediateDestroy(QueuedDestruction::Type type, uint32_t id, VulkanReleaseBatch& batch);
 
         // Swapchain
         void RebuildSwapchain(VulkanSwapChainData& swapChainData);
+        void RebuildOffscreenSwapchain(VulkanSwapChainData& swapChainData);
+        void DestroySwapChainTextures(std::vector<VulkanTextureData>& textures); // Frees images owned by offscreen swapchains
 
         // Textures
+        VkImageCreateInfo GetImageCreateInfo(const TextureDesc& desc);
+        void CreateTextureViews(VulkanTextureData& textureData);
+        void InitializeStorageLayout(VulkanTextureData& textureData); // Storage images are moved to eGeneral once, at creation
         void CreateImageView(VulkanTextureData& textureData);
-        void CreateSampler(VulkanTextureData& textureData);
+
+        // Samplers live as long as the device. There are only a few distinct descs
+        std::unordered_map<SamplerDesc, vk::raii::Sampler> m_Samplers;
+
+        vk::Sampler GetOrCreateSampler(const SamplerDesc& desc);
 
     public:
-        VulkanGraphicsDevice(Scope<IVulkanGraphicsBridge> bridge);
+        VulkanGraphicsDevice(Scope<IVulkanGraphicsBridge> bridge, const GraphicsDeviceDesc& desc = {});
         ~VulkanGraphicsDevice() override;
 
         // Resource creation
@@ -91,6 +192,23 @@ namespace Engine::RHI::Vulkan
         PipelineHandle  CreatePipeline(const PipelineDesc& desc) override;
         SwapChainHandle CreateSwapChain(const SwapChainDesc& desc) override;
 
+        // Background pipeline compilation
+        PipelineHandle  CreatePipelineAsync(const PipelineDesc& desc) override;
+        bool            IsPipelineReady(PipelineHandle pipeline) override;
+        void            WaitForPipeline(PipelineHandle pipeline); // Blocks until the pipeline is compiled
+
+        PipelineHandle  CreateComputePipeline(const ComputePipelineDesc& desc) override;
+
+        // Heaps and placed textures
+        MemoryRequirements GetTextureMemoryRequirements(const TextureDesc& desc) override;
+        HeapHandle         CreateHeap(const HeapDesc& desc) override;
+        TextureHandle      CreatePlacedTexture(const TextureDesc& desc, HeapHandle heap, size_t offset) override;
+        void               DestroyHeap(HeapHandle& heap) override;
+
+        // Command bundles
+        ICommandBundle* CreateCommandBundle(const CommandBundleDesc& desc) override;
+        void            DestroyCommandBundle(ICommandBundle*& bundle) override;
+
         // Resource destruction
         void DestroyBuffer(BufferHandle& buffer) override;
         void DestroyTexture(TextureHandle& texture) override;
@@ -98,17 +216,41 @@ namespace Engine::RHI::Vulkan
         void DestroyPipeline(PipelineHandle& pipeline) override;
         void DestroySwapChain(SwapChainHandle& swapchain) override;
 
+        // Shared quad indices
+        BufferHandle GetQuadIndexBuffer(uint32_t quadCount) override;
+
         // TODO: EnqueueUploadBuffer, EnqueueUploadTexture, and FlushUploads
         // Enqueues uploads into an immediate command buffer.
 
         // Frame pacing
         void BeginFrame() override;
         void EndFrame() override;
+        void WaitForFrameLatency() override;
+        uint32_t GetFramesInFlight() const override { return m_Desc.framesInFlight; }
+
+        // Device info
+        const DeviceCapabilities& GetCapabilities() const override { return m_Context.GetCapabilities(); }
+        bool IsFormatSupported(PixelFormat format, TextureUsageFlags usage) override;
+        const GpuFrameTimings& GetGpuTimings() const override { return m_GpuTimings; }
+        const CommandCounters& GetCommandCounters() const override { return m_CommandCounters; }
+
+        // Memory
+        MemoryStats GetMemoryStats() override;
+        void SetMemoryBudgetCallback(std::function<void(const MemoryStats&)> callback) override;
 
         // Render passes
         // ICommandBuffer* BeginPass(TextureHandle renderTarget, Vec4 clearColor) override;
         ICommandBuffer* BeginPass(SwapChainHandle renderTarget, Vec4 clearColor, TextureHandle depthBuffer = {}) override;
+        ICommandBuffer* BeginPass(const RenderPassDesc& desc) override;
         void EndPass(ICommandBuffer* cmd) override;
+        ICommandBuffer* BeginComputePass(const std::vector<TextureBarrier>& barriers = {}, const std::string& name = "") override;
+
+        // Readback
+        ReadbackTicket RequestReadback(TextureHandle texture, const TextureRegion& region = {}) override;
+        ReadbackTicket RequestReadback(SwapChainHandle swapChain, const TextureRegion& region = {}) override;
+        ReadbackTicket RequestReadback(BufferHandle buffer, const BufferRegion& region = {}) override;
+        bool           PollReadback(ReadbackTicket& ticket, std::vector<char>& data) override;
+        void           CancelReadback(ReadbackTicket& ticket) override;
 
         // Immediate command buffer
         ICommandBuffer* BeginImmediate() override;
@@ -126,11 +268,17 @@ namespace Engine::RHI::Vulkan
         VulkanFrame*   GetCurrentFrame() { return m_Frames[m_FrameIndex].get(); }
         uint32_t       GetFrameIndex()   { return m_FrameIndex; }
 
+        // Frame timeline. The current frame signals GetFrameTimelineValue() + 1 in EndFrame()
+        uint64_t GetFrameTimelineValue() const { return m_FrameTimelineValue; }
+        uint64_t GetCompletedTimelineValue() const { return m_FrameTimeline.getCounterValue(); }
+
         // Resources
         VulkanBufferData&    GetBufferData(BufferHandle buffer);
         VulkanTextureData&   GetTextureData(TextureHandle texture);
+        VulkanHeapData&      GetHeapData(HeapHandle heap);
         VulkanShaderData&    GetShaderData(ShaderHandle shader);
         VulkanPipelineData&  GetPipelineData(PipelineHandle pipeline);
+        VulkanPipelineLayoutData& GetPipelineLayoutData(uint32_t layoutId);
         VulkanSwapChainData& GetSwapChainData(SwapChainHandle swapchain);
     };
 
@@ -1,5 +1,6 @@
 #include "RHI/Vulkan/VulkanCommandBufferAllocator.h"
 #include "RHI/Vulkan/VulkanContext.h"
+#include "RHI/Vulkan/VulkanDescriptorSetAllocator.h"
 #include "RHI/Vulkan/RHI/VulkanCommandBuffer.h"
 
 namespace Engine::RHI::Vulkan
@@ -7,33 +8,57 @@ namespace Engine::RHI::Vulkan
     VulkanCommandBufferAllocator::VulkanCommandBufferAllocator(VulkanContext& context)
         : m_Context(context)
     {
-        // Create command pool
-        vk::CommandPoolCreateInfo poolInfo(
-            vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-            m_Context.GetGraphicsQueue().familyIndex
-        );
-        m_CommandPool = vk::raii::CommandPool(m_Context.GetDevice(), poolInfo);
     }
 
     VulkanCommandBufferAllocator::~VulkanCommandBufferAllocator() = default;
 
+    VulkanCommandBufferAllocator::ThreadPool& VulkanCommandBufferAllocator::GetThreadPool()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Scope<ThreadPool>& threadPool = m_ThreadPools[std::this_thread::get_id()];
+        if (!threadPool)
+        {
+            threadPool = CreateScope<ThreadPool>();
+
+            // Create command pool. Command buffers are reset together with the pool
+            vk::CommandPoolCreateInfo poolInfo(
+                vk::CommandPoolCreateFlagBits::eTransient,
+                m_Context.GetGraphicsQueue().familyIndex
+            );
+            threadPool->commandPool = vk::raii::CommandPool(m_Context.GetDevice(), poolInfo);
+            threadPool->descriptorSetAllocator = CreateScope<VulkanDescriptorSetAllocator>(m_Context);
+        }
+
+        return *threadPool;
+    }
+
     VulkanCommandBuffer* VulkanCommandBufferAllocator::GetOrAllocate(VulkanGraphicsDevice& graphicsDevice)
     {
+        ThreadPool& threadPool = GetThreadPool();
+
         // If we need a new command buffer, create a new one and add it to our list
-        if (m_UsedCommandBuffers >= m_CommandBuffers.size())
+        if (threadPool.usedCommandBuffers >= threadPool.commandBuffers.size())
         {
-            m_CommandBuffers.push_back(
-                CreateScope<VulkanCommandBuffer>(graphicsDevice, *m_CommandPool)
+            threadPool.commandBuffers.push_back(
+                CreateScope<VulkanCommandBuffer>(graphicsDevice, *threadPool.commandPool, *threadPool.descriptorSetAllocator)
             );
         }
 
-        VulkanCommandBuffer* cmd = m_CommandBuffers[m_UsedCommandBuffers++].get();
+        VulkanCommandBuffer* cmd = threadPool.commandBuffers[threadPool.usedCommandBuffers++].get();
         cmd->Reset();
         return cmd;
     }
 
     void VulkanCommandBufferAllocator::Reset()
     {
-        m_UsedCommandBuffers = 0;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (auto& [threadId, threadPool] : m_ThreadPools)
+        {
+            threadPool->commandPool.reset();
+            threadPool->descriptorSetAllocator->Reset();
+            threadPool->usedCommandBuffers = 0;
+        }
     }
 } // namespace Engine
@@ -7,6 +7,9 @@
 
 #include <vector>
 #include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vulkan/vulkan_raii.hpp>
 
 namespace Engine::RHI::Vulkan
@@ -15,21 +18,35 @@ namespace Engine::RHI::Vulkan
     class VulkanContext;
     class VulkanGraphicsDevice;
     class VulkanCommandBuffer;
+    class VulkanDescriptorSetAllocator;
 
+    // Per-frame command buffer allocator. Command pools and descriptor pools can only be used by one thread at a time,
+    // so every thread that records gets its own set, created on first use and reused every time this frame comes around.
     class ENGINE_EXPORT VulkanCommandBufferAllocator
     {
     private:
         VulkanContext& m_Context;
-        vk::raii::CommandPool m_CommandPool = nullptr;
-        std::vector<Scope<VulkanCommandBuffer>> m_CommandBuffers;
-        uint32_t m_UsedCommandBuffers = 0;
+
+        struct ThreadPool {
+            vk::raii::CommandPool                   commandPool = nullptr;
+            std::vector<Scope<VulkanCommandBuffer>> commandBuffers;
+            uint32_t                                usedCommandBuffers = 0;
+            Scope<VulkanDescriptorSetAllocator>     descriptorSetAllocator;
+        };
+
+        std::mutex m_Mutex; // Guards m_ThreadPools. Each ThreadPool is only touched by its own thread
+        std::unordered_map<std::thread::id, Scope<ThreadPool>> m_ThreadPools;
+
+        ThreadPool& GetThreadPool();
 
     public:
         VulkanCommandBufferAllocator(VulkanContext& context);
-        ~VulkanCommandBufferAllocator(); 
+        ~VulkanCommandBufferAllocator();
 
+        // Thread safe
         VulkanCommandBuffer* GetOrAllocate(VulkanGraphicsDevice& graphicsDevice);
 
+        // Resets every thread's pools. Only call once the GPU is done with the frame and no thread is recording
         void Reset();
     };
 } // namespace Engine::RHI::Vulkan
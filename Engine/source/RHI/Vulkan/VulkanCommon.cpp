@@ -1,10 +1,19 @@
 #include "RHI/Vulkan/VulkanCommon.h"
 #include "RHI/Vulkan/VulkanConstants.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #include <emmintrin.h>
+    #define ENGINE_NON_TEMPORAL_COPY
+#endif
+
 namespace Engine::RHI::Vulkan::VulkanCommon
 {
-    void TransitionImageLayout(
-        vk::CommandBuffer        cmd,
+    vk::ImageMemoryBarrier2 GetImageBarrier(
         vk::Image                image,
         vk::ImageLayout          oldLayout,
         vk::ImageLayout          newLayout,
@@ -27,9 +36,25 @@ namespace Engine::RHI::Vulkan::VulkanCommon
         barrier.image               = image;
         barrier.subresourceRange.aspectMask     = aspect;
         barrier.subresourceRange.baseMipLevel   = 0;
-        barrier.subresourceRange.levelCount     = 1;
+        barrier.subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount     = 1;
+        return barrier;
+    }
+
+    void TransitionImageLayout(
+        vk::CommandBuffer        cmd,
+        vk::Image                image,
+        vk::ImageLayout          oldLayout,
+        vk::ImageLayout          newLayout,
+        vk::AccessFlags2         srcAccess,
+        vk::AccessFlags2         dstAccess,
+        vk::PipelineStageFlags2  srcStage,
+        vk::PipelineStageFlags2  dstStage,
+        vk::ImageAspectFlags     aspect
+    )
+    {
+        vk::ImageMemoryBarrier2 barrier = GetImageBarrier(image, oldLayout, newLayout, srcAccess, dstAccess, srcStage, dstStage, aspect);
 
         vk::DependencyInfo dependencyInfo;
         dependencyInfo.imageMemoryBarrierCount = 1;
@@ -47,6 +72,21 @@ namespace Engine::RHI::Vulkan::VulkanCommon
             case PixelFormat::RGBA8:           f = vk::Format::eR8G8B8A8Srgb; break;
             case PixelFormat::Depth32:         f = vk::Format::eD32Sfloat; break;
             case PixelFormat::Depth24Stencil8: f = vk::Format::eD24UnormS8Uint; break;
+            case PixelFormat::RGBA8Unorm:      f = vk::Format::eR8G8B8A8Unorm; break;
+            case PixelFormat::RGBA16F:         f = vk::Format::eR16G16B16A16Sfloat; break;
+            case PixelFormat::RGBA32F:         f = vk::Format::eR32G32B32A32Sfloat; break;
+            case PixelFormat::R32F:            f = vk::Format::eR32Sfloat; break;
+            case PixelFormat::BC1:             f = vk::Format::eBc1RgbaSrgbBlock; break;
+            case PixelFormat::BC1Unorm:        f = vk::Format::eBc1RgbaUnormBlock; break;
+            case PixelFormat::BC3:             f = vk::Format::eBc3SrgbBlock; break;
+            case PixelFormat::BC3Unorm:        f = vk::Format::eBc3UnormBlock; break;
+            case PixelFormat::BC4:             f = vk::Format::eBc4UnormBlock; break;
+            case PixelFormat::BC5:             f = vk::Format::eBc5UnormBlock; break;
+            case PixelFormat::BC7:             f = vk::Format::eBc7SrgbBlock; break;
+            case PixelFormat::BC7Unorm:        f = vk::Format::eBc7UnormBlock; break;
+            case PixelFormat::ETC2RGB8:        f = vk::Format::eEtc2R8G8B8SrgbBlock; break;
+            case PixelFormat::ETC2RGBA8:       f = vk::Format::eEtc2R8G8B8A8SrgbBlock; break;
+            case PixelFormat::ASTC4x4:         f = vk::Format::eAstc4x4SrgbBlock; break;
         }
 
         return f;
@@ -74,14 +114,59 @@ namespace Engine::RHI::Vulkan::VulkanCommon
     {
         size_t size = 0;
 
+        // Depth formats count their depth aspect, which is what copies read and write
         switch(format)
         {
-            case PixelFormat::RGBA8: size = 4; break;
+            case PixelFormat::RGBA8:           size = 4; break;
+            case PixelFormat::RGBA8Unorm:      size = 4; break;
+            case PixelFormat::Depth32:         size = 4; break;
+            case PixelFormat::Depth24Stencil8: size = 4; break;
+            case PixelFormat::RGBA16F:         size = 8; break;
+            case PixelFormat::RGBA32F:         size = 16; break;
+            case PixelFormat::R32F:            size = 4; break;
+            case PixelFormat::BC1:             size = 8; break;
+            case PixelFormat::BC1Unorm:        size = 8; break;
+            case PixelFormat::BC3:             size = 16; break;
+            case PixelFormat::BC3Unorm:        size = 16; break;
+            case PixelFormat::BC4:             size = 8; break;
+            case PixelFormat::BC5:             size = 16; break;
+            case PixelFormat::BC7:             size = 16; break;
+            case PixelFormat::BC7Unorm:        size = 16; break;
+            case PixelFormat::ETC2RGB8:        size = 8; break;
+            case PixelFormat::ETC2RGBA8:       size = 16; break;
+            case PixelFormat::ASTC4x4:         size = 16; break;
         }
 
         return size;
     }
 
+    uint32_t GetBlockExtent(PixelFormat format)
+    {
+        return IsCompressed(format) ? 4 : 1;
+    }
+
+    bool IsCompressed(PixelFormat format)
+    {
+        return format >= PixelFormat::BC1;
+    }
+
+    uint32_t GetMipLevelCount(const TextureDesc& desc)
+    {
+        if (desc.mipLevels != 0)
+            return desc.mipLevels;
+
+        return static_cast<uint32_t>(std::bit_width(std::max(desc.width, desc.height)));
+    }
+
+    size_t GetMipSize(const TextureDesc& desc, uint32_t mipLevel)
+    {
+        // Partial blocks at the edges are stored whole
+        size_t block  = GetBlockExtent(desc.format);
+        size_t width  = (std::max(desc.width >> mipLevel, 1u) + block - 1) / block;
+        size_t height = (std::max(desc.height >> mipLevel, 1u) + block - 1) / block;
+        return width * height * GetPixelSize(desc.format);
+    }
+
     vk::SurfaceFormatKHR ChooseSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats, vk::SurfaceFormatKHR requestedFormat)
     {   
         for (const auto& availableFormat : availableFormats) {
@@ -128,9 +213,9 @@ namespace Engine::RHI::Vulkan::VulkanCommon
         };
     }
 
-    uint32_t GetSurfaceMinImageCount(const vk::SurfaceCapabilitiesKHR& capabilities)
+    uint32_t GetSurfaceMinImageCount(const vk::SurfaceCapabilitiesKHR& capabilities, uint32_t framesInFlight)
     {
-        uint32_t minImageCount = std::max((uint32_t)k_MaxFramesInFlight, capabilities.minImageCount);
+        uint32_t minImageCount = std::max(framesInFlight, capabilities.minImageCount);
         if ((0 < capabilities.maxImageCount) && (capabilities.maxImageCount < minImageCount))
         {
             minImageCount = capabilities.maxImageCount;
@@ -152,6 +237,7 @@ namespace Engine::RHI::Vulkan::VulkanCommon
         {
             case ShaderStage::Vertex: ss = vk::ShaderStageFlagBits::eVertex; break;
             case ShaderStage::Fragment: ss = vk::ShaderStageFlagBits::eFragment; break;
+            case ShaderStage::Compute: ss = vk::ShaderStageFlagBits::eCompute; break;
         }
         return ss;
     }
@@ -164,6 +250,8 @@ namespace Engine::RHI::Vulkan::VulkanCommon
             case PrimitiveTopology::LineList: t = vk::PrimitiveTopology::eLineList; break;
             case PrimitiveTopology::PointList: t = vk::PrimitiveTopology::ePointList; break;
             case PrimitiveTopology::TriangleList: t = vk::PrimitiveTopology::eTriangleList; break;
+            case PrimitiveTopology::LineStrip: t = vk::PrimitiveTopology::eLineStrip; break;
+            case PrimitiveTopology::TriangleStrip: t = vk::PrimitiveTopology::eTriangleStrip; break;
         }
         return t;
     }
@@ -210,6 +298,8 @@ namespace Engine::RHI::Vulkan::VulkanCommon
         {
             case UniformType::UniformBuffer: t = vk::DescriptorType::eUniformBufferDynamic; break;
             case UniformType::Texture: t = vk::DescriptorType::eCombinedImageSampler; break;
+            case UniformType::StorageBuffer: t = vk::DescriptorType::eStorageBuffer; break;
+            case UniformType::StorageTexture: t = vk::DescriptorType::eStorageImage; break;
         }
         return t;
     }
@@ -236,10 +326,113 @@ namespace Engine::RHI::Vulkan::VulkanCommon
             case BufferType::Vertex: flags = vk::BufferUsageFlagBits::eVertexBuffer; break;
             case BufferType::Index: flags = vk::BufferUsageFlagBits::eIndexBuffer; break;
             case BufferType::Uniform: flags = vk::BufferUsageFlagBits::eUniformBuffer; break;
+            case BufferType::Indirect: flags = vk::BufferUsageFlagBits::eIndirectBuffer; break;
+            case BufferType::Storage:
+                flags = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+                        vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer;
+                break;
         }
         return flags;
     }
 
+    vk::IndexType GetIndexType(IndexFormat format)
+    {
+        vk::IndexType t;
+        switch(format)
+        {
+            case IndexFormat::Uint16: t = vk::IndexType::eUint16; break;
+            case IndexFormat::Uint32: t = vk::IndexType::eUint32; break;
+        }
+        return t;
+    }
+
+    vk::ImageLayout GetShaderReadLayout(TextureUsageFlags usage)
+    {
+        // Storage images live in eGeneral so compute can write them without a transition. Sampling eGeneral is valid too
+        return usage.Has(TextureUsage::Storage) ? vk::ImageLayout::eGeneral : vk::ImageLayout::eShaderReadOnlyOptimal;
+    }
+
+    ResourceStateInfo GetResourceStateInfo(ResourceState state, TextureUsageFlags usage)
+    {
+        switch (state)
+        {
+            case ResourceState::Undefined:
+                return { vk::ImageLayout::eUndefined, vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryWrite };
+
+            case ResourceState::RenderTarget:
+                return {
+                    vk::ImageLayout::eColorAttachmentOptimal,
+                    vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                    vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite
+                };
+
+            case ResourceState::DepthWrite:
+                return {
+                    vk::ImageLayout::eDepthStencilAttachmentOptimal,
+                    vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+                    vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+                };
+
+            case ResourceState::DepthRead:
+                return {
+                    vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+                    vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests |
+                    vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+                    vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eShaderSampledRead
+                };
+
+            case ResourceState::ShaderRead:
+                return {
+                    GetShaderReadLayout(usage),
+                    vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eFragmentShader |
+                    vk::PipelineStageFlagBits2::eComputeShader,
+                    vk::AccessFlagBits2::eShaderSampledRead
+                };
+
+            case ResourceState::Storage:
+                return {
+                    vk::ImageLayout::eGeneral,
+                    vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+                    vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+                };
+        }
+
+        return { vk::ImageLayout::eUndefined, vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryWrite };
+    }
+
+    vk::AttachmentLoadOp GetLoadOp(LoadOp op)
+    {
+        switch (op)
+        {
+            case LoadOp::Load:     return vk::AttachmentLoadOp::eLoad;
+            case LoadOp::Clear:    return vk::AttachmentLoadOp::eClear;
+            case LoadOp::DontCare: return vk::AttachmentLoadOp::eDontCare;
+        }
+
+        return vk::AttachmentLoadOp::eClear;
+    }
+
+    vk::ImageAspectFlags GetImageAspect(TextureUsageFlags usage)
+    {
+        return usage.Has(TextureUsage::DepthStencil) ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor;
+    }
+
+    vk::FormatFeatureFlags GetFormatFeatures(TextureUsageFlags usage)
+    {
+        vk::FormatFeatureFlags features = {};
+
+        if (usage.Has(TextureUsage::Sampled))
+            features |= vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eTransferDst;
+        if (usage.Has(TextureUsage::RenderTarget))
+            features |= vk::FormatFeatureFlagBits::eColorAttachment;
+        if (usage.Has(TextureUsage::DepthStencil))
+            features |= vk::FormatFeatureFlagBits::eDepthStencilAttachment;
+        if (usage.Has(TextureUsage::Storage))
+            features |= vk::FormatFeatureFlagBits::eStorageImage;
+
+        return features;
+    }
+
     vk::ImageUsageFlags GetImageUsageFlags(TextureUsageFlags usage)
     {
         vk::ImageUsageFlags flags = {};
@@ -253,8 +446,82 @@ namespace Engine::RHI::Vulkan::VulkanCommon
             flags |= vk::ImageUsageFlagBits::eColorAttachment;
         if (usage.Has(TextureUsage::DepthStencil))
             flags |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
+        if (usage.Has(TextureUsage::Storage))
+            flags |= vk::ImageUsageFlagBits::eStorage;
 
         return flags;
     }
 
-} // namespace Engine::RHI::Vulkan::VulkanCommon
\ No newline at end of file
+    vk::Filter GetFilter(Filter filter)
+    {
+        switch (filter)
+        {
+            case Filter::Nearest: return vk::Filter::eNearest;
+            case Filter::Linear:  return vk::Filter::eLinear;
+        }
+        return vk::Filter::eLinear;
+    }
+
+    vk::SamplerMipmapMode GetMipmapMode(Filter filter)
+    {
+        switch (filter)
+        {
+            case Filter::Nearest: return vk::SamplerMipmapMode::eNearest;
+            case Filter::Linear:  return vk::SamplerMipmapMode::eLinear;
+        }
+        return vk::SamplerMipmapMode::eLinear;
+    }
+
+    vk::SamplerAddressMode GetAddressMode(AddressMode mode)
+    {
+        switch (mode)
+        {
+            case AddressMode::Repeat:         return vk::SamplerAddressMode::eRepeat;
+            case AddressMode::MirroredRepeat: return vk::SamplerAddressMode::eMirroredRepeat;
+            case AddressMode::ClampToEdge:    return vk::SamplerAddressMode::eClampToEdge;
+            case AddressMode::ClampToBorder:  return vk::SamplerAddressMode::eClampToBorder;
+        }
+        return vk::SamplerAddressMode::eRepeat;
+    }
+
+    void CopyToMapped(void* dst, const void* src, size_t size)
+    {
+#ifdef ENGINE_NON_TEMPORAL_COPY
+        if (size >= k_NonTemporalCopyThreshold)
+        {
+            char* d = static_cast<char*>(dst);
+            const char* s = static_cast<const char*>(src);
+
+            // Head up to 16 byte alignment of the destination
+            size_t head = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+            std::memcpy(d, s, head);
+            d += head;
+            s += head;
+            size -= head;
+
+            // Body in 64 byte chunks of streaming stores. The source may be unaligned
+            size_t body = size & ~size_t(63);
+            for (size_t i = 0; i < body; i += 64)
+            {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 16));
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 32));
+                __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 48));
+                _mm_stream_si128(reinterpret_cast<__m128i*>(d + i), a);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(d + i + 16), b);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(d + i + 32), c);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(d + i + 48), e);
+            }
+
+            // Streaming stores are weakly ordered, fence before the memory is submitted
+            _mm_sfence();
+
+            std::memcpy(d + body, s + body, size - body);
+            return;
+        }
+#endif
+
+        std::memcpy(dst, src, size);
+    }
+
+} // namespace Engine::RHI::Vulkan::VulkanCommon
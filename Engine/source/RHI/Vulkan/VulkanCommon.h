@@ -11,6 +11,24 @@
 
 namespace Engine::RHI::Vulkan::VulkanCommon
 {
+    // Layout, stages and accesses of a ResourceState
+    struct ResourceStateInfo {
+        vk::ImageLayout         layout;
+        vk::PipelineStageFlags2 stages;
+        vk::AccessFlags2        access;
+    };
+
+    ENGINE_EXPORT vk::ImageMemoryBarrier2 GetImageBarrier(
+        vk::Image                image,
+        vk::ImageLayout          oldLayout,
+        vk::ImageLayout          newLayout,
+        vk::AccessFlags2         srcAccess,
+        vk::AccessFlags2         dstAccess,
+        vk::PipelineStageFlags2  srcStage,
+        vk::PipelineStageFlags2  dstStage,
+        vk::ImageAspectFlags     aspect
+    );
+
     ENGINE_EXPORT void TransitionImageLayout(
         vk::CommandBuffer        cmd,
         vk::Image                image,
@@ -25,7 +43,13 @@ namespace Engine::RHI::Vulkan::VulkanCommon
 
     ENGINE_EXPORT vk::Format GetPixelFormat(PixelFormat format);
     ENGINE_EXPORT vk::SurfaceFormatKHR GetSurfaceFormat(PixelFormat format);
-    ENGINE_EXPORT size_t GetPixelSize(PixelFormat format);
+    ENGINE_EXPORT size_t GetPixelSize(PixelFormat format); // Bytes per block for compressed formats
+    ENGINE_EXPORT uint32_t GetBlockExtent(PixelFormat format); // Width and height of a block, 1 if uncompressed
+    ENGINE_EXPORT bool IsCompressed(PixelFormat format);
+
+    // Resolves TextureDesc::mipLevels = 0 to the full chain
+    ENGINE_EXPORT uint32_t GetMipLevelCount(const TextureDesc& desc);
+    ENGINE_EXPORT size_t GetMipSize(const TextureDesc& desc, uint32_t mipLevel);
 
     // Returns vk::SurfaceFormatKHR.format = vk::Format::eUndefined if format is not supported
     ENGINE_EXPORT vk::SurfaceFormatKHR ChooseSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats, vk::SurfaceFormatKHR requestedFormat);
@@ -37,7 +61,7 @@ namespace Engine::RHI::Vulkan::VulkanCommon
 
     ENGINE_EXPORT vk::Extent2D GetSurfaceExtent(const vk::SurfaceCapabilitiesKHR& capabilities, uint32_t width, uint32_t height);
 
-    ENGINE_EXPORT uint32_t GetSurfaceMinImageCount(const vk::SurfaceCapabilitiesKHR& capabilities);
+    ENGINE_EXPORT uint32_t GetSurfaceMinImageCount(const vk::SurfaceCapabilitiesKHR& capabilities, uint32_t framesInFlight);
 
     ENGINE_EXPORT [[nodiscard]] vk::raii::ShaderModule CreateShaderModule(vk::raii::Device& device, const std::vector<uint32_t>& code);
 
@@ -52,7 +76,25 @@ namespace Engine::RHI::Vulkan::VulkanCommon
     ENGINE_EXPORT vk::DescriptorType GetUniformDescriptorType(UniformType type);
 
     ENGINE_EXPORT vk::BufferUsageFlags GetBufferUsageFlags(BufferType type);
+    ENGINE_EXPORT vk::IndexType GetIndexType(IndexFormat format);
     ENGINE_EXPORT vk::ImageUsageFlags GetImageUsageFlags(TextureUsageFlags usage);
+    ENGINE_EXPORT vk::FormatFeatureFlags GetFormatFeatures(TextureUsageFlags usage);
+
+    // Layout a texture rests in while it is read by shaders
+    ENGINE_EXPORT vk::ImageLayout GetShaderReadLayout(TextureUsageFlags usage);
+
+    ENGINE_EXPORT vk::Filter GetFilter(Filter filter);
+    ENGINE_EXPORT vk::SamplerMipmapMode GetMipmapMode(Filter filter);
+    ENGINE_EXPORT vk::SamplerAddressMode GetAddressMode(AddressMode mode);
+
+    // Undefined as a source waits for all earlier work, so it is also safe for memory aliased with another texture
+    ENGINE_EXPORT ResourceStateInfo GetResourceStateInfo(ResourceState state, TextureUsageFlags usage);
+    ENGINE_EXPORT vk::AttachmentLoadOp GetLoadOp(LoadOp op);
+    ENGINE_EXPORT vk::ImageAspectFlags GetImageAspect(TextureUsageFlags usage);
+
+    // Copies into mapped, write-combined memory. Copies of at least k_NonTemporalCopyThreshold bytes use streaming
+    // stores that bypass the cache instead of evicting it.
+    ENGINE_EXPORT void CopyToMapped(void* dst, const void* src, size_t size);
 
 } // namespace Engine::RHI::Vulkan::VulkanCommon
 
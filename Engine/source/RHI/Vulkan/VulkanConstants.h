@@ -20,26 +20,53 @@ constexpr const std::array<const char*, 0 + k_EnableValidationLayers> k_Instance
 #endif
 };
 
-constexpr const std::array<const char*, 4> k_DeviceExtensions = {
-    vk::KHRSwapchainExtensionName,
+constexpr const std::array<const char*, 3> k_DeviceExtensions = {
     vk::KHRSpirv14ExtensionName,
     vk::KHRSynchronization2ExtensionName,
     vk::KHRDynamicRenderingExtensionName
 };
 
-// TODO: Vulkan: Move these into a GraphicsDeviceDesc
+// Only required when presenting, headless devices go without
+constexpr const std::array<const char*, 1> k_PresentDeviceExtensions = {
+    vk::KHRSwapchainExtensionName
+};
+
+// Upper bound for GraphicsDeviceDesc::framesInFlight. Used to size per-frame arrays.
+constexpr const uint32_t k_MaxFramesInFlight = 4;
+
+// Dynamic buffers grow a page at a time and shrink to the most pages used over k_DynamicBufferShrinkFrames frames
+constexpr const uint32_t k_VertexDynamicBufferPageSize = 1 * 1024 * 1024; // 1 MiB
+constexpr const uint32_t k_IndexDynamicBufferPageSize = 1 * 1024 * 1024; // 1 MiB
+constexpr const uint32_t k_UniformDynamicBufferPageSize = 1 * 1024 * 1024; // 1 MiB
+constexpr const uint32_t k_IndirectDynamicBufferPageSize = 256 * 1024; // 256 KiB
+constexpr const uint32_t k_DynamicBufferShrinkFrames = 300;
 
-constexpr const uint32_t k_MaxFramesInFlight = 3;
+// Uploads at least this large are copied with streaming stores (see VulkanCommon::CopyToMapped)
+constexpr const size_t k_NonTemporalCopyThreshold = 64 * 1024; // 64 KiB
 
-constexpr const uint32_t k_VertexDynamicBufferSizePerFrame = 1 * 1024 * 1024; // 1 MiB
-constexpr const uint32_t k_IndexDynamicBufferSizePerFrame = 1 * 1024 * 1024; // 1 MiB
-constexpr const uint32_t k_UniformDynamicBufferSizePerFrame = 1 * 1024 * 1024; // 1 MiB
+// Smallest shared quad index buffer, 24 KiB of 32-bit indices
+constexpr const uint32_t k_MinQuadIndexCapacity = 1024;
+// Largest one, 192 MiB of indices. A power of two so growing never rounds past it
+constexpr const uint32_t k_MaxQuadIndexCapacity = 1 << 23;
+static_assert(static_cast<uint64_t>(k_MaxQuadIndexCapacity) * 4 <= UINT32_MAX, "Quad vertices must fit in 32-bit indices");
 
 
+// Readback buffers are at least this large. Freed ones beyond k_MaxRetainedReadbackPages are destroyed
+constexpr const size_t k_ReadbackPageSize = 256 * 1024; // 256 KiB
+constexpr const uint32_t k_MaxRetainedReadbackPages = 8;
+
+// GPU timings. Two timestamps per pass and marker, one statistics query per pass. Scopes beyond these aren't timed
+constexpr const uint32_t k_MaxTimestampQueriesPerFrame = 1024;
+constexpr const uint32_t k_MaxStatisticsQueriesPerFrame = 128;
+
 static constexpr uint32_t k_MaxBindings = 8;
-constexpr const uint32_t k_MaxDescriptorSetsPerFrame = 64;
-constexpr const uint32_t k_MaxUniformBuffersPerFrame = 64;
-constexpr const uint32_t k_MaxSamplersPerFrame = 64;
+
+// Descriptor pools are chained, these only size each link
+constexpr const uint32_t k_MaxDescriptorSetsPerPool = 256;
+constexpr const uint32_t k_MaxUniformBuffersPerPool = 256;
+constexpr const uint32_t k_MaxSamplersPerPool = 256;
+constexpr const uint32_t k_MaxStorageBuffersPerPool = 64;
+constexpr const uint32_t k_MaxStorageImagesPerPool = 64;
 
 
 #endif // RHI_VULKAN_VULKANCONSTANTS
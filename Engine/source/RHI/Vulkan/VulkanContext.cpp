@@ -8,6 +8,10 @@
 #include "Engine/Core/Assert.h"
 #include "Engine/Core/Log.h"
 
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
 
 // Debug callback
@@ -38,7 +42,9 @@ static VKAPI_ATTR vk::Bool32 VKAPI_CALL DebugCallback(
 
 namespace Engine::RHI::Vulkan
 {
-    VulkanContext::VulkanContext(IVulkanGraphicsBridge* bridge)
+    VulkanContext::VulkanContext(IVulkanGraphicsBridge* bridge, const std::string& pipelineCachePath)
+        : m_Headless(bridge == nullptr),
+          m_PipelineCachePath(pipelineCachePath)
     {
         VULKAN_HPP_DEFAULT_DISPATCHER.init();
         CreateInstance(bridge);
@@ -48,6 +54,7 @@ namespace Engine::RHI::Vulkan
         CreateLogicalDevice(bridge);
         VULKAN_HPP_DEFAULT_DISPATCHER.init(*m_Device);
         CreateAllocator();
+        CreatePipelineCache();
     }
 
     VulkanContext::~VulkanContext()
@@ -65,8 +72,7 @@ namespace Engine::RHI::Vulkan
 
     void VulkanContext::CreateInstance(IVulkanGraphicsBridge* bridge)
     {
-        ENGINE_CORE_ASSERT(bridge != nullptr, "Vulkan: VulkanContext(): bridge is nullptr!");
-        LOG_CORE_INFO("Vulkan: Creating instance...");
+        LOG_CORE_INFO(m_Headless ? "Vulkan: Creating headless instance..." : "Vulkan: Creating instance...");
 
         // Create instance
         // TODO: Vulkan: Get application info from here
@@ -78,8 +84,10 @@ namespace Engine::RHI::Vulkan
             vk::ApiVersion12
         );
 
-        // Get instance extensions and make sure they're all supported
-        auto instanceExtensions = bridge->GetInstanceExtensions();
+        // Get instance extensions and make sure they're all supported. Headless instances need no surface extensions
+        std::vector<const char*> instanceExtensions;
+        if (!m_Headless)
+            instanceExtensions = bridge->GetInstanceExtensions();
         // Add engine instance extensions
         instanceExtensions.insert(instanceExtensions.end(), k_InstanceExtensions.begin(), k_InstanceExtensions.end());
         auto extensionProperties = m_Context.enumerateInstanceExtensionProperties();
@@ -180,10 +188,12 @@ namespace Engine::RHI::Vulkan
         // Make sure physical device meets all of our requirements:
         //      Vulkan 1.2
         //      Graphics queue
-        //      k_DeviceExtensions
+        //      k_DeviceExtensions (and k_PresentDeviceExtensions unless headless)
 
         std::vector<const char*> requiredDeviceExtensions;
         requiredDeviceExtensions.insert(requiredDeviceExtensions.end(), k_DeviceExtensions.begin(), k_DeviceExtensions.end());
+        if (!m_Headless)
+            requiredDeviceExtensions.insert(requiredDeviceExtensions.end(), k_PresentDeviceExtensions.begin(), k_PresentDeviceExtensions.end());
         
         for(auto const& physicalDevice : physicalDevices)
         {
@@ -237,7 +247,7 @@ namespace Engine::RHI::Vulkan
                 continue;
             }
 
-            LOG_CORE_INFO("Vulkan: Selected: {0}", props.deviceName.data());
+            LOG_CORE_INFO("Vulkan: Selected: {0} ({1})", props.deviceName.data(), vk::to_string(props.deviceType));
             m_PhysicalDevice = physicalDevice;
             m_PhysicalDeviceProperties = props;
             break;
@@ -252,62 +262,124 @@ namespace Engine::RHI::Vulkan
     void VulkanContext::CreateLogicalDevice(IVulkanGraphicsBridge* bridge)
     {
         LOG_CORE_INFO("Vulkan: Creating logical device...");
-        // TODO: Vulkan: Pick separate graphics and presentation queues
         // TODO: Vulkan: Make feature selection less trash
 
-        // Create dummy surface
-        vk::SurfaceKHR* surf = bridge->CreateDummySurface(*m_Instance);
-        if (surf == nullptr)
+        // Create dummy surface. Headless devices don't present, so any graphics queue will do
+        vk::SurfaceKHR* surf = nullptr;
+        if (!m_Headless)
         {
-            throw std::runtime_error("Vulkan: Dummy surface is invalid!");
+            surf = bridge->CreateDummySurface(*m_Instance);
+            if (surf == nullptr)
+            {
+                throw std::runtime_error("Vulkan: Dummy surface is invalid!");
+            }
         }
 
-        // Get graphics queue
+        // Get graphics and present queues. A family that does both is preferred, so nothing has to be shared
         std::vector<vk::QueueFamilyProperties> queueFamilyProperties = m_PhysicalDevice.getQueueFamilyProperties();
         uint32_t queueIndex = ~0;
+        uint32_t presentQueueIndex = ~0;
         for (uint32_t qfpIndex = 0; qfpIndex < queueFamilyProperties.size(); qfpIndex++)
         {
-        if (
-            (queueFamilyProperties[qfpIndex].queueFlags & vk::QueueFlagBits::eGraphics) &&
-            m_PhysicalDevice.getSurfaceSupportKHR(qfpIndex, *surf))
-        {
-            // found a queue family that supports both graphics and present
-            queueIndex = qfpIndex;
-            break;
-        }
+            bool graphics = !!(queueFamilyProperties[qfpIndex].queueFlags & vk::QueueFlagBits::eGraphics);
+            bool present  = m_Headless || m_PhysicalDevice.getSurfaceSupportKHR(qfpIndex, *surf);
+
+            if (graphics && present)
+            {
+                queueIndex        = qfpIndex;
+                presentQueueIndex = qfpIndex;
+                break;
+            }
+
+            if (graphics && queueIndex == ~0)
+                queueIndex = qfpIndex;
+            if (present && presentQueueIndex == ~0)
+                presentQueueIndex = qfpIndex;
         }
         if (queueIndex == ~0)
         {
-            throw std::runtime_error("Vulkan: Could not find a queue for both graphics and presentation!");
+            throw std::runtime_error("Vulkan: Could not find a graphics queue!");
+        }
+        if (presentQueueIndex == ~0)
+        {
+            throw std::runtime_error("Vulkan: Could not find a queue for presentation!");
         }
 
-        bridge->DestroyDummySurface(*m_Instance);
+        if (!m_Headless)
+            bridge->DestroyDummySurface(*m_Instance);
 
         // Device queues
         float queuePriority = 0.5f;
-        vk::DeviceQueueCreateInfo deviceQueueCreateInfo(
-            {},
-            queueIndex,
-            1, &queuePriority
-        );
+        std::vector<vk::DeviceQueueCreateInfo> deviceQueueCreateInfos = {
+            vk::DeviceQueueCreateInfo({}, queueIndex, 1, &queuePriority)
+        };
+        if (presentQueueIndex != queueIndex)
+        {
+            LOG_CORE_INFO("Vulkan: Presenting from queue family {0}, rendering on {1}", presentQueueIndex, queueIndex);
+            deviceQueueCreateInfos.emplace_back(vk::DeviceQueueCreateFlags{}, presentQueueIndex, 1, &queuePriority);
+        }
 
         // Get features
-        vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan11Features, vk::PhysicalDeviceSynchronization2Features, vk::PhysicalDeviceDynamicRenderingFeatures, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain;
+        vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan11Features, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceSynchronization2Features, vk::PhysicalDeviceDynamicRenderingFeatures, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain;
         featureChain.get<vk::PhysicalDeviceDynamicRenderingFeatures>().dynamicRendering = vk::True;
         featureChain.get<vk::PhysicalDeviceVulkan11Features>().shaderDrawParameters = vk::True;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore = vk::True;
         featureChain.get<vk::PhysicalDeviceSynchronization2Features>().synchronization2 = vk::True;
         featureChain.get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState = vk::True;
 
+        // Optional features
+        auto supported = m_PhysicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        m_Capabilities.multiDrawIndirect = supported.get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect;
+        m_Capabilities.drawIndirectCount = supported.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount;
+
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect = m_Capabilities.multiDrawIndirect;
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.drawIndirectFirstInstance = supported.get<vk::PhysicalDeviceFeatures2>().features.drawIndirectFirstInstance;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount = m_Capabilities.drawIndirectCount;
+
+        // GPU timings. Query pools are reset from the host once a frame's results are read
+        m_TimestampValidBits = queueFamilyProperties[queueIndex].timestampValidBits;
+        m_Capabilities.timestampQueries = m_TimestampValidBits != 0 && supported.get<vk::PhysicalDeviceVulkan12Features>().hostQueryReset;
+        // A pass's statistics query stays active while it executes bundles, which needs inheritedQueries
+        m_Capabilities.pipelineStatisticsQueries = m_Capabilities.timestampQueries &&
+            supported.get<vk::PhysicalDeviceFeatures2>().features.pipelineStatisticsQuery &&
+            supported.get<vk::PhysicalDeviceFeatures2>().features.inheritedQueries;
+
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().hostQueryReset = m_Capabilities.timestampQueries;
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.pipelineStatisticsQuery = m_Capabilities.pipelineStatisticsQueries;
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.inheritedQueries        = m_Capabilities.pipelineStatisticsQueries;
+
+        m_Capabilities.samplerAnisotropy = supported.get<vk::PhysicalDeviceFeatures2>().features.samplerAnisotropy;
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.samplerAnisotropy = m_Capabilities.samplerAnisotropy;
+
+        // Compressed texture formats
+        m_Capabilities.textureCompressionBC   = supported.get<vk::PhysicalDeviceFeatures2>().features.textureCompressionBC;
+        m_Capabilities.textureCompressionETC2 = supported.get<vk::PhysicalDeviceFeatures2>().features.textureCompressionETC2;
+        m_Capabilities.textureCompressionASTC = supported.get<vk::PhysicalDeviceFeatures2>().features.textureCompressionASTC_LDR;
+
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.textureCompressionBC       = m_Capabilities.textureCompressionBC;
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.textureCompressionETC2     = m_Capabilities.textureCompressionETC2;
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.textureCompressionASTC_LDR = m_Capabilities.textureCompressionASTC;
+
         // Device extensions
         std::vector<char const*> requiredDeviceExtensions;
         requiredDeviceExtensions.assign(k_DeviceExtensions.begin(), k_DeviceExtensions.end());
+        if (!m_Headless)
+            requiredDeviceExtensions.insert(requiredDeviceExtensions.end(), k_PresentDeviceExtensions.begin(), k_PresentDeviceExtensions.end());
+
+        // Memory budget. Without it VMA estimates budgets from heap sizes
+        auto availableExtensions = m_PhysicalDevice.enumerateDeviceExtensionProperties();
+        m_Capabilities.memoryBudget = std::ranges::any_of(availableExtensions, [](auto const& extension) {
+            return strcmp(extension.extensionName, vk::EXTMemoryBudgetExtensionName) == 0;
+        });
+        if (m_Capabilities.memoryBudget)
+            requiredDeviceExtensions.push_back(vk::EXTMemoryBudgetExtensionName);
 
         // Create device
         vk::DeviceCreateInfo deviceCreateInfo(
             {},
-            1, &deviceQueueCreateInfo,
+            static_cast<uint32_t>(deviceQueueCreateInfos.size()), deviceQueueCreateInfos.data(),
             0, nullptr,
-            k_DeviceExtensions.size(), k_DeviceExtensions.data()
+            static_cast<uint32_t>(requiredDeviceExtensions.size()), requiredDeviceExtensions.data()
         );
 
         deviceCreateInfo.pNext = &featureChain.get<vk::PhysicalDeviceFeatures2>();
@@ -316,6 +388,8 @@ namespace Engine::RHI::Vulkan
 
         m_GraphicsQueue.familyIndex = queueIndex;
         m_GraphicsQueue.queue = vk::raii::Queue(m_Device, queueIndex, 0);
+        m_PresentQueue.familyIndex = presentQueueIndex;
+        m_PresentQueue.queue = vk::raii::Queue(m_Device, presentQueueIndex, 0);
     }
 
     void VulkanContext::CreateAllocator()
@@ -327,7 +401,7 @@ namespace Engine::RHI::Vulkan
         vulkanFunctions.vkGetDeviceProcAddr = &vkGetDeviceProcAddr;
 
         VmaAllocatorCreateInfo allocatorCreateInfo = {};
-        allocatorCreateInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        allocatorCreateInfo.flags = m_Capabilities.memoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0;
         allocatorCreateInfo.vulkanApiVersion = VK_API_VERSION_1_2;
         allocatorCreateInfo.physicalDevice = *m_PhysicalDevice;
         allocatorCreateInfo.device = *m_Device;
@@ -336,4 +410,146 @@ namespace Engine::RHI::Vulkan
         
         vmaCreateAllocator(&allocatorCreateInfo, &m_Allocator);
     }
+
+    void VulkanContext::TrackAllocation(VulkanMemoryCategory category, VmaAllocation allocation)
+    {
+        VmaAllocationInfo info;
+        vmaGetAllocationInfo(m_Allocator, allocation, &info);
+        m_AllocatedBytes[static_cast<size_t>(category)].fetch_add(info.size, std::memory_order_relaxed);
+    }
+
+    void VulkanContext::UntrackAllocation(VulkanMemoryCategory category, VmaAllocation allocation)
+    {
+        VmaAllocationInfo info;
+        vmaGetAllocationInfo(m_Allocator, allocation, &info);
+        m_AllocatedBytes[static_cast<size_t>(category)].fetch_sub(info.size, std::memory_order_relaxed);
+    }
+
+    size_t VulkanContext::GetAllocatedBytes(VulkanMemoryCategory category) const
+    {
+        return m_AllocatedBytes[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    static constexpr uint32_t k_PipelineCacheMagic   = 0x43504252; // "RBPC"
+    static constexpr uint32_t k_PipelineCacheVersion = 1;
+
+    void VulkanContext::CreatePipelineCache()
+    {
+        LOG_CORE_INFO("Vulkan: Creating pipeline cache...");
+
+        // Try to read existing cache from disk
+        std::vector<char> cacheData;
+        if(!m_PipelineCachePath.empty())
+        {
+            std::ifstream file(m_PipelineCachePath, std::ios::binary);
+            PipelineCacheFileHeader header{};
+            if(file.is_open() && file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            {
+                // Validate against this device and driver
+                bool valid =
+                    header.magic         == k_PipelineCacheMagic &&
+                    header.version       == k_PipelineCacheVersion &&
+                    header.vendorID      == m_PhysicalDeviceProperties.vendorID &&
+                    header.deviceID      == m_PhysicalDeviceProperties.deviceID &&
+                    header.driverVersion == m_PhysicalDeviceProperties.driverVersion &&
+                    std::memcmp(header.pipelineCacheUUID, m_PhysicalDeviceProperties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+
+                // The payload must fill the rest of the file exactly, never trust dataSize on its own
+                std::error_code ec;
+                const uintmax_t fileSize = std::filesystem::file_size(m_PipelineCachePath, ec);
+                const bool sizeMatches = !ec && fileSize >= sizeof(header) && header.dataSize == fileSize - sizeof(header);
+
+                if(valid && !sizeMatches)
+                {
+                    LOG_CORE_WARN("Vulkan: Pipeline cache size does not match its header, ignoring: {0}", m_PipelineCachePath);
+                }
+                else if(valid)
+                {
+                    cacheData.resize(static_cast<size_t>(header.dataSize));
+                    if(!file.read(cacheData.data(), cacheData.size()))
+                    {
+                        LOG_CORE_WARN("Vulkan: Pipeline cache is truncated, ignoring: {0}", m_PipelineCachePath);
+                        cacheData.clear();
+                    }
+                }
+                else
+                {
+                    LOG_CORE_INFO("Vulkan: Pipeline cache was created by a different device or driver, ignoring.");
+                }
+            }
+        }
+
+        vk::PipelineCacheCreateInfo cacheInfo;
+        cacheInfo.initialDataSize = cacheData.size();
+        cacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+        try
+        {
+            m_PipelineCache = vk::raii::PipelineCache(m_Device, cacheInfo);
+        }
+        catch(const vk::SystemError& e)
+        {
+            // Driver rejected the data; start with an empty cache
+            LOG_CORE_WARN("Vulkan: Could not seed pipeline cache ({0}), starting empty.", e.what());
+            cacheInfo.initialDataSize = 0;
+            cacheInfo.pInitialData = nullptr;
+            m_PipelineCache = vk::raii::PipelineCache(m_Device, cacheInfo);
+        }
+
+        if(!cacheData.empty())
+        {
+            LOG_CORE_INFO("Vulkan: Loaded {0} bytes of pipeline cache.", cacheData.size());
+        }
+    }
+
+    void VulkanContext::SavePipelineCache()
+    {
+        if(m_PipelineCachePath.empty() || m_PipelineCache == nullptr)
+            return;
+
+        std::vector<uint8_t> data = m_PipelineCache.getData();
+
+        PipelineCacheFileHeader header{};
+        header.magic         = k_PipelineCacheMagic;
+        header.version       = k_PipelineCacheVersion;
+        header.vendorID      = m_PhysicalDeviceProperties.vendorID;
+        header.deviceID      = m_PhysicalDeviceProperties.deviceID;
+        header.driverVersion = m_PhysicalDeviceProperties.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, m_PhysicalDeviceProperties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+        header.dataSize      = data.size();
+
+        // Write to a temporary file and rename so a crash mid-write can't leave a corrupt cache behind
+        std::string tempPath = m_PipelineCachePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if(!file.is_open())
+            {
+                LOG_CORE_WARN("Vulkan: Could not write pipeline cache: {0}", tempPath);
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+            file.flush();
+            file.close();
+
+            // Keep the old cache if the new one didn't fully reach the disk
+            if(!file.good())
+            {
+                LOG_CORE_WARN("Vulkan: Could not write pipeline cache: {0}", tempPath);
+                std::error_code removeError;
+                std::filesystem::remove(tempPath, removeError);
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, m_PipelineCachePath, ec);
+        if(ec)
+        {
+            LOG_CORE_WARN("Vulkan: Could not write pipeline cache: {0}", ec.message());
+            return;
+        }
+
+        LOG_CORE_INFO("Vulkan: Saved {0} bytes of pipeline cache.", data.size());
+    }
 } // namespace Engine
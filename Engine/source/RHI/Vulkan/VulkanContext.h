@@ -5,6 +5,12 @@
 
 #include "RHI/Vulkan/VulkanQueue.h"
 
+#include "Engine/RHI/RHI.h"
+
+#include <array>
+#include <atomic>
+#include <string>
+
 #include <vulkan/vulkan_raii.hpp>
 #include <vk_mem_alloc.h>
 
@@ -13,35 +19,74 @@ namespace Engine::RHI::Vulkan
     // Forward
     class IVulkanGraphicsBridge;
 
+    // Resource categories reported in MemoryStats
+    enum class VulkanMemoryCategory : uint8_t { Buffer, Texture, Dynamic, Staging, Count };
+
     class ENGINE_EXPORT VulkanContext
     {
     private:
         vk::raii::Context m_Context;
+        bool m_Headless; // Created without a bridge: no surfaces, no swapchain extension
         vk::raii::Instance m_Instance = nullptr;
         vk::raii::DebugUtilsMessengerEXT m_DebugMessenger = nullptr;
         vk::raii::PhysicalDevice m_PhysicalDevice = nullptr;
         vk::PhysicalDeviceProperties m_PhysicalDeviceProperties;
+        DeviceCapabilities m_Capabilities; // Optional features that were found and enabled
+        uint32_t m_TimestampValidBits = 0; // Of the graphics queue
         vk::raii::Device m_Device = nullptr;
         VmaAllocator m_Allocator;
-        // TODO: Vulkan: Separate graphics and presentation queues
+        std::array<std::atomic<size_t>, static_cast<size_t>(VulkanMemoryCategory::Count)> m_AllocatedBytes = {};
         VulkanQueue m_GraphicsQueue;
+        VulkanQueue m_PresentQueue; // The graphics queue unless presenting needs another family. Unused when headless
+
+        // Pipeline cache, persisted to m_PipelineCachePath
+        vk::raii::PipelineCache m_PipelineCache = nullptr;
+        std::string m_PipelineCachePath;
+
+        // Header written in front of the driver's cache data. Cache data is only valid for the exact
+        // device and driver that produced it, so all of these must match before the data is used.
+        struct PipelineCacheFileHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint32_t driverVersion;
+            uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+            uint64_t dataSize;
+        };
 
         void CreateInstance(IVulkanGraphicsBridge* bridge);
         void SetupDebugMessenger();
         void PickPhysicalDevice();
         void CreateLogicalDevice(IVulkanGraphicsBridge* bridge);
         void CreateAllocator();
+        void CreatePipelineCache();
 
     public:
-        VulkanContext(IVulkanGraphicsBridge* bridge);
+        // A null bridge creates a headless context
+        VulkanContext(IVulkanGraphicsBridge* bridge, const std::string& pipelineCachePath = "");
         ~VulkanContext();
 
+        // Writes pipeline cache to m_PipelineCachePath
+        void SavePipelineCache();
+
+        // Thread safe. Untrack before the allocation is freed
+        void TrackAllocation(VulkanMemoryCategory category, VmaAllocation allocation);
+        void UntrackAllocation(VulkanMemoryCategory category, VmaAllocation allocation);
+        size_t GetAllocatedBytes(VulkanMemoryCategory category) const;
+
+        bool                          IsHeadless() const { return m_Headless; }
         vk::raii::Instance&           GetInstance() { return m_Instance; }
         vk::raii::PhysicalDevice&     GetPhysicalDevice() { return m_PhysicalDevice; }
         vk::PhysicalDeviceProperties& GetPhysicalDeviceProperties() { return m_PhysicalDeviceProperties; }
+        const DeviceCapabilities&     GetCapabilities() const { return m_Capabilities; }
+        uint32_t                      GetTimestampValidBits() const { return m_TimestampValidBits; }
         vk::raii::Device&             GetDevice() { return m_Device; }
         VmaAllocator&                 GetAllocator() { return m_Allocator; }
         VulkanQueue&                  GetGraphicsQueue() { return m_GraphicsQueue; }
+        VulkanQueue&                  GetPresentQueue() { return m_PresentQueue; }
+        bool                          HasSeparatePresentQueue() const { return m_PresentQueue.familyIndex != m_GraphicsQueue.familyIndex; }
+        vk::raii::PipelineCache&      GetPipelineCache() { return m_PipelineCache; }
     };
 } // namespace Engine::RHI::Vulkan
 
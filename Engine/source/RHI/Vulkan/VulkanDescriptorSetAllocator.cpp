@@ -1,125 +1,96 @@
 #include "RHI/Vulkan/VulkanDescriptorSetAllocator.h"
 #include "RHI/Vulkan/VulkanContext.h"
 #include "RHI/Vulkan/VulkanConstants.h"
+#include "Engine/Core/Base.h"
+
+#include <stdexcept>
 
 namespace Engine::RHI::Vulkan
 {
+    size_t VulkanDescriptorSetKeyHash::operator()(const VulkanDescriptorSetKey& key) const noexcept
+    {
+        size_t seed = 0;
+        HashCombine(seed, key.layoutId);
+        for (uint32_t resource : key.resources)
+            HashCombine(seed, resource);
+        for (uint32_t page : key.pages)
+            HashCombine(seed, page);
+        return seed;
+    }
+
     VulkanDescriptorSetAllocator::VulkanDescriptorSetAllocator(VulkanContext& context)
         : m_Context(context)
+    {
+        CreatePool();
+    }
+
+    void VulkanDescriptorSetAllocator::CreatePool()
     {
         // Descriptor pool
         std::vector<vk::DescriptorPoolSize> poolSizes = {
-            { vk::DescriptorType::eUniformBufferDynamic, k_MaxUniformBuffersPerFrame },
-            { vk::DescriptorType::eCombinedImageSampler, k_MaxSamplersPerFrame },
+            { vk::DescriptorType::eUniformBufferDynamic, k_MaxUniformBuffersPerPool },
+            { vk::DescriptorType::eCombinedImageSampler, k_MaxSamplersPerPool },
+            { vk::DescriptorType::eStorageBuffer,        k_MaxStorageBuffersPerPool },
+            { vk::DescriptorType::eStorageImage,         k_MaxStorageImagesPerPool },
         };
 
         vk::DescriptorPoolCreateInfo poolInfo;
-        poolInfo.flags = {vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet};
-        poolInfo.maxSets = k_MaxDescriptorSetsPerFrame;
+        poolInfo.maxSets = k_MaxDescriptorSetsPerPool;
         poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
         poolInfo.pPoolSizes = poolSizes.data();
 
-        m_DescriptorPool = vk::raii::DescriptorPool(m_Context.GetDevice(), poolInfo);
+        m_Pools.emplace_back(m_Context.GetDevice(), poolInfo);
     }
 
-    
-    vk::DescriptorSet VulkanDescriptorSetAllocator::GetOrAllocate(uint32_t pipelineId, vk::DescriptorSetLayout layout)
+    vk::DescriptorSet VulkanDescriptorSetAllocator::Allocate(vk::DescriptorSetLayout layout)
     {
-        // Check cache
-        auto it = m_Sets.find(pipelineId);
-        if (it != m_Sets.end())
-            return *it->second.set;
-
-        // Allocate new set
         vk::DescriptorSetAllocateInfo allocInfo;
-        allocInfo.descriptorPool = *m_DescriptorPool;
         allocInfo.descriptorSetCount = 1;
         allocInfo.pSetLayouts = &layout;
 
-        DescriptorSetEntry& entry = m_Sets[pipelineId];
-        entry.set = std::move(m_Context.GetDevice().allocateDescriptorSets(allocInfo).front());
-        entry.boundBuffers.fill(0); // invalid / no buffer
-
-        return *entry.set;
-    }
-
-    void VulkanDescriptorSetAllocator::SetDynamicOffset(uint32_t pipelineId, uint32_t binding, uint32_t offset)
-    {
-        // Get entry
-        auto it = m_Sets.find(pipelineId);
-        if (it == m_Sets.end()) return;
-        DescriptorSetEntry& entry = it->second;
-        if (binding >= entry.pendingOffsets.size())
-            entry.pendingOffsets.resize(binding + 1, 0);
-
-        if(entry.pendingOffsets[binding] != offset)
+        while (true)
         {
-            entry.pendingOffsets[binding] = offset;
-            entry.dirty = true;
-        }
-    }
+            allocInfo.descriptorPool = *m_Pools[m_CurrentPool];
 
-    void VulkanDescriptorSetAllocator::MarkDirty(uint32_t pipelineId)
-    {
-        auto it = m_Sets.find(pipelineId);
-        if (it != m_Sets.end())
-            it->second.dirty = true;
-    }
-
-    bool VulkanDescriptorSetAllocator::NeedsWriteBuffer(uint32_t pipelineId, uint32_t binding, uint32_t bufferId) const
-    {
-        // Check cache: If not allocated, needs write
-        auto it = m_Sets.find(pipelineId);
-        if (it == m_Sets.end())
-            return true;
-
-        // Else, check if this binding is this buffer
-        return it->second.boundBuffers[binding] != bufferId;
-    }
+            vk::DescriptorSet set;
+            vk::Result result = (*m_Context.GetDevice()).allocateDescriptorSets(&allocInfo, &set);
+            if (result == vk::Result::eSuccess)
+                return set;
 
-    bool VulkanDescriptorSetAllocator::NeedsWriteTexture(uint32_t pipelineId, uint32_t binding, uint32_t textureId) const
-    {
-        // Check cache: If not allocated, needs write
-        auto it = m_Sets.find(pipelineId);
-        if (it == m_Sets.end())
-            return true;
+            if (result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool)
+                throw std::runtime_error("Vulkan: VulkanDescriptorSetAllocator: Failed to allocate descriptor set!");
 
-        // Else, check if this binding is this texture
-        return it->second.boundTextures[binding] != textureId;
+            // Current pool is full, chain the next one
+            if (++m_CurrentPool == m_Pools.size())
+                CreatePool();
+        }
     }
 
-    void VulkanDescriptorSetAllocator::MarkWrittenBuffer(uint32_t pipelineId, uint32_t binding, uint32_t bufferId)
+    vk::DescriptorSet VulkanDescriptorSetAllocator::GetOrAllocate(
+        const VulkanDescriptorSetKey& key,
+        vk::DescriptorSetLayout layout,
+        vk::DescriptorUpdateTemplate updateTemplate,
+        const std::array<VulkanDescriptorWrite, k_MaxBindings>& writes)
     {
-        auto it = m_Sets.find(pipelineId);
+        // Check cache
+        auto it = m_Sets.find(key);
         if (it != m_Sets.end())
-            it->second.boundBuffers[binding] = bufferId;
-    }
+            return it->second;
 
-    void VulkanDescriptorSetAllocator::MarkWrittenTexture(uint32_t pipelineId, uint32_t binding, uint32_t textureId)
-    {
-        auto it = m_Sets.find(pipelineId);
-        if (it != m_Sets.end())
-            it->second.boundTextures[binding] = textureId;
-    }
+        // Allocate and write the whole set in one call
+        vk::DescriptorSet set = Allocate(layout);
+        (*m_Context.GetDevice()).updateDescriptorSetWithTemplate(set, updateTemplate, writes.data());
 
-    void VulkanDescriptorSetAllocator::BindDescriptorSets(uint32_t pipelineId, vk::DescriptorSetLayout layout, vk::PipelineLayout pipelineLayout, vk::CommandBuffer cmd)
-    {
-        DescriptorSetEntry& entry = m_Sets.at(pipelineId);
-        if (!entry.dirty) return;
-
-        cmd.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics,
-            pipelineLayout,
-            0, { *entry.set },
-            entry.pendingOffsets
-        );
-
-        entry.dirty = false;
-        entry.pendingOffsets.clear();
+        m_Sets.emplace(key, set);
+        return set;
     }
 
     void VulkanDescriptorSetAllocator::Reset()
     {
-        //m_Sets.clear();
+        for (vk::raii::DescriptorPool& pool : m_Pools)
+            pool.reset();
+
+        m_CurrentPool = 0;
+        m_Sets.clear();
     }
 } // namespace Engine::RHI::Vulkan
@@ -5,6 +5,8 @@
 
 #include "RHI/Vulkan/VulkanConstants.h"
 
+#include <array>
+#include <vector>
 #include <unordered_map>
 
 #include <vulkan/vulkan_raii.hpp>
@@ -14,44 +16,55 @@ namespace Engine::RHI::Vulkan
     // Forward
     class VulkanContext;
 
+    // Contents of a descriptor set: the layout and the ID of the resource bound to each binding.
+    // Equal keys within a frame share one set.
+    struct VulkanDescriptorSetKey {
+        uint32_t                            layoutId  = 0;
+        std::array<uint32_t, k_MaxBindings> resources = {}; // Buffer or texture ID per binding, 0 if unbound
+        std::array<uint32_t, k_MaxBindings> pages     = {}; // Dynamic buffer page per binding, 0 for static resources
+
+        bool operator==(const VulkanDescriptorSetKey& other) const = default;
+    };
+
+    struct VulkanDescriptorSetKeyHash {
+        size_t operator()(const VulkanDescriptorSetKey& key) const noexcept;
+    };
+
+    // Source data for vkUpdateDescriptorSetWithTemplate(). One per binding, the template picks the member matching
+    // the binding's descriptor type.
+    struct VulkanDescriptorWrite {
+        vk::DescriptorBufferInfo buffer;
+        vk::DescriptorImageInfo  image;
+    };
+
+    // Per-frame descriptor set allocator. Sets are never written after they are handed out, so draws recorded earlier in
+    // the frame keep the resources they were recorded with. Everything is released at once in Reset().
     class ENGINE_EXPORT VulkanDescriptorSetAllocator
     {
     private:
         VulkanContext& m_Context;
-        vk::raii::DescriptorPool m_DescriptorPool = nullptr;
 
-        struct DescriptorSetEntry {
-            vk::raii::DescriptorSet             set            = nullptr;
-            std::array<uint32_t, k_MaxBindings> boundBuffers   = {}; // IDs of buffers bound
-            std::array<uint32_t, k_MaxBindings> boundTextures  = {}; // IDs of textures bound
-            std::vector<uint32_t>               pendingOffsets = {}; // dynamic offsets
-            bool                                dirty          = false;
-        };
-        std::unordered_map<uint32_t, DescriptorSetEntry> m_Sets; // Keyed by pipeline ID
+        // Pools are chained: when the current one is exhausted, allocation moves on to the next, creating it if needed
+        std::vector<vk::raii::DescriptorPool> m_Pools;
+        size_t m_CurrentPool = 0;
 
-    public:
-        VulkanDescriptorSetAllocator(VulkanContext& context);
-
-        // Returns existing or allocates new descriptor set for this pipeline layout
-        vk::DescriptorSet GetOrAllocate(uint32_t pipelineId, vk::DescriptorSetLayout layout);
-
-        // Sets offsets
-        void SetDynamicOffset(uint32_t pipelineId, uint32_t binding, uint32_t offset);
+        std::unordered_map<VulkanDescriptorSetKey, vk::DescriptorSet, VulkanDescriptorSetKeyHash> m_Sets;
 
-        // Mark set dirty for texture bindings
-        void MarkDirty(uint32_t pipelineId);
+        void CreatePool();
+        vk::DescriptorSet Allocate(vk::DescriptorSetLayout layout);
 
-        // Returns true if the resource bound to this slot has changed since last write
-        bool NeedsWriteBuffer(uint32_t pipelineId, uint32_t binding, uint32_t bufferId) const;
-        bool NeedsWriteTexture(uint32_t pipelineId, uint32_t binding, uint32_t textureId) const;
-
-        // Records that this resource is now bound to this slot
-        void MarkWrittenBuffer(uint32_t pipelineId, uint32_t binding, uint32_t bufferId);
-        void MarkWrittenTexture(uint32_t pipelineId, uint32_t binding, uint32_t textureId);
+    public:
+        VulkanDescriptorSetAllocator(VulkanContext& context);
 
-        // Binds descriptor sets
-        void BindDescriptorSets(uint32_t pipelineId, vk::DescriptorSetLayout layout, vk::PipelineLayout pipelineLayout, vk::CommandBuffer cmd);
+        // Returns the set already built this frame for key, or allocates one and writes it from writes (indexed by binding)
+        vk::DescriptorSet GetOrAllocate(
+            const VulkanDescriptorSetKey& key,
+            vk::DescriptorSetLayout layout,
+            vk::DescriptorUpdateTemplate updateTemplate,
+            const std::array<VulkanDescriptorWrite, k_MaxBindings>& writes
+        );
 
+        // Frees all sets. Only call once the GPU is done with the frame
         void Reset();
     };
 } // namespace Engine
@@ -1,64 +1,178 @@
 #include "RHI/Vulkan/VulkanDynamicBufferAllocator.h"
+#include "RHI/Vulkan/VulkanConstants.h"
+#include "RHI/Vulkan/VulkanCommon.h"
 #include "Engine/Core/Assert.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace Engine::RHI::Vulkan
 {
-    VulkanDynamicBufferAllocator::VulkanDynamicBufferAllocator(VulkanContext& context, size_t totalSize, vk::BufferUsageFlags usage, size_t alignment)
-        : m_Context(context), m_TotalSize(totalSize), m_Alignment(alignment)
+    // Page IDs only need to be unique among pages, they never collide with resource IDs in a descriptor set key
+    static std::atomic<uint32_t> s_NextPageID = 1;
+
+    VulkanDynamicBufferAllocator::VulkanDynamicBufferAllocator(VulkanContext& context, size_t pageSize, vk::BufferUsageFlags usage, size_t alignment)
+        : m_Context(context), m_Usage(usage), m_PageSize(pageSize), m_Alignment(alignment)
     {
-        if(m_TotalSize > 0)
-        {
-            // Buffer info
-            vk::BufferCreateInfo bufferInfo;
-            bufferInfo.size = m_TotalSize;
-            bufferInfo.usage = usage;
-
-            // Alloc info: map to CPU memory
-            VmaAllocationCreateInfo allocInfo{};
-            allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-
-            VmaAllocationInfo resultInfo;
-            VkBuffer buffer;
-            vmaCreateBuffer(m_Context.GetAllocator(), bufferInfo, &allocInfo, &buffer, &m_Allocation, &resultInfo);
-
-            m_Buffer = buffer;
-            m_MappedData = resultInfo.pMappedData;
-        }
+        ENGINE_CORE_ASSERT(m_PageSize > 0, "Vulkan: VulkanDynamicBufferAllocator: page size must not be 0!");
+
+        m_Pages.push_back(CreatePage(m_PageSize));
+        m_UsedPages = 1;
+        m_CurrentPage.store(m_Pages.front().get(), std::memory_order_relaxed);
     }
 
     VulkanDynamicBufferAllocator::~VulkanDynamicBufferAllocator()
     {
-        if (m_Buffer)
+        for (Scope<Page>& page : m_Pages)
+            DestroyPage(*page);
+    }
+
+    Scope<VulkanDynamicBufferAllocator::Page> VulkanDynamicBufferAllocator::CreatePage(size_t size)
+    {
+        Scope<Page> page = CreateScope<Page>();
+        page->size = size;
+        page->id   = s_NextPageID.fetch_add(1, std::memory_order_relaxed);
+
+        // Buffer info
+        vk::BufferCreateInfo bufferInfo;
+        bufferInfo.size = size;
+        bufferInfo.usage = m_Usage;
+
+        // Alloc info: map to CPU memory
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo resultInfo;
+        VkBuffer buffer;
+        if (vmaCreateBuffer(m_Context.GetAllocator(), bufferInfo, &allocInfo, &buffer, &page->allocation, &resultInfo) != VK_SUCCESS)
+            throw std::runtime_error("Vulkan: VulkanDynamicBufferAllocator: failed to allocate a dynamic buffer page!");
+
+        page->buffer     = buffer;
+        page->mappedData = static_cast<char*>(resultInfo.pMappedData);
+        m_Context.TrackAllocation(VulkanMemoryCategory::Dynamic, page->allocation);
+
+        m_Stats.capacityBytes += size;
+        m_Stats.pages++;
+
+        return page;
+    }
+
+    void VulkanDynamicBufferAllocator::DestroyPage(Page& page)
+    {
+        m_Context.UntrackAllocation(VulkanMemoryCategory::Dynamic, page.allocation);
+        vmaDestroyBuffer(m_Context.GetAllocator(), page.buffer, page.allocation);
+
+        m_Stats.capacityBytes -= page.size;
+        m_Stats.pages--;
+    }
+
+    VulkanDynamicBufferAllocator::Page* VulkanDynamicBufferAllocator::NextPage(Page* full, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // Another thread already moved on, retry there
+        Page* current = m_CurrentPage.load(std::memory_order_relaxed);
+        if (current != full)
+            return current;
+
+        // Reuse a retained page that fits. Allocations larger than a page get a page of their own
+        auto retained = std::find_if(m_Pages.begin() + m_UsedPages, m_Pages.end(), [size](const Scope<Page>& page) {
+            return page->size >= size;
+        });
+
+        if (retained == m_Pages.end())
         {
-            vmaDestroyBuffer(m_Context.GetAllocator(), m_Buffer, m_Allocation);
-            
-            m_Buffer = nullptr;
-            m_Allocation = nullptr;
-            m_MappedData = nullptr;
+            size_t pageSize = std::max(m_PageSize, (size + m_PageSize - 1) / m_PageSize * m_PageSize);
+            m_Pages.push_back(CreatePage(pageSize));
+            retained = m_Pages.end() - 1;
+
+            LOG_CORE_TRACE("Vulkan: VulkanDynamicBufferAllocator: grew to {0} pages ({1} bytes)", m_Stats.pages, m_Stats.capacityBytes);
         }
+
+        std::iter_swap(m_Pages.begin() + m_UsedPages, retained);
+        Page* page = m_Pages[m_UsedPages++].get();
+
+        m_CurrentPage.store(page, std::memory_order_release);
+        return page;
     }
 
-    // Allocates space in mega buffer and returns start offset
-    size_t VulkanDynamicBufferAllocator::AllocateAndCopy(void* data, size_t size)
+    // Allocates space in the current page and returns where it is
+    VulkanDynamicAllocation VulkanDynamicBufferAllocator::Allocate(size_t size, void*& mapped)
     {
-        // Align the current offset
-        size_t alignedOffset = (m_CurrentOffset + m_Alignment - 1) & ~(m_Alignment - 1);
-
-        // Make sure we have enough space
-        ENGINE_CORE_ASSERT(alignedOffset + size <= m_TotalSize, "Vulkan: AllocateAndCopy: AllocateDynamicBuffer(): Dynamic Mega Buffer overflow!");
+        Page* page = m_CurrentPage.load(std::memory_order_acquire);
+        while (true)
+        {
+            // Claim an aligned range. Retries if another thread moved the offset in the meantime
+            size_t currentOffset = page->offset.load(std::memory_order_relaxed);
+            size_t alignedOffset;
+            bool fits;
+            do
+            {
+                alignedOffset = Align(currentOffset);
+                fits = alignedOffset + size <= page->size;
+            }
+            while (fits && !page->offset.compare_exchange_weak(currentOffset, alignedOffset + size, std::memory_order_relaxed));
 
-        char* offsetPtr = static_cast<char*>(m_MappedData) + alignedOffset;
-        std::memcpy(offsetPtr, data, size);
+            if (fits)
+            {
+                mapped = page->mappedData + alignedOffset;
+                return { page->buffer, alignedOffset, page->id };
+            }
 
-        // Update offset
-        m_CurrentOffset = alignedOffset + size;
+            page = NextPage(page, size);
+        }
+    }
 
-        return alignedOffset;
+    VulkanDynamicAllocation VulkanDynamicBufferAllocator::AllocateAndCopy(const void* data, size_t size)
+    {
+        // The range is ours, copy outside of the allocation loop
+        void* mapped = nullptr;
+        VulkanDynamicAllocation allocation = Allocate(size, mapped);
+        VulkanCommon::CopyToMapped(mapped, data, size);
+        return allocation;
     }
 
     void VulkanDynamicBufferAllocator::Reset()
     {
-        m_CurrentOffset = 0;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // Telemetry of the frame that just completed
+        size_t usedBytes = 0;
+        for (size_t i = 0; i < m_UsedPages; i++)
+        {
+            usedBytes += m_Pages[i]->offset.load(std::memory_order_relaxed);
+            m_Pages[i]->offset.store(0, std::memory_order_relaxed);
+        }
+
+        m_Stats.usedBytes      = usedBytes;
+        m_Stats.highWaterBytes = std::max(m_Stats.highWaterBytes, usedBytes);
+
+        // Free pages no frame in the window needed. The GPU is done with this frame, so nothing references them
+        m_WindowPeakPages = std::max(m_WindowPeakPages, m_UsedPages);
+        if (++m_WindowFrames >= k_DynamicBufferShrinkFrames)
+        {
+            if (m_Pages.size() > m_WindowPeakPages)
+            {
+                // Keep the used pages in front, free the largest of the rest first
+                std::sort(m_Pages.begin() + m_UsedPages, m_Pages.end(), [](const Scope<Page>& a, const Scope<Page>& b) {
+                    return a->size < b->size;
+                });
+
+                while (m_Pages.size() > m_WindowPeakPages)
+                {
+                    DestroyPage(*m_Pages.back());
+                    m_Pages.pop_back();
+                }
+
+                LOG_CORE_TRACE("Vulkan: VulkanDynamicBufferAllocator: shrank to {0} pages ({1} bytes)", m_Stats.pages, m_Stats.capacityBytes);
+            }
+
+            m_WindowFrames    = 0;
+            m_WindowPeakPages = 0;
+        }
+
+        m_UsedPages = 1;
+        m_CurrentPage.store(m_Pages.front().get(), std::memory_order_relaxed);
     }
 } // namespace Engine
@@ -3,8 +3,15 @@
 
 #include "engine_export.h"
 
+#include "Engine/Core/Base.h"
+
 #include "RHI/Vulkan/VulkanContext.h"
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
 #include <vulkan/vulkan_raii.hpp>
 #include <vk_mem_alloc.h>
 
@@ -13,27 +20,68 @@ namespace Engine::RHI::Vulkan
     // Forward
     class VulkanContext;
 
+    // Where an allocation landed. pageId identifies the buffer for descriptor set caching
+    struct VulkanDynamicAllocation {
+        vk::Buffer buffer = nullptr;
+        size_t     offset = 0;
+        uint32_t   pageId = 0;
+    };
+
+    struct VulkanDynamicBufferStats {
+        size_t   usedBytes      = 0; // Last completed frame
+        size_t   highWaterBytes = 0; // Most used by any frame
+        size_t   capacityBytes  = 0;
+        uint32_t pages          = 0;
+    };
+
+    // Per-frame linear allocator for dynamic buffer data. Memory comes in host-visible pages: when the current page is
+    // full, allocation moves on to a retained page or a new one. Pages beyond what recent frames needed are freed.
     class ENGINE_EXPORT VulkanDynamicBufferAllocator
     {
     private:
         VulkanContext& m_Context;
 
-        VmaAllocation m_Allocation = nullptr;
-        vk::Buffer m_Buffer = nullptr;
-        void* m_MappedData = nullptr;
-        size_t m_CurrentOffset = 0;
-        size_t m_TotalSize = 0;
-        size_t m_Alignment = 0;
+        struct Page {
+            vk::Buffer          buffer     = nullptr;
+            VmaAllocation       allocation = nullptr;
+            char*               mappedData = nullptr;
+            size_t              size       = 0;
+            uint32_t            id         = 0;
+            std::atomic<size_t> offset     = 0; // Bumped lock-free, passes may be recorded on several threads
+        };
+
+        vk::BufferUsageFlags m_Usage;
+        size_t               m_PageSize  = 0;
+        size_t               m_Alignment = 0;
+
+        std::mutex               m_Mutex;          // Guards m_Pages and m_UsedPages
+        std::vector<Scope<Page>> m_Pages;          // The first m_UsedPages are in use this frame, the rest are retained
+        size_t                   m_UsedPages = 0;
+        std::atomic<Page*>       m_CurrentPage = nullptr;
+
+        // Telemetry and shrinking
+        VulkanDynamicBufferStats m_Stats;
+        uint32_t                 m_WindowFrames    = 0;
+        size_t                   m_WindowPeakPages = 0;
+
+        size_t Align(size_t offset) const { return (offset + m_Alignment - 1) & ~(m_Alignment - 1); }
+
+        Scope<Page> CreatePage(size_t size);
+        void DestroyPage(Page& page);
+        Page* NextPage(Page* full, size_t size);
 
     public:
-        VulkanDynamicBufferAllocator(VulkanContext& context, size_t totalSize, vk::BufferUsageFlags usage, size_t alignment);
+        VulkanDynamicBufferAllocator(VulkanContext& context, size_t pageSize, vk::BufferUsageFlags usage, size_t alignment);
         ~VulkanDynamicBufferAllocator();
 
-        size_t AllocateAndCopy(void* data, size_t size);
-
-        vk::Buffer& GetBuffer() { return m_Buffer; }
+        // Thread safe. mapped points at size writable bytes, persistently mapped for sequential writes
+        VulkanDynamicAllocation Allocate(size_t size, void*& mapped);
+        VulkanDynamicAllocation AllocateAndCopy(const void* data, size_t size);
 
+        // Only call once the GPU is done with the frame
         void Reset();
+
+        const VulkanDynamicBufferStats& GetStats() const { return m_Stats; }
     };
 } // namespace Engine::RHI::Vulkan
 
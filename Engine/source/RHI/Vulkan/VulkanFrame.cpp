@@ -5,32 +5,50 @@
 
 namespace Engine::RHI::Vulkan
 {
-    VulkanFrame::VulkanFrame(VulkanContext& context)
+    VulkanFrame::VulkanFrame(VulkanContext& context, bool profiling, bool pipelineStatistics)
         : m_CommandBufferAllocator(context),
           m_VertexDynamicBufferAllocator(
             context, 
-            k_VertexDynamicBufferSizePerFrame, 
+            k_VertexDynamicBufferPageSize, 
             vk::BufferUsageFlagBits::eVertexBuffer,
             64
           ),
           m_IndexDynamicBufferAllocator(
             context, 
-            k_VertexDynamicBufferSizePerFrame, 
+            k_IndexDynamicBufferPageSize, 
             vk::BufferUsageFlagBits::eIndexBuffer,
             64
           ),
           m_UniformDynamicBufferAllocator(
             context, 
-            k_VertexDynamicBufferSizePerFrame, 
+            k_UniformDynamicBufferPageSize, 
             vk::BufferUsageFlagBits::eUniformBuffer,
             context.GetPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment
           ),
-          m_DescriptorSetAllocator(context)
+          m_IndirectDynamicBufferAllocator(
+            context, 
+            k_IndirectDynamicBufferPageSize, 
+            vk::BufferUsageFlagBits::eIndirectBuffer,
+            4
+          )
     {
-        // Create fence
-        vk::FenceCreateInfo fenceInfo;
-        fenceInfo.flags = vk::FenceCreateFlagBits::eSignaled;
-        m_Fence = vk::raii::Fence(context.GetDevice(), fenceInfo);
+        if (profiling)
+            m_Profiler = CreateScope<VulkanFrameProfiler>(context, pipelineStatistics);
+    }
+
+    VulkanDynamicBufferAllocator& VulkanFrame::GetDynamicBufferAllocator(BufferType type)
+    {
+        switch (type)
+        {
+            case BufferType::Vertex:   return m_VertexDynamicBufferAllocator;
+            case BufferType::Index:    return m_IndexDynamicBufferAllocator;
+            case BufferType::Uniform:  return m_UniformDynamicBufferAllocator;
+            case BufferType::Indirect: return m_IndirectDynamicBufferAllocator;
+            case BufferType::Storage:  break; // Always static
+        }
+
+        ENGINE_CORE_ASSERT(false, "Vulkan: VulkanFrame: GetDynamicBufferAllocator(): buffer type has no dynamic allocator!");
+        return m_VertexDynamicBufferAllocator;
     }
 
     VulkanFrame::~VulkanFrame()
@@ -44,7 +62,7 @@ namespace Engine::RHI::Vulkan
         m_VertexDynamicBufferAllocator.Reset();
         m_IndexDynamicBufferAllocator.Reset();
         m_UniformDynamicBufferAllocator.Reset();
-        m_DescriptorSetAllocator.Reset();
+        m_IndirectDynamicBufferAllocator.Reset();
     }    
 
 } // namespace Engine::RHI::Vulkan
@@ -5,7 +5,7 @@
 
 #include "RHI/Vulkan/VulkanCommandBufferAllocator.h"
 #include "RHI/Vulkan/VulkanDynamicBufferAllocator.h"
-#include "RHI/Vulkan/VulkanDescriptorSetAllocator.h"
+#include "RHI/Vulkan/VulkanFrameProfiler.h"
 
 #include <cstdint>
 
@@ -18,34 +18,38 @@ namespace Engine::RHI::Vulkan
     class ENGINE_EXPORT VulkanFrame
     {
     private:
-        // CPU Fence
-        vk::raii::Fence m_Fence = nullptr;
+        // Value of the device frame timeline semaphore that is signalled once this frame's work is complete
+        uint64_t m_TimelineValue = 0;
 
-        // Comand buffer allocation
+        // Comand buffer allocation. Also owns the per-thread descriptor set allocators
         VulkanCommandBufferAllocator m_CommandBufferAllocator;
 
         // Dynamic buffers
         VulkanDynamicBufferAllocator m_VertexDynamicBufferAllocator;
         VulkanDynamicBufferAllocator m_IndexDynamicBufferAllocator;
         VulkanDynamicBufferAllocator m_UniformDynamicBufferAllocator;
+        VulkanDynamicBufferAllocator m_IndirectDynamicBufferAllocator;
 
-        // Descriptor set allocator
-        VulkanDescriptorSetAllocator m_DescriptorSetAllocator;
+        // GPU timings, null unless profiling
+        Scope<VulkanFrameProfiler> m_Profiler;
 
     public:
-        VulkanFrame(VulkanContext& context);
+        VulkanFrame(VulkanContext& context, bool profiling = false, bool pipelineStatistics = false);
         ~VulkanFrame();
 
         // Begin new frame
         void Reset();
 
         // Getters
-        vk::raii::Fence& GetFence() { return m_Fence; }
+        uint64_t GetTimelineValue() const { return m_TimelineValue; }
+        void SetTimelineValue(uint64_t value) { m_TimelineValue = value; }
         VulkanCommandBufferAllocator& GetCommandBufferAllocator() { return m_CommandBufferAllocator; };
         VulkanDynamicBufferAllocator& GetVertexDynamicBufferAllocator() { return m_VertexDynamicBufferAllocator; }
         VulkanDynamicBufferAllocator& GetIndexDynamicBufferAllocator() { return m_IndexDynamicBufferAllocator; }
         VulkanDynamicBufferAllocator& GetUniformDynamicBufferAllocator() { return m_UniformDynamicBufferAllocator; }
-        VulkanDescriptorSetAllocator& GetDescriptorSetAllocator() { return m_DescriptorSetAllocator; }
+        VulkanDynamicBufferAllocator& GetIndirectDynamicBufferAllocator() { return m_IndirectDynamicBufferAllocator; }
+        VulkanDynamicBufferAllocator& GetDynamicBufferAllocator(BufferType type);
+        VulkanFrameProfiler* GetProfiler() { return m_Profiler.get(); }
 
     };
 } // namespace Engine
@@ -0,0 +1,179 @@
+#include "RHI/Vulkan/VulkanFrameProfiler.h"
+#include "RHI/Vulkan/VulkanContext.h"
+#include "RHI/Vulkan/VulkanConstants.h"
+#include "Engine/Core/Assert.h"
+
+#include <algorithm>
+
+namespace Engine::RHI::Vulkan
+{
+    // One result per bit of k_PipelineStatistics
+    static constexpr uint32_t k_PipelineStatisticCount = 6;
+
+    VulkanFrameProfiler::VulkanFrameProfiler(VulkanContext& context, bool pipelineStatistics)
+        : m_Context(context)
+    {
+        vk::QueryPoolCreateInfo timestampInfo({}, vk::QueryType::eTimestamp, k_MaxTimestampQueriesPerFrame);
+        m_TimestampPool = vk::raii::QueryPool(m_Context.GetDevice(), timestampInfo);
+
+        if (pipelineStatistics)
+        {
+            vk::QueryPoolCreateInfo statisticsInfo({}, vk::QueryType::ePipelineStatistics, k_MaxStatisticsQueriesPerFrame, k_PipelineStatistics);
+            m_StatisticsPool = vk::raii::QueryPool(m_Context.GetDevice(), statisticsInfo);
+        }
+
+        // Queries must be reset before their first use
+        ResetPools();
+    }
+
+    void VulkanFrameProfiler::ResetPools()
+    {
+        m_TimestampPool.reset(0, k_MaxTimestampQueriesPerFrame);
+        if (*m_StatisticsPool)
+            m_StatisticsPool.reset(0, k_MaxStatisticsQueriesPerFrame);
+
+        m_NextTimestamp.store(0, std::memory_order_relaxed);
+        m_NextStatistics.store(0, std::memory_order_relaxed);
+        m_Scopes.clear();
+    }
+
+    uint32_t VulkanFrameProfiler::BeginScope(vk::CommandBuffer cmd, const std::string& name, uint32_t parent, uint32_t submissionIndex, bool statistics)
+    {
+        uint32_t timestamp = m_NextTimestamp.fetch_add(2, std::memory_order_relaxed);
+        if (timestamp + 2 > k_MaxTimestampQueriesPerFrame)
+            return k_InvalidScope;
+
+        uint32_t statisticsQuery = k_InvalidScope;
+        if (statistics && *m_StatisticsPool)
+        {
+            statisticsQuery = m_NextStatistics.fetch_add(1, std::memory_order_relaxed);
+            if (statisticsQuery >= k_MaxStatisticsQueriesPerFrame)
+                statisticsQuery = k_InvalidScope;
+        }
+
+        cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, *m_TimestampPool, timestamp);
+        if (statisticsQuery != k_InvalidScope)
+            cmd.beginQuery(*m_StatisticsPool, statisticsQuery, {});
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Scopes.push_back({ name, parent, submissionIndex, timestamp, statisticsQuery });
+        return static_cast<uint32_t>(m_Scopes.size() - 1);
+    }
+
+    void VulkanFrameProfiler::EndScope(vk::CommandBuffer cmd, uint32_t scope)
+    {
+        if (scope == k_InvalidScope)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ProfileScope& profileScope = m_Scopes[scope];
+
+        if (profileScope.statistics != k_InvalidScope)
+            cmd.endQuery(*m_StatisticsPool, profileScope.statistics);
+        cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, *m_TimestampPool, profileScope.timestamp + 1);
+
+        profileScope.ended = true;
+    }
+
+    bool VulkanFrameProfiler::Resolve(GpuFrameTimings& timings)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_Scopes.empty())
+            return false;
+
+        // The frame is complete, so every written query is available and this doesn't wait
+        uint32_t timestampCount = std::min(m_NextTimestamp.load(std::memory_order_relaxed), k_MaxTimestampQueriesPerFrame);
+        auto [timestampResult, timestamps] = m_TimestampPool.getResults<uint64_t>(
+            0, timestampCount, timestampCount * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64
+        );
+
+        std::vector<uint64_t> statistics;
+        if (*m_StatisticsPool)
+        {
+            uint32_t statisticsCount = std::min(m_NextStatistics.load(std::memory_order_relaxed), k_MaxStatisticsQueriesPerFrame);
+            if (statisticsCount > 0)
+            {
+                size_t stride = k_PipelineStatisticCount * sizeof(uint64_t);
+                auto [statisticsResult, results] = m_StatisticsPool.getResults<uint64_t>(
+                    0, statisticsCount, statisticsCount * stride, stride, vk::QueryResultFlagBits::e64
+                );
+                if (statisticsResult == vk::Result::eSuccess)
+                    statistics = std::move(results);
+            }
+        }
+
+        if (timestampResult != vk::Result::eSuccess)
+        {
+            ResetPools();
+            return false;
+        }
+
+        // Timestamps only count validBits bits before wrapping around
+        uint32_t validBits = m_Context.GetTimestampValidBits();
+        uint64_t mask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+        double period = m_Context.GetPhysicalDeviceProperties().limits.timestampPeriod; // Nanoseconds per tick
+        auto elapsed = [&](uint64_t begin, uint64_t end) {
+            return static_cast<double>((end - begin) & mask) * period / 1000000.0;
+        };
+
+        // Link children to their parents. Children come from the parent's command buffer, so creation order is
+        // recording order
+        std::vector<std::vector<uint32_t>> children(m_Scopes.size());
+        std::vector<uint32_t> passes;
+        for (uint32_t i = 0; i < m_Scopes.size(); i++)
+        {
+            if (!m_Scopes[i].ended)
+                continue;
+
+            if (m_Scopes[i].parent == k_InvalidScope)
+                passes.push_back(i);
+            else
+                children[m_Scopes[i].parent].push_back(i);
+        }
+
+        std::ranges::sort(passes, [&](uint32_t a, uint32_t b) {
+            return m_Scopes[a].submissionIndex < m_Scopes[b].submissionIndex;
+        });
+
+        auto buildNode = [&](auto& self, uint32_t index) -> GpuTimingNode {
+            const ProfileScope& scope = m_Scopes[index];
+
+            GpuTimingNode node;
+            node.name         = scope.name;
+            node.milliseconds = elapsed(timestamps[scope.timestamp], timestamps[scope.timestamp + 1]);
+
+            if (scope.statistics != k_InvalidScope && !statistics.empty())
+            {
+                const uint64_t* values = &statistics[scope.statistics * k_PipelineStatisticCount];
+                node.statistics.inputAssemblyVertices     = values[0];
+                node.statistics.inputAssemblyPrimitives   = values[1];
+                node.statistics.vertexShaderInvocations   = values[2];
+                node.statistics.clippingPrimitives        = values[3];
+                node.statistics.fragmentShaderInvocations = values[4];
+                node.statistics.computeShaderInvocations  = values[5];
+            }
+
+            for (uint32_t child : children[index])
+                node.children.push_back(self(self, child));
+
+            return node;
+        };
+
+        timings.passes.clear();
+        for (uint32_t pass : passes)
+            timings.passes.push_back(buildNode(buildNode, pass));
+
+        // Passes execute in submission order, so the frame spans the first start to the latest end
+        timings.milliseconds = 0.0;
+        if (!passes.empty())
+        {
+            uint64_t start = timestamps[m_Scopes[passes.front()].timestamp];
+            for (uint32_t pass : passes)
+                timings.milliseconds = std::max(timings.milliseconds, elapsed(start, timestamps[m_Scopes[pass].timestamp + 1]));
+        }
+
+        ResetPools();
+        return true;
+    }
+} // namespace Engine::RHI::Vulkan
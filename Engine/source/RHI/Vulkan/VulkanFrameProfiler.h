@@ -0,0 +1,73 @@
+#ifndef RHI_VULKAN_VULKANFRAMEPROFILER
+#define RHI_VULKAN_VULKANFRAMEPROFILER
+
+#include "engine_export.h"
+
+#include "Engine/RHI/RHI.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Engine::RHI::Vulkan
+{
+    // Forward
+    class VulkanContext;
+
+    // Per-frame GPU timing. Passes and markers open scopes that write a timestamp at each end. Passes may be recorded on
+    // several threads, so queries are handed out lock-free and scopes are collected under a mutex.
+    class ENGINE_EXPORT VulkanFrameProfiler
+    {
+    private:
+        VulkanContext& m_Context;
+
+        vk::raii::QueryPool m_TimestampPool  = nullptr;
+        vk::raii::QueryPool m_StatisticsPool = nullptr; // Null without pipeline statistics
+
+        std::atomic<uint32_t> m_NextTimestamp  = 0;
+        std::atomic<uint32_t> m_NextStatistics = 0;
+
+        struct ProfileScope {
+            std::string name;
+            uint32_t    parent;          // ~0u for passes
+            uint32_t    submissionIndex; // Orders passes
+            uint32_t    timestamp;       // Begin, end is timestamp + 1
+            uint32_t    statistics;      // ~0u without a statistics query
+            bool        ended = false;
+        };
+
+        std::mutex                m_Mutex; // Guards m_Scopes
+        std::vector<ProfileScope> m_Scopes;
+
+        void ResetPools();
+
+    public:
+        static constexpr uint32_t k_InvalidScope = ~0u;
+
+        // Statistics in the order the results are written, which follows the flag bits. Bundles inherit them
+        static constexpr vk::QueryPipelineStatisticFlags k_PipelineStatistics =
+            vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+            vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+            vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+            vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+            vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+            vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+        VulkanFrameProfiler(VulkanContext& context, bool pipelineStatistics);
+
+        // Thread safe. Scopes must end in the command buffer they began in. Returns k_InvalidScope once queries run out
+        uint32_t BeginScope(vk::CommandBuffer cmd, const std::string& name, uint32_t parent, uint32_t submissionIndex, bool statistics);
+        void EndScope(vk::CommandBuffer cmd, uint32_t scope);
+
+        // Reads the results and resets for the next use. Only call once the GPU is done with the frame.
+        // Returns false if nothing was recorded.
+        bool Resolve(GpuFrameTimings& timings);
+    };
+} // namespace Engine::RHI::Vulkan
+
+
+#endif // RHI_VULKAN_VULKANFRAMEPROFILER
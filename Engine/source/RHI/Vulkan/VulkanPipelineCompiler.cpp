@@ -0,0 +1,205 @@
+#include "RHI/Vulkan/VulkanPipelineCompiler.h"
+#include "RHI/Vulkan/VulkanContext.h"
+#include "Engine/Core/Log.h"
+
+#include <algorithm>
+
+namespace Engine::RHI::Vulkan
+{
+    VulkanPipelineCompiler::VulkanPipelineCompiler(VulkanContext& context, uint32_t threadCount)
+        : m_Context(context)
+    {
+        if(threadCount == 0)
+        {
+            // Leave some threads for the main thread and driver
+            threadCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+        }
+
+        for(uint32_t i = 0; i < threadCount; i++)
+        {
+            m_Workers.emplace_back(&VulkanPipelineCompiler::WorkerLoop, this);
+        }
+    }
+
+    VulkanPipelineCompiler::~VulkanPipelineCompiler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Condition.notify_all();
+
+        for(std::thread& worker : m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    void VulkanPipelineCompiler::WorkerLoop()
+    {
+        while(true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+
+                // Drain the queue before stopping so no future is left without a value
+                if(m_Jobs.empty())
+                    return;
+
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::future<vk::raii::Pipeline> VulkanPipelineCompiler::CompileAsync(VulkanPipelineBuildState state)
+    {
+        auto task = std::make_shared<std::packaged_task<vk::raii::Pipeline()>>(
+            [this, state = std::move(state)]() { return Compile(state); }
+        );
+        std::future<vk::raii::Pipeline> future = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Jobs.emplace_back([task]() { (*task)(); });
+        }
+        m_Condition.notify_one();
+
+        return future;
+    }
+
+    vk::raii::Pipeline VulkanPipelineCompiler::Compile(const VulkanPipelineBuildState& state)
+    {
+        // Get shader stage create infos
+        std::vector<vk::PipelineShaderStageCreateInfo> shaderStageInfos;
+        for(auto const& stage : state.stages)
+        {
+            vk::PipelineShaderStageCreateInfo stageInfo;
+            stageInfo.stage = stage.stage;
+            stageInfo.module = stage.module;
+            stageInfo.pName = stage.entryPoint.c_str();
+            stageInfo.pSpecializationInfo = nullptr;
+            shaderStageInfos.push_back(stageInfo);
+        }
+
+        // Get vertex input info
+        vk::VertexInputBindingDescription bindingDescription = { 0, state.vertexStride, vk::VertexInputRate::eVertex };
+        vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(state.attributes.size());
+        vertexInputInfo.pVertexAttributeDescriptions = state.attributes.data();
+
+        // Topology
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly(
+            {},
+            state.topology,
+            state.primitiveRestart ? vk::True : vk::False
+        );
+
+        // Viewport & Scissor dynamic states
+        std::vector dynamicStates = {
+            vk::DynamicState::eViewport,
+            vk::DynamicState::eScissor
+        };
+        vk::PipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates = dynamicStates.data();
+
+        // Blank VP and Scissor state
+        vk::PipelineViewportStateCreateInfo viewportState{};
+        viewportState.viewportCount = 1;
+        viewportState.pViewports = nullptr;
+        viewportState.scissorCount = 1;
+        viewportState.pScissors = nullptr;
+        
+        // Rasterizer
+        vk::PipelineRasterizationStateCreateInfo rasterizer;
+        rasterizer.depthClampEnable = vk::False;
+        rasterizer.rasterizerDiscardEnable = vk::False;
+        rasterizer.polygonMode = state.polygonMode;
+        rasterizer.cullMode = state.cullMode;
+        rasterizer.frontFace = state.frontFace;
+        rasterizer.depthBiasEnable = vk::False;
+        rasterizer.lineWidth = 1.0f;
+
+        // Multisampling
+        vk::PipelineMultisampleStateCreateInfo multisampling;
+        multisampling.rasterizationSamples = vk::SampleCountFlagBits::e1;
+        multisampling.sampleShadingEnable = vk::False;
+        
+        // Blending
+        vk::PipelineColorBlendAttachmentState colorBlendAttachment;
+        colorBlendAttachment.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+        if(state.blending)
+        {
+            colorBlendAttachment.blendEnable = vk::True;
+            colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
+            colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+            colorBlendAttachment.colorBlendOp = vk::BlendOp::eAdd;
+            colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
+            colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eZero;
+            colorBlendAttachment.alphaBlendOp = vk::BlendOp::eAdd;
+        }
+        else
+        {
+            colorBlendAttachment.blendEnable = vk::False;
+        }
+
+        vk::PipelineColorBlendStateCreateInfo colorBlending;
+        colorBlending.logicOpEnable = vk::False;
+        colorBlending.logicOp = vk::LogicOp::eCopy;
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments = &colorBlendAttachment;
+
+        // Depth testing
+        vk::PipelineDepthStencilStateCreateInfo depthStencil;
+        depthStencil.depthTestEnable  = state.depthTest ? vk::True : vk::False;
+        depthStencil.depthWriteEnable = state.depthWrite ? vk::True : vk::False;
+        depthStencil.depthCompareOp   = vk::CompareOp::eLess;
+
+        vk::GraphicsPipelineCreateInfo gfxPipeInfo;
+        gfxPipeInfo.stageCount          = shaderStageInfos.size();
+        gfxPipeInfo.pStages             = shaderStageInfos.data();
+        gfxPipeInfo.pVertexInputState   = &vertexInputInfo;
+        gfxPipeInfo.pInputAssemblyState = &inputAssembly;
+        gfxPipeInfo.pViewportState      = &viewportState;
+        gfxPipeInfo.pRasterizationState = &rasterizer;
+        gfxPipeInfo.pMultisampleState   = &multisampling;
+        gfxPipeInfo.pColorBlendState    = &colorBlending;
+        gfxPipeInfo.pDepthStencilState  = &depthStencil;
+        gfxPipeInfo.pDynamicState       = &dynamicState;
+        gfxPipeInfo.layout              = state.layout;
+        gfxPipeInfo.renderPass          = nullptr;
+
+        vk::PipelineRenderingCreateInfo pipeRenderInfo;
+        pipeRenderInfo.colorAttachmentCount    = state.colorAttachmentFormats.size();
+        pipeRenderInfo.pColorAttachmentFormats = state.colorAttachmentFormats.data();
+        pipeRenderInfo.depthAttachmentFormat   = state.depthFormat;
+
+        vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::PipelineRenderingCreateInfo> pipelineCreateInfoChain(
+            gfxPipeInfo,
+            pipeRenderInfo
+        );
+
+        // The pipeline cache is internally synchronized, so this is safe from any thread
+        return vk::raii::Pipeline(m_Context.GetDevice(), m_Context.GetPipelineCache(), pipelineCreateInfoChain.get<vk::GraphicsPipelineCreateInfo>());
+    }
+
+    vk::raii::Pipeline VulkanPipelineCompiler::CompileCompute(vk::ShaderModule module, const std::string& entryPoint, vk::PipelineLayout layout)
+    {
+        vk::PipelineShaderStageCreateInfo stageInfo;
+        stageInfo.stage  = vk::ShaderStageFlagBits::eCompute;
+        stageInfo.module = module;
+        stageInfo.pName  = entryPoint.c_str();
+
+        vk::ComputePipelineCreateInfo computePipeInfo;
+        computePipeInfo.stage  = stageInfo;
+        computePipeInfo.layout = layout;
+
+        return vk::raii::Pipeline(m_Context.GetDevice(), m_Context.GetPipelineCache(), computePipeInfo);
+    }
+} // namespace Engine::RHI::Vulkan
@@ -0,0 +1,82 @@
+#ifndef RHI_VULKAN_VULKANPIPELINECOMPILER
+#define RHI_VULKAN_VULKANPIPELINECOMPILER
+
+#include "engine_export.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Engine::RHI::Vulkan
+{
+    // Forward
+    class VulkanContext;
+
+    // Everything needed to compile a graphics pipeline, resolved from a PipelineDesc on the main thread.
+    // Holds no references into device resource maps so it can be compiled on any thread.
+    struct VulkanPipelineBuildState {
+        struct Stage {
+            vk::ShaderStageFlagBits stage;
+            vk::ShaderModule        module;
+            std::string             entryPoint;
+        };
+        std::vector<Stage> stages;
+
+        uint32_t                                         vertexStride = 0;
+        std::vector<vk::VertexInputAttributeDescription> attributes;
+
+        vk::PrimitiveTopology topology    = vk::PrimitiveTopology::eTriangleList;
+        bool                  primitiveRestart = false;
+        vk::PolygonMode       polygonMode = vk::PolygonMode::eFill;
+        vk::CullModeFlags     cullMode    = vk::CullModeFlagBits::eBack;
+        vk::FrontFace         frontFace   = vk::FrontFace::eClockwise;
+        bool                  blending    = false;
+        bool                  depthTest   = false;
+        bool                  depthWrite  = true;
+
+        std::vector<vk::Format> colorAttachmentFormats;
+        vk::Format              depthFormat = vk::Format::eUndefined;
+
+        vk::PipelineLayout layout = nullptr;
+    };
+
+    // Compiles pipelines either inline or on a pool of worker threads.
+    class ENGINE_EXPORT VulkanPipelineCompiler
+    {
+    private:
+        VulkanContext& m_Context;
+
+        std::vector<std::thread>          m_Workers;
+        std::deque<std::function<void()>> m_Jobs;
+        std::mutex                        m_Mutex;
+        std::condition_variable           m_Condition;
+        bool                              m_Stopping = false;
+
+        void WorkerLoop();
+
+    public:
+        // threadCount of 0 picks a count based on the number of hardware threads
+        VulkanPipelineCompiler(VulkanContext& context, uint32_t threadCount = 0);
+        ~VulkanPipelineCompiler(); // Finishes all queued jobs
+
+        // Compiles on the calling thread
+        vk::raii::Pipeline Compile(const VulkanPipelineBuildState& state);
+
+        // Compiles on a worker thread. Exceptions are rethrown from the future.
+        std::future<vk::raii::Pipeline> CompileAsync(VulkanPipelineBuildState state);
+
+        // Compute pipelines have a single stage and no fixed function state, so they are always compiled inline
+        vk::raii::Pipeline CompileCompute(vk::ShaderModule module, const std::string& entryPoint, vk::PipelineLayout layout);
+    };
+} // namespace Engine::RHI::Vulkan
+
+
+#endif // RHI_VULKAN_VULKANPIPELINECOMPILER
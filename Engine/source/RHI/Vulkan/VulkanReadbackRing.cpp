@@ -0,0 +1,132 @@
+#include "RHI/Vulkan/VulkanReadbackRing.h"
+#include "RHI/Vulkan/VulkanContext.h"
+#include "RHI/Vulkan/VulkanConstants.h"
+#include "Engine/Core/Assert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Engine::RHI::Vulkan
+{
+    VulkanReadbackRing::VulkanReadbackRing(VulkanContext& context)
+        : m_Context(context)
+    {
+    }
+
+    VulkanReadbackRing::~VulkanReadbackRing()
+    {
+        for (Scope<Page>& page : m_FreePages)
+            DestroyPage(*page);
+
+        for (auto& [id, readback] : m_Readbacks)
+            DestroyPage(*readback.page);
+    }
+
+    Scope<VulkanReadbackRing::Page> VulkanReadbackRing::CreatePage(size_t size)
+    {
+        Scope<Page> page = CreateScope<Page>();
+        page->size = size;
+
+        // Buffer info
+        vk::BufferCreateInfo bufferInfo;
+        bufferInfo.size = size;
+        bufferInfo.usage = vk::BufferUsageFlagBits::eTransferDst;
+
+        // Alloc info: CPU memory, cached if possible since the CPU reads it
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo resultInfo;
+        VkBuffer buffer;
+        if (vmaCreateBuffer(m_Context.GetAllocator(), bufferInfo, &allocInfo, &buffer, &page->allocation, &resultInfo) != VK_SUCCESS)
+            throw std::runtime_error("Vulkan: VulkanReadbackRing: failed to allocate a readback buffer!");
+
+        page->buffer     = buffer;
+        page->mappedData = static_cast<char*>(resultInfo.pMappedData);
+        m_Context.TrackAllocation(VulkanMemoryCategory::Staging, page->allocation);
+
+        return page;
+    }
+
+    void VulkanReadbackRing::DestroyPage(Page& page)
+    {
+        m_Context.UntrackAllocation(VulkanMemoryCategory::Staging, page.allocation);
+        vmaDestroyBuffer(m_Context.GetAllocator(), page.buffer, page.allocation);
+    }
+
+    void VulkanReadbackRing::Release(Scope<Page> page)
+    {
+        m_FreePages.push_back(std::move(page));
+
+        // Keep a few buffers around for the next readbacks
+        while (m_FreePages.size() > k_MaxRetainedReadbackPages)
+        {
+            DestroyPage(*m_FreePages.front());
+            m_FreePages.pop_front();
+        }
+    }
+
+    vk::Buffer VulkanReadbackRing::Request(uint32_t id, size_t size, uint64_t frame)
+    {
+        ENGINE_CORE_ASSERT(size > 0, "Vulkan: VulkanReadbackRing: Request(): size must not be 0!");
+
+        Readback& readback = m_Readbacks[id];
+        readback.size  = size;
+        readback.frame = frame;
+
+        // Oldest free buffer that fits, otherwise a new one. Small readbacks share the minimum page size
+        auto it = std::ranges::find_if(m_FreePages, [size](const Scope<Page>& page) { return page->size >= size; });
+        if (it != m_FreePages.end())
+        {
+            readback.page = std::move(*it);
+            m_FreePages.erase(it);
+        }
+        else
+        {
+            readback.page = CreatePage(std::max<size_t>(size, k_ReadbackPageSize));
+        }
+
+        return readback.page->buffer;
+    }
+
+    bool VulkanReadbackRing::Poll(uint32_t id, uint64_t completedFrame, std::vector<char>& data)
+    {
+        auto it = m_Readbacks.find(id);
+        ENGINE_CORE_ASSERT(it != m_Readbacks.end(), "Vulkan: VulkanReadbackRing: Poll(): readback is not found!");
+
+        Readback& readback = it->second;
+        if (readback.frame > completedFrame)
+            return false;
+
+        // Memory may not be host coherent
+        vmaInvalidateAllocation(m_Context.GetAllocator(), readback.page->allocation, 0, readback.size);
+
+        data.resize(readback.size);
+        std::memcpy(data.data(), readback.page->mappedData, readback.size);
+
+        Release(std::move(readback.page));
+        m_Readbacks.erase(it);
+        return true;
+    }
+
+    void VulkanReadbackRing::Cancel(uint32_t id)
+    {
+        auto it = m_Readbacks.find(id);
+        if (it != m_Readbacks.end())
+            it->second.cancelled = true;
+    }
+
+    void VulkanReadbackRing::Update(uint64_t completedFrame)
+    {
+        std::erase_if(m_Readbacks, [&](auto& entry) {
+            Readback& readback = entry.second;
+            if (!readback.cancelled || readback.frame > completedFrame)
+                return false;
+
+            Release(std::move(readback.page));
+            return true;
+        });
+    }
+} // namespace Engine::RHI::Vulkan
@@ -0,0 +1,69 @@
+#ifndef RHI_VULKAN_VULKANREADBACKRING
+#define RHI_VULKAN_VULKANREADBACKRING
+
+#include "engine_export.h"
+
+#include "Engine/Core/Base.h"
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+#include <vk_mem_alloc.h>
+
+namespace Engine::RHI::Vulkan
+{
+    // Forward
+    class VulkanContext;
+
+    // Host-visible buffers that GPU copies land in. Each readback holds a buffer until its frame has completed and the
+    // data was taken; freed buffers go back to the ring and are reused oldest first, so steady readbacks (video capture,
+    // picking) stop allocating after a few frames.
+    class ENGINE_EXPORT VulkanReadbackRing
+    {
+    private:
+        VulkanContext& m_Context;
+
+        struct Page {
+            vk::Buffer    buffer     = nullptr;
+            VmaAllocation allocation = nullptr;
+            char*         mappedData = nullptr;
+            size_t        size       = 0;
+        };
+
+        struct Readback {
+            Scope<Page> page;
+            size_t      size      = 0;
+            uint64_t    frame     = 0; // Frame timeline value the copy completes with
+            bool        cancelled = false;
+        };
+
+        std::deque<Scope<Page>>                m_FreePages; // Oldest first
+        std::unordered_map<uint32_t, Readback> m_Readbacks;
+
+        Scope<Page> CreatePage(size_t size);
+        void DestroyPage(Page& page);
+        void Release(Scope<Page> page);
+
+    public:
+        VulkanReadbackRing(VulkanContext& context);
+        ~VulkanReadbackRing();
+
+        // Reserves size bytes for readback id, written by a copy in frame. Returns the buffer to copy into at offset 0
+        vk::Buffer Request(uint32_t id, size_t size, uint64_t frame);
+
+        // Copies the data out and forgets the readback once completedFrame has reached its frame
+        bool Poll(uint32_t id, uint64_t completedFrame, std::vector<char>& data);
+
+        // The buffer is only reused once the copy has completed
+        void Cancel(uint32_t id);
+
+        // Releases cancelled readbacks whose copies have completed
+        void Update(uint64_t completedFrame);
+    };
+} // namespace Engine::RHI::Vulkan
+
+
+#endif // RHI_VULKAN_VULKANREADBACKRING
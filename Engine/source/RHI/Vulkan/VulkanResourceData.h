@@ -2,12 +2,17 @@
 #define RHI_VULKAN_VULKANRESOURCEDATA
 
 #include "Engine/RHI/RHI.h"
+#include "Engine/RHI/RHIHash.h"
+#include "Engine/Core/Base.h"
 
 #include "RHI/Vulkan/VulkanConstants.h"
+#include "RHI/Vulkan/VulkanDynamicBufferAllocator.h"
 
 #include <vector>
 #include <array>
 #include <unordered_map>
+#include <atomic>
+#include <future>
 
 #include <vulkan/vulkan_raii.hpp>
 #include <vk_mem_alloc.h>
@@ -21,8 +26,8 @@ namespace Engine::RHI::Vulkan
         vk::Buffer    buffer     = nullptr;
         VmaAllocation allocation = nullptr;
 
-        // Dynamic
-        std::array<size_t, k_MaxFramesInFlight> dynamicOffsets = {};
+        // Dynamic. Where the last upload of each frame landed
+        std::array<VulkanDynamicAllocation, k_MaxFramesInFlight> dynamicAllocations = {};
     };
 
     struct VulkanTextureData {
@@ -31,8 +36,15 @@ namespace Engine::RHI::Vulkan
         VmaAllocation       allocation = nullptr;
         vk::Format          format;
         vk::raii::ImageView imageView  = nullptr;
-        vk::raii::Sampler   sampler    = nullptr;
+        vk::Sampler         sampler    = nullptr; // Owned by the device's sampler cache
         bool                ownsImage  = true;
+        uint32_t            heapId     = 0;       // Placed in a VulkanHeapData instead of its own allocation
+        vk::ImageLayout     layout     = vk::ImageLayout::eUndefined; // Layout after the last submission that used it. Only updated on submit
+    };
+
+    struct VulkanHeapData {
+        HeapDesc      desc;
+        VmaAllocation allocation = nullptr;
     };
 
     struct VulkanShaderData {
@@ -42,12 +54,50 @@ namespace Engine::RHI::Vulkan
             std::string entryPoint;
         };
         std::unordered_map<ShaderStage, StageInfo> stages;
+        uint64_t contentHash     = 0; // SPIR-V and entry points. Identifies the shader across runs
+        uint32_t pendingCompiles = 0; // Background compiles still reading the modules
+    };
+
+    // Binding signature of a pipeline layout. Pipelines with equal keys share one VulkanPipelineLayoutData.
+    struct VulkanPipelineLayoutKey {
+        std::vector<UniformBinding>    uniformBindings;
+        std::vector<PushConstantRange> pushConstantRanges;
+
+        bool operator==(const VulkanPipelineLayoutKey& other) const = default;
+    };
+
+    struct VulkanPipelineLayoutKeyHash {
+        size_t operator()(const VulkanPipelineLayoutKey& key) const noexcept {
+            size_t seed = HashUniformBindings(key.uniformBindings);
+            HashCombine(seed, HashPushConstantRanges(key.pushConstantRanges));
+            return seed;
+        }
+    };
+
+    struct VulkanPipelineLayoutData {
+        VulkanPipelineLayoutKey            key;
+        uint32_t                           refCount            = 0;
+        vk::raii::DescriptorSetLayout      descriptorSetLayout = nullptr;
+        vk::raii::PipelineLayout           pipelineLayout      = nullptr;
+        vk::raii::DescriptorUpdateTemplate updateTemplate      = nullptr; // Reads an array of VulkanDescriptorWrite indexed by binding
+        std::vector<uint32_t>              dynamicBindings;                // Uniform buffer bindings in ascending order, one dynamic offset each
+        std::vector<vk::PushConstantRange> pushConstantRanges;             // One per stage, as declared in the pipeline layout
     };
 
     struct VulkanPipelineData {
-        vk::raii::DescriptorSetLayout descriptorSetLayout = nullptr;
-        vk::raii::PipelineLayout      pipelineLayout      = nullptr;
-        vk::raii::Pipeline            pipeline            = nullptr;
+        PipelineDesc                 desc;
+        ComputePipelineDesc          computeDesc;                   // Set instead of desc for compute pipelines
+        vk::PipelineBindPoint        bindPoint           = vk::PipelineBindPoint::eGraphics;
+        uint32_t                     refCount            = 0;       // Identical CreatePipeline() calls share this pipeline
+        uint32_t                     layoutId            = 0;       // Shared VulkanPipelineLayoutData
+        vk::DescriptorSetLayout      descriptorSetLayout = nullptr; // Owned by layout
+        vk::PipelineLayout           pipelineLayout      = nullptr; // Owned by layout
+        vk::DescriptorUpdateTemplate updateTemplate      = nullptr; // Owned by layout
+        vk::raii::Pipeline           pipeline            = nullptr;
+
+        // Background compilation. pipeline is null until ready. Atomic as recording threads poll it
+        std::atomic<bool>               ready = true;
+        std::future<vk::raii::Pipeline> pendingPipeline;
     };
 
     struct VulkanSwapChainData {
@@ -57,6 +107,7 @@ namespace Engine::RHI::Vulkan
         PresentMode   presentMode  = PresentMode::VSync;
         PixelFormat   format       = PixelFormat::RGBA8;
         bool          needsRebuild = false;
+        bool          offscreen    = false; // No surface. Owns one image per frame in flight and is never presented
 
         // Vulkan
         vk::raii::SurfaceKHR   surface   = nullptr;
@@ -73,6 +124,17 @@ namespace Engine::RHI::Vulkan
         // Sync
         std::vector<vk::raii::Semaphore> presentCompleteSemaphores;
         std::vector<vk::raii::Semaphore> renderFinishedSemaphores;
+
+        // Rebuilds retire the old swapchain instead of waiting for the device. It is kept with its views and semaphores
+        // until no frame in flight can use them. Rebuilds are coalesced to one per frame.
+        struct Retired {
+            vk::raii::SwapchainKHR           swapchain = nullptr;
+            std::vector<VulkanTextureData>   textures;
+            std::vector<vk::raii::Semaphore> semaphores;
+            uint32_t                         framesRemaining = 0;
+        };
+        std::vector<Retired> retired;
+        uint64_t             rebuildFrame = 0; // Frame of the last rebuild
     };
 } // namespace Engine::RHI::Vulkan
 
@@ -0,0 +1,75 @@
+#include "RHI/Vulkan/VulkanResourceReleaser.h"
+#include "RHI/Vulkan/VulkanContext.h"
+
+namespace Engine::RHI::Vulkan
+{
+    VulkanResourceReleaser::VulkanResourceReleaser(VulkanContext& context, bool background)
+        : m_Context(context)
+    {
+        if(background)
+        {
+            m_Worker = std::thread(&VulkanResourceReleaser::WorkerLoop, this);
+        }
+    }
+
+    VulkanResourceReleaser::~VulkanResourceReleaser()
+    {
+        if(!m_Worker.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Condition.notify_one();
+        m_Worker.join();
+    }
+
+    void VulkanResourceReleaser::WorkerLoop()
+    {
+        while(true)
+        {
+            VulkanReleaseBatch batch;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this] { return m_Stopping || !m_Batches.empty(); });
+
+                // Drain the queue before stopping, the allocator is destroyed after us
+                if(m_Batches.empty())
+                    return;
+
+                batch = std::move(m_Batches.front());
+                m_Batches.pop_front();
+            }
+            ReleaseNow(batch);
+        }
+    }
+
+    void VulkanResourceReleaser::Release(VulkanReleaseBatch&& batch)
+    {
+        if(!m_Worker.joinable())
+        {
+            ReleaseNow(batch);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Batches.push_back(std::move(batch));
+        }
+        m_Condition.notify_one();
+    }
+
+    void VulkanResourceReleaser::ReleaseNow(const VulkanReleaseBatch& batch)
+    {
+        vk::Device device = *m_Context.GetDevice();
+        for(vk::Buffer buffer : batch.buffers)
+            device.destroyBuffer(buffer);
+        for(vk::Image image : batch.images)
+            device.destroyImage(image);
+
+        // One call for the whole batch instead of a vmaDestroy* per resource
+        if(!batch.allocations.empty())
+            vmaFreeMemoryPages(m_Context.GetAllocator(), batch.allocations.size(), batch.allocations.data());
+    }
+} // namespace Engine::RHI::Vulkan
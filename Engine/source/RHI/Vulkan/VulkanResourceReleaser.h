@@ -0,0 +1,54 @@
+#ifndef RHI_VULKAN_VULKANRESOURCERELEASER
+#define RHI_VULKAN_VULKANRESOURCERELEASER
+
+#include "engine_export.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+#include <vk_mem_alloc.h>
+
+namespace Engine::RHI::Vulkan
+{
+    // Forward
+    class VulkanContext;
+
+    // Objects whose frames have completed, released together. Buffers and images are destroyed before any memory is
+    // freed, so placed images are gone before their heap.
+    struct VulkanReleaseBatch {
+        std::vector<vk::Buffer>    buffers;
+        std::vector<vk::Image>     images;
+        std::vector<VmaAllocation> allocations;
+
+        bool IsEmpty() const { return buffers.empty() && images.empty() && allocations.empty(); }
+    };
+
+    // Releases batches either inline or on a worker thread, so unloading a level doesn't stall the frame on
+    // thousands of frees. Resource maps stay on the main thread, only raw handles reach the worker.
+    class ENGINE_EXPORT VulkanResourceReleaser
+    {
+    private:
+        VulkanContext& m_Context;
+
+        std::thread                    m_Worker; // Not started when releasing inline
+        std::deque<VulkanReleaseBatch> m_Batches;
+        std::mutex                     m_Mutex;
+        std::condition_variable        m_Condition;
+        bool                           m_Stopping = false;
+
+        void WorkerLoop();
+        void ReleaseNow(const VulkanReleaseBatch& batch);
+
+    public:
+        VulkanResourceReleaser(VulkanContext& context, bool background);
+        ~VulkanResourceReleaser(); // Releases all queued batches
+
+        void Release(VulkanReleaseBatch&& batch);
+    };
+} // namespace Engine::RHI::Vulkan
+
+#endif // RHI_VULKAN_VULKANRESOURCERELEASER
@@ -23,10 +23,12 @@ namespace Engine
         {{-0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}}
     };
 
-    static const std::vector<uint16_t> indices = {
-        0, 1, 2, 2, 3, 0,
-    };
+    static constexpr uint32_t k_RenderTargetSizeStep = 256;
 
+    static uint32_t GetSteppedSize(uint32_t size)
+    {
+        return (size + k_RenderTargetSizeStep - 1) / k_RenderTargetSizeStep * k_RenderTargetSizeStep;
+    }
 
     Renderer::Renderer()
     {
@@ -34,14 +36,9 @@ namespace Engine
         auto fs = Application::Get()->GetServiceLocator()->Get<FileSystem>();
         auto win = Application::Get()->GetServiceLocator()->Get<IWindow>();
 
-        TextureDesc depthdesc{
-            .width = win->GetWidth(),
-            .height = win->GetHeight(),
-            .format = PixelFormat::Depth32,
-            .usage = TextureUsage::DepthStencil
-        };
-
-        m_DepthBuffer = gd->CreateTexture(depthdesc);
+        m_TargetWidth = win->GetWidth();
+        m_TargetHeight = win->GetHeight();
+        ResizeRenderTargets();
 
         ShaderDesc shdesc{
             .modules = {
@@ -88,17 +85,8 @@ namespace Engine
 
         m_SpriteVertices = gd->CreateBuffer(vbdesc);
 
-        BufferDesc ibdesc{
-            .size = indices.size() * sizeof(uint16_t),
-            .type = BufferType::Index,
-            .usage = BufferUsage::Static
-        };
-
-        m_SpriteIndices = gd->CreateBuffer(ibdesc);
-
         ICommandBuffer* init = gd->BeginImmediate();
         init->UploadBuffer(m_SpriteVertices, (void*)vertices.data(), vertices.size() * sizeof(SpriteVertex), 0);
-        init->UploadBuffer(m_SpriteIndices, (void*)indices.data(), indices.size() * sizeof(uint16_t), 0);
         gd->EndImmediate(init);
     }
 
@@ -110,29 +98,54 @@ namespace Engine
     void Renderer::OnEvent(StringName type, const Event& event) {
         if(type == Hash32("WindowResized"))
         {
-            auto gd = Application::Get()->GetServiceLocator()->Get<IGraphicsDevice>();
             const WindowResizedEvent& wr = static_cast<const WindowResizedEvent&>(event);
-            if(m_DepthBuffer.IsValid())
-            {
-                gd->DestroyTexture(m_DepthBuffer);
-            }
-            TextureDesc depthdesc{
-                .width = wr.GetSizeX(),
-                .height = wr.GetSizeY(),
-                .format = PixelFormat::Depth32,
-                .usage = TextureUsage::DepthStencil
-            };
-            m_DepthBuffer = gd->CreateTexture(depthdesc);
+            m_TargetWidth = wr.GetSizeX();
+            m_TargetHeight = wr.GetSizeY();
         }
     }
 
+    void Renderer::ResizeRenderTargets()
+    {
+        // Attachments may be larger than the swapchain, so the depth buffer only follows the window in steps.
+        // Minimized windows keep their targets
+        if(m_TargetWidth == 0 || m_TargetHeight == 0)
+            return;
+
+        uint32_t width = GetSteppedSize(m_TargetWidth);
+        uint32_t height = GetSteppedSize(m_TargetHeight);
+        if(width == m_DepthWidth && height == m_DepthHeight)
+            return;
+
+        auto gd = Application::Get()->GetServiceLocator()->Get<IGraphicsDevice>();
+        if(m_DepthBuffer.IsValid())
+        {
+            gd->DestroyTexture(m_DepthBuffer);
+        }
+
+        TextureDesc depthdesc{
+            .width = width,
+            .height = height,
+            .format = PixelFormat::Depth32,
+            .usage = TextureUsage::DepthStencil
+        };
+        m_DepthBuffer = gd->CreateTexture(depthdesc);
+        m_DepthWidth = width;
+        m_DepthHeight = height;
+    }
+
     void Renderer::Begin(RHI::SwapChainHandle sc)
     {
+        ResizeRenderTargets();
+
         auto gd = Application::Get()->GetServiceLocator()->Get<IGraphicsDevice>();
+
+        // Sprites are quads, so they share the device's quad indices. Fetched before the pass in case it grows
+        BufferHandle indices = gd->GetQuadIndexBuffer(1);
+
         m_CurrentCommandBuffer = gd->BeginPass(sc, {0.0f, 0.0f, 0.0f, 1.0f}, m_DepthBuffer);
         m_CurrentCommandBuffer->BindPipeline(m_SpritePipeline);
         m_CurrentCommandBuffer->BindVertexBuffer(m_SpriteVertices);
-        m_CurrentCommandBuffer->BindIndexBuffer(m_SpriteIndices);
+        m_CurrentCommandBuffer->BindIndexBuffer(indices);
     }
 
     void Renderer::DrawSprite(RHI::TextureHandle tex, Vec2 pos, Vec2 size, float rot)